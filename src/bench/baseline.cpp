@@ -0,0 +1,227 @@
+/*
+ * maetning-bench, baseline of the saturation, see baseline.h.
+ *
+ * Copied verbatim from src/maetning/Maetning.cpp and sat0.h to sat5.h of the
+ * baseline commit e4814e6. Do not change anything below but to make it
+ * compile outside of the plugin.
+ */
+
+#include <cmath>
+
+#include "baseline.h"
+
+#define PARAM_SATURATION 0
+#define PARAM_TYPE 1
+#define PARAM_MASTERVOLUME 2
+#define PARAM_MASTERMIX 3
+
+#include "baseline/sat0.h"
+#include "baseline/sat1.h"
+#include "baseline/sat2.h"
+#include "baseline/sat3.h"
+#include "baseline/sat4.h"
+#include "baseline/sat5.h"
+
+// -----------------------------------------------------------------------------------------------------------
+
+SatBaseline::SatBaseline()
+{
+    setParameterValue(PARAM_SATURATION, 0.0f);
+    setParameterValue(PARAM_TYPE, 0.0f);
+    setParameterValue(PARAM_MASTERVOLUME, 0.0f);
+    setParameterValue(PARAM_MASTERMIX, 100.0f);
+}
+
+void SatBaseline::setParameterValue(uint32_t index, float value)
+{
+    switch (index) {
+    case PARAM_SATURATION:
+        param_saturation = value;
+        param_saturation_int = (int)value;
+        break;
+
+    case PARAM_TYPE:
+        param_type = value;
+        param_type_int = (int)value;
+        break;
+
+    case PARAM_MASTERVOLUME:
+        param_mastervolume = value;
+        if (value < -50) {
+            param_mastervolume_lin = 0.0;
+        }
+        else {
+            param_mastervolume_lin = pow(10.0, value/20.0);
+        }
+        break;
+
+    case PARAM_MASTERMIX:
+        param_mastermix = value;
+        param_mastermix_wet = value/100.0;
+        param_mastermix_dry = 1.0 - param_mastermix_wet;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void SatBaseline::run(const float** inputs, float** outputs, uint32_t frames)
+{
+    float x = 0.0;
+    float y = 0.0;
+    float s = 0.0;
+
+    float p0 = 0.0;
+    float p1 = 0.0;
+    float p2 = 0.0;
+    float p3 = 0.0;
+    float p4 = 0.0;
+    float p5 = 0.0;
+    float p6 = 0.0;
+    float p7 = 0.0;
+    float p8 = 0.0;
+    float p9 = 0.0;
+    float bp = 0.0;
+    float bn = 0.0;
+    float abs_x = 0.0;
+
+    switch (param_type_int) {
+    case 0:
+        p0 = sat0_coeffs[param_saturation_int][0];
+        p1 = sat0_coeffs[param_saturation_int][1];
+        p2 = sat0_coeffs[param_saturation_int][2];
+        p3 = sat0_coeffs[param_saturation_int][3];
+        p4 = sat0_coeffs[param_saturation_int][4];
+        bp = p2 - p1*p2/p0;
+        bn = p4 - p3*p4/p0;
+        break;
+
+    case 1:
+        p0 = sat1_coeffs[param_saturation_int][0];
+        p1 = sat1_coeffs[param_saturation_int][1];
+        p2 = sat1_coeffs[param_saturation_int][2];
+        break;
+
+    case 2:
+        p0 = sat2_coeffs[param_saturation_int][0];
+        p1 = sat2_coeffs[param_saturation_int][1];
+        p2 = sat2_coeffs[param_saturation_int][2];
+        p3 = sat2_coeffs[param_saturation_int][3];
+        break;
+
+    case 3:
+        p0 = sat3_coeffs[param_saturation_int][0];
+        p1 = sat3_coeffs[param_saturation_int][1];
+        p2 = sat3_coeffs[param_saturation_int][2];
+        break;
+
+    case 4:
+        p0 = sat4_coeffs[param_saturation_int][0];
+        p1 = sat4_coeffs[param_saturation_int][1];
+        p2 = sat4_coeffs[param_saturation_int][2];
+        p3 = sat4_coeffs[param_saturation_int][3];
+        p4 = sat4_coeffs[param_saturation_int][4];
+        p5 = sat4_coeffs[param_saturation_int][5];
+        p6 = sat4_coeffs[param_saturation_int][6];
+        p7 = sat4_coeffs[param_saturation_int][7];
+        p8 = sat4_coeffs[param_saturation_int][8];
+        p9 = sat4_coeffs[param_saturation_int][9];
+        break;
+
+    case 5:
+        p0 = sat5_coeffs[param_saturation_int][0];
+        p1 = sat5_coeffs[param_saturation_int][1];
+        p2 = sat5_coeffs[param_saturation_int][2];
+        p3 = sat5_coeffs[param_saturation_int][3];
+        p4 = sat5_coeffs[param_saturation_int][4];
+        p5 = sat5_coeffs[param_saturation_int][5];
+        p6 = sat5_coeffs[param_saturation_int][6];
+        p7 = sat5_coeffs[param_saturation_int][7];
+        p8 = sat5_coeffs[param_saturation_int][8];
+        p9 = sat5_coeffs[param_saturation_int][9];
+        break;
+
+    };
+
+    for (uint32_t ch = 0; ch < 2; ch++) {
+        for (uint32_t n = 0; n < frames; n++) {
+            x = inputs[ch][n];
+            y = 0;
+
+            // Apply saturation
+            switch (param_type_int) {
+            case 0:
+                y = p0*x;
+                if (y > p2) {
+                    y = p1*x + bp;
+                }
+                else if (y < p4) {
+                    y = p3*x + bn;
+                }
+                break;
+
+            case 1:
+                y = x / (p1 + p0*std::abs(x)) + p2*std::abs(x);
+                break;
+
+            case 2:
+                s = p0 * x;
+                if (s < -0.6) {
+                    y = p1*s*s + p2*s + p3;
+                }
+                else if (s > 0.6) {
+                    y = (-p1)*s*s + p2*s + (-p3);
+                }
+                else {
+                    y = s;
+                }
+                break;
+
+            case 3:
+                s = p0*x;
+                if (s < -0.75) {
+                    y = p1*s + p2;
+                }
+                else if (s > 0.75) {
+                    y = p1*s - p2;
+                }
+                else {
+                    y = s;
+                }
+                break;
+
+            case 4:
+            case 5:
+                abs_x = std::abs(x);
+
+                if (p9 == 0) {
+                    // Low-gain algorithm
+                    y = x / (p0 + p1*abs_x + p2*abs_x*abs_x) + p3*abs_x;
+                }
+                else {
+                    // High-gain algorithm
+                    if (x < 0) {
+                        y = x / (p0 + p1*abs_x) + p2*abs_x;
+                    }
+                    else {
+                        y = p3*(p4*x*x + p5*x)/(x*x + p6*x + p7) + p8*x;
+                    }
+                }
+                break;
+
+            default:
+                y = x;
+            }
+
+            // Mix wet and dry signal
+            y = param_mastermix_wet*y + param_mastermix_dry*x;
+
+            // Apply master volume
+            y *= param_mastervolume_lin;
+
+            // Write to output
+            y = outputs[ch][n] = y;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * maetning-bench, baseline of the saturation
+ *
+ * The saturation of the plugin as of the baseline commit e4814e6, before the
+ * core was split out of it: its parameter handling, its run() and its
+ * coefficient tables, copied verbatim (see baseline.cpp). No change to the
+ * core reaches it, so maetning-bench --verify checks settled blocks against
+ * it rather than against the refactored scalar kernels alone.
+ *
+ * It processes two channels, with whole saturation steps, and has no
+ * smoothing, oversampling or ADAA.
+ */
+
+#ifndef BASELINE_H_INCLUDED
+#define BASELINE_H_INCLUDED
+
+#include <cstdint>
+
+class SatBaseline
+{
+public:
+    /**
+       Saturation 0, type 0, master volume 0 dB and master mix 100 %.
+     */
+    SatBaseline();
+
+    /**
+       Set parameter @a index, SAT_PARAM_SATURATION, SAT_PARAM_TYPE, SAT_PARAM_MASTERVOLUME or SAT_PARAM_MASTERMIX.
+     */
+    void setParameterValue(uint32_t index, float value);
+
+    /**
+       Process @a frames frames of two channels.
+     */
+    void run(const float** inputs, float** outputs, uint32_t frames);
+
+private:
+    float param_saturation;
+    int param_saturation_int;
+    float param_type;
+    int param_type_int;
+    float param_mastervolume;
+    float param_mastervolume_lin;
+    float param_mastermix;
+    float param_mastermix_wet;
+    float param_mastermix_dry;
+};
+
+#endif // BASELINE_H_INCLUDED
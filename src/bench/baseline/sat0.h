@@ -0,0 +1,106 @@
+#define SAT0_COEFFS_LENGTH 101
+const float sat0_coeffs[][5] = {
+    { 1.00381, 1.00378, -0.654707, 1.00384, 0.67912 },
+    { 1.0075, 1.00712, 0.275586, 1.00651, -0.404481 },
+    { 1.01765, 1.01605, 0.36706, 1.01238, -0.351478 },
+    { 1.03332, 1.026, 0.477473, 1.02124, -0.327725 },
+    { 1.05433, 1.04268, 0.402838, 1.03395, -0.297979 },
+    { 1.07706, 1.05292, 0.503067, 1.03826, -0.369715 },
+    { 1.10503, 1.07399, 0.447138, 1.04923, -0.350576 },
+    { 1.12482, 0.727887, 0.796741, 1.04069, -0.44711 },
+    { 1.15357, 0.669582, 0.696185, 0.957049, -0.537065 },
+    { 1.18093, 0.642728, 0.626998, 0.915957, -0.52428 },
+    { 1.19968, 0.636923, 0.593779, 0.911583, -0.505017 },
+    { 1.24761, 0.645787, 0.565187, 0.93056, -0.487473 },
+    { 1.29571, 0.656853, 0.538552, 0.953151, -0.468188 },
+    { 1.34056, 0.644084, 0.521759, 0.934766, -0.478445 },
+    { 1.37121, 0.622965, 0.522392, 0.881708, -0.513248 },
+    { 1.39133, 0.589599, 0.528266, 0.787856, -0.562613 },
+    { 1.39154, 0.54165, 0.541999, 0.604816, -0.641094 },
+    { 1.38333, 0.482539, 0.557808, 0.32839, -0.71491 },
+    { 1.39098, 0.430071, 0.563512, 0.162362, -0.732655 },
+    { 1.403, 0.384702, 0.563775, 0.0746477, -0.72971 },
+    { 1.41468, 0.344978, 0.561025, 0.0224681, -0.719524 },
+    { 1.461, 0.301803, 0.562863, -0.0250904, -0.711802 },
+    { 1.50479, 0.267258, 0.561637, -0.0538989, -0.700929 },
+    { 1.5461, 0.242522, 0.557076, -0.074321, -0.688785 },
+    { 1.58517, 0.22397, 0.550467, -0.086977, -0.675221 },
+    { 1.62058, 0.208113, 0.543133, -0.0967764, -0.661221 },
+    { 1.65383, 0.198277, 0.533666, -0.10469, -0.646996 },
+    { 1.68228, 0.187988, 0.524674, -0.108174, -0.632183 },
+    { 1.71132, 0.187628, 0.512496, -0.098194, -0.615125 },
+    { 1.73527, 0.183635, 0.501515, -0.0911043, -0.598582 },
+    { 1.75602, 0.179876, 0.490211, -0.08624, -0.582516 },
+    { 1.8199, 0.177418, 0.482075, -0.0833003, -0.5696 },
+    { 1.87823, 0.173108, 0.474509, -0.0815986, -0.556883 },
+    { 1.93329, 0.169942, 0.466257, -0.0809817, -0.544401 },
+    { 1.98628, 0.167743, 0.457407, -0.0801161, -0.531799 },
+    { 2.03092, 0.163803, 0.44928, -0.0809317, -0.519722 },
+    { 2.075, 0.161999, 0.440048, -0.0813476, -0.507533 },
+    { 2.11092, 0.158419, 0.431576, -0.0822694, -0.495514 },
+    { 2.1448, 0.156625, 0.422181, -0.0835693, -0.483688 },
+    { 2.17359, 0.154183, 0.412998, -0.084448, -0.471735 },
+    { 2.19952, 0.152155, 0.403522, -0.0850189, -0.459721 },
+    { 2.27696, 0.151481, 0.396932, -0.0877858, -0.450174 },
+    { 2.35316, 0.152579, 0.38937, -0.0873597, -0.440099 },
+    { 2.42057, 0.151954, 0.382464, -0.0820564, -0.429014 },
+    { 2.48906, 0.15143, 0.375017, -0.078388, -0.41833 },
+    { 2.54474, 0.148541, 0.368428, -0.0764845, -0.408111 },
+    { 2.59924, 0.146293, 0.361225, -0.0757658, -0.398284 },
+    { 2.64617, 0.143074, 0.35429, -0.0755412, -0.388563 },
+    { 2.68709, 0.139853, 0.347176, -0.0760665, -0.379113 },
+    { 2.71901, 0.135868, 0.340311, -0.0767119, -0.369682 },
+    { 2.75574, 0.132806, 0.332792, -0.0771169, -0.360183 },
+    { 2.8489, 0.129463, 0.328177, -0.0802547, -0.352844 },
+    { 2.93536, 0.126542, 0.323198, -0.0837514, -0.34567 },
+    { 3.02149, 0.12539, 0.317537, -0.0868836, -0.338364 },
+    { 3.10119, 0.126079, 0.311237, -0.0901666, -0.331179 },
+    { 3.17777, 0.127995, 0.304489, -0.0932702, -0.323986 },
+    { 3.24137, 0.130025, 0.297795, -0.0956352, -0.316617 },
+    { 3.30745, 0.133374, 0.290444, -0.0909367, -0.307712 },
+    { 3.36394, 0.13587, 0.283409, -0.0840498, -0.298331 },
+    { 3.41207, 0.136779, 0.27668, -0.0779624, -0.289273 },
+    { 3.4608, 0.13641, 0.270154, -0.0723086, -0.280367 },
+    { 3.58033, 0.136073, 0.266063, -0.0659578, -0.27244 },
+    { 3.69083, 0.134213, 0.262171, -0.0605561, -0.264913 },
+    { 3.80261, 0.131316, 0.258319, -0.0555884, -0.25756 },
+    { 3.88573, 0.127245, 0.254774, -0.0513189, -0.250507 },
+    { 3.98373, 0.123307, 0.250837, -0.0474712, -0.243642 },
+    { 4.05098, 0.118617, 0.247103, -0.0440867, -0.236981 },
+    { 4.11601, 0.113821, 0.243211, -0.0409277, -0.230412 },
+    { 4.17041, 0.10903, 0.239176, -0.038139, -0.224014 },
+    { 4.22243, 0.104294, 0.234964, -0.0355061, -0.21768 },
+    { 4.26505, 0.0996359, 0.230624, -0.0331812, -0.211503 },
+    { 4.42872, 0.0946778, 0.228059, -0.0304437, -0.206159 },
+    { 4.55064, 0.0894662, 0.225527, -0.0280992, -0.200996 },
+    { 4.66511, 0.0845194, 0.222743, -0.0259758, -0.195936 },
+    { 4.77411, 0.079864, 0.219716, -0.0240614, -0.190981 },
+    { 4.8751, 0.0754758, 0.216462, -0.0223604, -0.18612 },
+    { 4.96933, 0.071361, 0.213019, -0.0208015, -0.181334 },
+    { 5.05764, 0.0675102, 0.209372, -0.0193857, -0.176608 },
+    { 5.14036, 0.0638865, 0.205576, -0.0181, -0.171953 },
+    { 5.15273, 0.0599952, 0.20192, -0.0169154, -0.167341 },
+    { 5.22161, 0.0568283, 0.197829, -0.0158467, -0.162802 },
+    { 5.3915, 0.0530497, 0.195308, -0.0145968, -0.158976 },
+    { 5.55523, 0.0496199, 0.192581, -0.0134883, -0.155233 },
+    { 5.71443, 0.0465066, 0.189642, -0.012504, -0.151542 },
+    { 5.87234, 0.0436942, 0.186527, -0.0116255, -0.147911 },
+    { 5.91303, 0.0405791, 0.183582, -0.0107921, -0.144295 },
+    { 6.05634, 0.0382308, 0.180194, -0.0100952, -0.140763 },
+    { 6.06883, 0.035546, 0.176983, -0.00939717, -0.137213 },
+    { 6.20501, 0.0335957, 0.173363, -0.00882301, -0.133743 },
+    { 6.3539, 0.0318022, 0.169632, -0.00823138, -0.130253 },
+    { 6.32283, 0.0296564, 0.166116, -0.00774931, -0.126821 },
+    { 6.59085, 0.0276244, 0.1635, -0.0070876, -0.123949 },
+    { 6.62954, 0.0253427, 0.161036, -0.006623, -0.121185 },
+    { 6.90309, 0.0237733, 0.158146, -0.00606611, -0.118364 },
+    { 7.14856, 0.0224138, 0.155154, -0.00569023, -0.115647 },
+    { 7.18077, 0.020723, 0.152335, -0.00524478, -0.112883 },
+    { 7.43297, 0.0196757, 0.149159, -0.00498022, -0.11022 },
+    { 7.43871, 0.0182473, 0.146198, -0.00461109, -0.107499 },
+    { 7.4244, 0.0169095, 0.143194, -0.00427804, -0.104803 },
+    { 7.67526, 0.016143, 0.139855, -0.00408311, -0.102171 },
+    { 7.64151, 0.0149956, 0.136744, -0.00378949, -0.099497 }
+};
+
+
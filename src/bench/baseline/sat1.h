@@ -0,0 +1,104 @@
+#define SAT1_COEFFS_LENGTH 101
+const float sat1_coeffs[][3] = {
+    { -2.15876e-05,0.996228,-5.16094e-05},
+    { 0.000661507,0.992408,5.95507e-05},
+    { 0.00353305,0.981808,0.000776531},
+    { 0.00947247,0.965313,0.0018432},
+    { 0.015526,0.945412,0.00313824},
+    { 0.0289555,0.92006,0.00522701},
+    { 0.0388389,0.895624,0.00777522},
+    { 0.0762688,0.857848,0.00824963},
+    { 0.175404,0.796651,0.00148937},
+    { 0.259343,0.750674,-0.00768439},
+    { 0.298859,0.728608,-0.0136663},
+    { 0.335797,0.69219,-0.0223039},
+    { 0.364179,0.662639,-0.0313641},
+    { 0.407841,0.629193,-0.0393905},
+    { 0.448804,0.599487,-0.0422592},
+    { 0.495968,0.570326,-0.0438408},
+    { 0.546735,0.542745,-0.044469},
+    { 0.599007,0.517425,-0.0443212},
+    { 0.651755,0.494568,-0.0435763},
+    { 0.704594,0.474126,-0.0423441},
+    { 0.757419,0.455954,-0.0407371},
+    { 0.823771,0.42236,-0.0384046},
+    { 0.886743,0.393757,-0.0354852},
+    { 0.946942,0.369302,-0.0321418},
+    { 1.00502,0.348295,-0.0285165},
+    { 1.06157,0.330163,-0.0246923},
+    { 1.11708,0.314459,-0.0207582},
+    { 1.17106,0.301066,-0.0169728},
+    { 1.22105,0.290444,-0.0136314},
+    { 1.27172,0.281115,-0.010435},
+    { 1.32337,0.272915,-0.00738331},
+    { 1.37856,0.256471,-0.00287445},
+    { 1.43278,0.242378,0.00144793},
+    { 1.48659,0.230211,0.00560277},
+    { 1.54029,0.219678,0.00957038},
+    { 1.59427,0.210522,0.0133536},
+    { 1.64887,0.202545,0.0169614},
+    { 1.70438,0.195587,0.020385},
+    { 1.76112,0.189508,0.0236318},
+    { 1.81936,0.184208,0.0266939},
+    { 1.87936,0.1796,0.0295734},
+    { 1.93752,0.169911,0.0344775},
+    { 1.99396,0.161909,0.0386545},
+    { 2.04822,0.155471,0.0417621},
+    { 2.10467,0.149715,0.0445992},
+    { 2.16354,0.14455,0.0471969},
+    { 2.2248,0.139937,0.04956},
+    { 2.28868,0.135811,0.0517112},
+    { 2.35535,0.132128,0.0536583},
+    { 2.42498,0.128857,0.0554134},
+    { 2.49782,0.125949,0.0569752},
+    { 2.56584,0.119473,0.0603563},
+    { 2.63583,0.113788,0.0635039},
+    { 2.70682,0.108917,0.0667198},
+    { 2.77864,0.104798,0.0700342},
+    { 2.85173,0.101299,0.0733815},
+    { 2.92614,0.0983712,0.0765937},
+    { 2.99531,0.0966841,0.0783175},
+    { 3.06423,0.0956112,0.0793638},
+    { 3.13746,0.0946933,0.0799485},
+    { 3.21531,0.0939024,0.0801546},
+    { 3.27854,0.0910078,0.0815011},
+    { 3.3457,0.0883947,0.082281},
+    { 3.41686,0.0860444,0.082591},
+    { 3.49184,0.0839444,0.0825235},
+    { 3.5708,0.0820746,0.0821778},
+    { 3.65385,0.0804228,0.0815637},
+    { 3.74144,0.0789584,0.0807346},
+    { 3.83361,0.0776649,0.0797368},
+    { 3.93077,0.0765539,0.0785841},
+    { 4.03297,0.0755815,0.0773077},
+    { 4.11887,0.0728083,0.0766618},
+    { 4.20861,0.0703626,0.0758355},
+    { 4.30239,0.0682108,0.0748685},
+    { 4.40036,0.0663214,0.0737813},
+    { 4.50317,0.0646412,0.0725948},
+    { 4.61062,0.0631687,0.0713349},
+    { 4.72355,0.0618768,0.0700018},
+    { 4.84179,0.0607464,0.068616},
+    { 4.96601,0.0597682,0.0671833},
+    { 5.0964,0.0589279,0.0657085},
+    { 5.20686,0.0566544,0.064653},
+    { 5.32148,0.054669,0.0635447},
+    { 5.44136,0.0529243,0.0623869},
+    { 5.56628,0.0513822,0.0611915},
+    { 5.69677,0.0500305,0.0599703},
+    { 5.83293,0.0488501,0.0587222},
+    { 5.97601,0.0477987,0.0574502},
+    { 6.12542,0.0468996,0.0561664},
+    { 6.28281,0.0461167,0.0548606},
+    { 6.44789,0.0454608,0.0535463},
+    { 6.58716,0.0436702,0.0525412},
+    { 6.73175,0.042119,0.0515158},
+    { 6.88291,0.0407871,0.0504744},
+    { 7.04022,0.0396166,0.0494243},
+    { 7.20503,0.0385962,0.0483581},
+    { 7.3772,0.0376948,0.0472882},
+    { 7.55741,0.0369114,0.0462105},
+    { 7.74596,0.0361726,0.0451304},
+    { 7.94444,0.0356081,0.0440443},
+    { 8.15221,0.0351086,0.0429552}
+};
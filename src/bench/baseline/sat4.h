@@ -0,0 +1,105 @@
+#define SAT4_COEFFS_LENGTH 101
+
+const float sat4_coeffs[][10] = {
+    { 1.01098,0.00124656,0.00152633,-0.0125889,0,0,0,0,0,0},
+    { 1.01092,0.00126871,0.0017335,-0.0131634,0,0,0,0,0,0},
+    { 1.01087,0.00130091,0.00194251,-0.0137629,0,0,0,0,0,0},
+    { 1.01081,0.00134579,0.00215439,-0.0143882,0,0,0,0,0,0},
+    { 1.01074,0.00142041,0.00237165,-0.0150415,0,0,0,0,0,0},
+    { 1.01068,0.00146739,0.00263089,-0.0157222,0,0,0,0,0,0},
+    { 1.01062,0.0015213,0.00291865,-0.0164325,0,0,0,0,0,0},
+    { 1.01056,0.00156764,0.00324146,-0.0171739,0,0,0,0,0,0},
+    { 1.01049,0.00166833,0.00355201,-0.0179461,0,0,0,0,0,0},
+    { 1.01043,0.00173419,0.00392355,-0.0187516,0,0,0,0,0,0},
+    { 1.01036,0.00181255,0.0043284,-0.0195921,0,0,0,0,0,0},
+    { 1.01016,0.00189193,0.00476622,-0.0204714,0,0,0,0,0,0},
+    { 1.00995,0.00197405,0.00525829,-0.0213862,0,0,0,0,0,0},
+    { 1.00976,0.00202088,0.00581849,-0.0223401,0,0,0,0,0,0},
+    { 1.00954,0.00216344,0.00636275,-0.0233333,0,0,0,0,0,0},
+    { 1.00933,0.00228818,0.0069744,-0.0243664,0,0,0,0,0,0},
+    { 1.00914,0.00235411,0.00770095,-0.0254435,0,0,0,0,0,0},
+    { 1.00892,0.00251248,0.00842212,-0.0265625,0,0,0,0,0,0},
+    { 1.0087,0.0026857,0.0092068,-0.0277292,0,0,0,0,0,0},
+    { 1.00846,0.00295414,0.00997965,-0.028943,0,0,0,0,0,0},
+    { 1.00823,0.00322508,0.010821,-0.0302064,0,0,0,0,0,0},
+    { 1.00797,0.00362588,0.0116312,-0.0315246,0,0,0,0,0,0},
+    { 1.0077,0.00406648,0.0124925,-0.032902,0,0,0,0,0,0},
+    { 1.00744,0.00451873,0.0134544,-0.0343433,0,0,0,0,0,0},
+    { 1.0072,0.00487438,0.014632,-0.035858,0,0,0,0,0,0},
+    { 1.00698,0.00517203,0.016016,-0.0374513,0,0,0,0,0,0},
+    { 1.00628,0.005217,0.017804,-0.0391554,0,0,0,0,0,0},
+    { 1.00563,0.00504522,0.0200044,-0.0409606,0,0,0,0,0,0},
+    { 1.00501,0.00465729,0.02267,-0.0428784,0,0,0,0,0,0},
+    { 1.00448,0.0038411,0.0260147,-0.0449231,0,0,0,0,0,0},
+    { 1.004,0.0027135,0.0300023,-0.0471084,0,0,0,0,0,0},
+    { 1.00363,0.00101813,0.0349251,-0.0494457,0,0,0,0,0,0},
+    { 1.00331,-0.00105776,0.0406693,-0.0519558,0,0,0,0,0,0},
+    { 1.00306,-0.00359644,0.0473639,-0.0546563,0,0,0,0,0,0},
+    { 1.00283,-0.00630863,0.0547859,-0.0575576,0,0,0,0,0,0},
+    { 1.00278,-0.0101048,0.0639514,-0.0606371,0,0,0,0,0,0},
+    { 1.00431,-0.0219326,0.0825955,-0.0637241,0,0,0,0,0,0},
+    { 1.00924,-0.051382,0.121758,-0.0665424,0,0,0,0,0,0},
+    { 1.01786,-0.100751,0.185104,-0.0689023,0,0,0,0,0,0},
+    { 1.02909,-0.165483,0.268937,-0.0707357,0,0,0,0,0,0},
+    { 1.04113,-0.23732,0.365378,-0.07204,0,0,0,0,0,0},
+    { 1.04458,-0.305692,0.462714,-0.0733922,0,0,0,0,0,0},
+    { 1.04574,-0.365471,0.556343,-0.0743451,0,0,0,0,0,0},
+    { 1.04416,-0.413883,0.643148,-0.074996,0,0,0,0,0,0},
+    { 1.03984,-0.45043,0.722447,-0.0754713,0,0,0,0,0,0},
+    { 1.03331,-0.477127,0.796237,-0.075917,0,0,0,0,0,0},
+    { 1.02524,-0.496708,0.867382,-0.0764847,0,0,0,0,0,0},
+    { 1.01596,-0.510539,0.937464,-0.0772892,0,0,0,0,0,0},
+    { 1.00554,-0.518533,1.00643,-0.0783954,0,0,0,0,0,0},
+    { 0.993907,-0.519982,1.07353,-0.0798257,0,0,0,0,0,0},
+    { 0.980993,-0.51399,1.13766,-0.0815724,0,0,0,0,0,0},
+    { 0.966919,-0.500767,1.19907,-0.0836128,0,0,0,0,0,0},
+    { 0.951888,-0.480776,1.25808,-0.0859158,0,0,0,0,0,0},
+    { 0.936146,-0.454921,1.3158,-0.0884496,0,0,0,0,0,0},
+    { 0.919921,-0.423939,1.373,-0.0911751,0,0,0,0,0,0},
+    { 0.903369,-0.388414,1.43049,-0.0940519,0,0,0,0,0,0},
+    { 0.867876,-0.340871,1.45677,-0.0991072,0,0,0,0,0,0},
+    { 0.832992,-0.289317,1.48004,-0.104357,0,0,0,0,0,0},
+    { 0.798625,-0.232726,1.49853,-0.10971,0,0,0,0,0,0},
+    { 0.764647,-0.170539,1.51135,-0.115104,0,0,0,0,0,0},
+    { 0.124171,0.019676,6.40563,0.359571,-1.51925,0.756978,-0.895816,0.580228,0.829887,1},
+    { 0.186484,0.0520818,3.64573,0.364083,-1.46756,0.782462,-0.790475,0.505518,0.767797,1},
+    { 0.233053,0.0950937,2.50229,0.349688,-1.45375,0.823163,-0.694745,0.437642,0.705607,1},
+    { 0.267407,0.1459,1.87577,0.36008,-1.31128,0.785618,-0.609227,0.377236,0.64528,1},
+    { 0.292111,0.202224,1.48098,0.325476,-1.31931,0.835869,-0.533995,0.324403,0.588172,1},
+    { 0.309328,0.262768,1.20816,0.305955,-1.25266,0.840987,-0.468316,0.278633,0.535017,1},
+    { 0.320539,0.326064,1.00917,0.27764,-1.2106,0.865258,-0.411399,0.239278,0.486121,1},
+    { 0.327027,0.39127,0.857485,0.243284,-1.19197,0.91318,-0.36231,0.205669,0.441713,1},
+    { 0.329775,0.457562,0.738308,0.242538,-1.01396,0.841007,-0.319987,0.177006,0.401469,1},
+    { 0.329587,0.524621,0.64198,0.204875,-0.998984,0.909259,-0.283406,0.152558,0.365147,1},
+    { 0.327101,0.591766,0.562862,0.193693,-0.86044,0.875189,-0.251847,0.131771,0.332484,1},
+    { 0.31915,0.651247,0.502536,0.167942,-0.794145,0.92623,-0.224467,0.113991,0.306543,1},
+    { 0.310014,0.708744,0.451242,0.146548,-0.700959,0.972419,-0.200703,0.0988305,0.283071,1},
+    { 0.300061,0.764174,0.407074,0.13214,-0.563634,0.986402,-0.179996,0.0858242,0.261694,1},
+    { 0.289599,0.817501,0.368598,0.120442,-0.403296,0.989068,-0.161863,0.0746671,0.242178,1},
+    { 0.278801,0.868908,0.334663,0.10896,-0.226692,0.997911,-0.145911,0.0650186,0.224233,1},
+    { 0.267899,0.918149,0.304648,0.0984172,-0.0290692,1.00783,-0.131911,0.0567014,0.207806,1},
+    { 0.256968,0.965455,0.277838,0.0899358,0.18901,1.00568,-0.119603,0.0495088,0.192862,1},
+    { 0.24616,1.01067,0.253843,0.0905939,0.389188,0.909345,-0.10878,0.0432567,0.179071,1},
+    { 0.235543,1.0539,0.23225,0.0805837,0.643484,0.930545,-0.0993042,0.0378305,0.166505,1},
+    { 0.2252,1.09507,0.212795,0.0775795,0.862835,0.879357,-0.0910013,0.0331194,0.155012,1},
+    { 0.215122,1.13466,0.194963,0.0756315,1.06733,0.819661,-0.0837081,0.0290037,0.144417,1},
+    { 0.205397,1.17243,0.1787,0.0750195,1.24222,0.750638,-0.0773465,0.0254319,0.134732,1},
+    { 0.195983,1.20874,0.163688,0.0711591,1.46687,0.718871,-0.0717531,0.0223263,0.12594,1},
+    { 0.186939,1.24347,0.149869,0.0725086,1.57612,0.641643,-0.0668336,0.0196445,0.118064,1},
+    { 0.17825,1.27671,0.137125,0.0707871,1.73703,0.598738,-0.0624797,0.0173259,0.111103,1},
+    { 0.169592,1.30578,0.125626,0.0740388,1.76593,0.52397,-0.0585789,0.0153273,0.105223,1},
+    { 0.16131,1.33335,0.114982,0.0720612,1.9089,0.494024,-0.0550343,0.0135927,0.10009,1},
+    { 0.15345,1.35935,0.105157,0.0748771,1.91694,0.437476,-0.0518016,0.0120874,0.0955878,1},
+    { 0.145951,1.38407,0.0959794,0.0706738,2.10499,0.427831,-0.0487693,0.0107741,0.0916481,1},
+    { 0.13883,1.4075,0.0874286,0.0749254,2.04711,0.373549,-0.0459385,0.00962609,0.0881835,1},
+    { 0.132064,1.42976,0.0794139,0.0792009,1.98885,0.327868,-0.0432572,0.00861458,0.085067,1},
+    { 0.125657,1.45083,0.0719223,0.0720626,2.23749,0.335023,-0.0407266,0.00772134,0.0822626,1},
+    { 0.11956,1.47091,0.0648518,0.0773672,2.12824,0.290419,-0.0383271,0.00692388,0.0796806,1},
+    { 0.113814,1.48988,0.0582402,0.0832988,2.01448,0.25129,-0.0360774,0.0062144,0.0772944,1},
+    { 0.108354,1.50797,0.0519781,0.0802491,2.12745,0.243054,-0.0339589,0.00557718,0.0750855,1},
+    { 0.103195,1.52514,0.0460669,0.0774446,2.2395,0.234717,-0.0319916,0.00500702,0.0730487,1},
+    { 0.0983091,1.5415,0.0404661,0.077843,2.26048,0.217582,-0.0301645,0.00449516,0.0711706,1},
+    { 0.0936892,1.55708,0.0351518,0.0858885,2.07601,0.183692,-0.0284792,0.00403628,0.0694585,1},
+    { 0.0892861,1.57206,0.030057,0.078723,2.29242,0.186644,-0.0269055,0.00362335,0.0679206,1},
+    { 0.0851302,1.58633,0.0252078,0.0823725,2.21479,0.166185,-0.0254489,0.00325508,0.0665646,1}
+};
@@ -0,0 +1,106 @@
+#define SAT5_COEFFS_LENGTH 101
+
+const float sat5_coeffs[][10] = {
+    { 1.00987,0.0021846,0.00629453,-0.0229679,0,0,0,0,0,0},
+    { 1.00967,0.0022674,0.00694615,-0.0239854,0,0,0,0,0,0},
+    { 1.00947,0.0024156,0.00759309,-0.0250449,0,0,0,0,0,0},
+    { 1.00927,0.00252419,0.0083483,-0.0261478,0,0,0,0,0,0},
+    { 1.00906,0.0026932,0.00913344,-0.0272945,0,0,0,0,0,0},
+    { 1.00883,0.00292251,0.00994035,-0.0284892,0,0,0,0,0,0},
+    { 1.00861,0.00317845,0.0107944,-0.0297313,0,0,0,0,0,0},
+    { 1.00835,0.0035889,0.0115964,-0.0310293,0,0,0,0,0,0},
+    { 1.00811,0.00399649,0.0124831,-0.0323836,0,0,0,0,0,0},
+    { 1.00785,0.0044688,0.0134161,-0.0337999,0,0,0,0,0,0},
+    { 1.00762,0.00481453,0.0145914,-0.0352874,0,0,0,0,0,0},
+    { 1.00693,0.00511849,0.0159535,-0.0368703,0,0,0,0,0,0},
+    { 1.00629,0.00522244,0.0176807,-0.0385412,0,0,0,0,0,0},
+    { 1.0057,0.00508704,0.0198246,-0.0403111,0,0,0,0,0,0},
+    { 1.00516,0.00468131,0.0224855,-0.0421935,0,0,0,0,0,0},
+    { 1.00468,0.00396472,0.0257159,-0.0441963,0,0,0,0,0,0},
+    { 1.00428,0.00281547,0.0296991,-0.0463366,0,0,0,0,0,0},
+    { 1.00394,0.0012734,0.0344396,-0.0486292,0,0,0,0,0,0},
+    { 1.00371,-0.000880011,0.0402357,-0.0510876,0,0,0,0,0,0},
+    { 1.00351,-0.00330043,0.0467844,-0.0537335,0,0,0,0,0,0},
+    { 1.00335,-0.00602752,0.0541798,-0.0565795,0,0,0,0,0,0},
+    { 1.00329,-0.0093976,0.0628478,-0.0596104,0,0,0,0,0,0},
+    { 1.00448,-0.0191616,0.0791672,-0.0626891,0,0,0,0,0,0},
+    { 1.00882,-0.0452076,0.114426,-0.0655413,0,0,0,0,0,0},
+    { 1.01695,-0.0914574,0.173948,-0.0679601,0,0,0,0,0,0},
+    { 1.02789,-0.153996,0.254782,-0.0698534,0,0,0,0,0,0},
+    { 1.0336,-0.223714,0.347491,-0.0716562,0,0,0,0,0,0},
+    { 1.03853,-0.29253,0.444504,-0.072975,0,0,0,0,0,0},
+    { 1.04139,-0.353944,0.539053,-0.0738756,0,0,0,0,0,0},
+    { 1.04155,-0.40442,0.627354,-0.0744557,0,0,0,0,0,0},
+    { 1.03898,-0.443295,0.708517,-0.0748391,0,0,0,0,0,0},
+    { 1.03412,-0.472101,0.78404,-0.0751687,0,0,0,0,0,0},
+    { 1.0276,-0.493527,0.856815,-0.0755997,0,0,0,0,0,0},
+    { 1.01985,-0.509197,0.928627,-0.0762504,0,0,0,0,0,0},
+    { 1.01092,-0.519124,0.999585,-0.077195,0,0,0,0,0,0},
+    { 1.00076,-0.522588,1.06897,-0.0784577,0,0,0,0,0,0},
+    { 0.989259,-0.518616,1.13568,-0.0800351,0,0,0,0,0,0},
+    { 0.976518,-0.507172,1.19957,-0.0819029,0,0,0,0,0,0},
+    { 0.96275,-0.488834,1.26124,-0.0840317,0,0,0,0,0,0},
+    { 0.948177,-0.464289,1.32144,-0.0863896,0,0,0,0,0,0},
+    { 0.933035,-0.434405,1.38121,-0.0889364,0,0,0,0,0,0},
+    { 0.898403,-0.391404,1.41125,-0.0935816,0,0,0,0,0,0},
+    { 0.864477,-0.345351,1.43978,-0.0984829,0,0,0,0,0,0},
+    { 0.831123,-0.295411,1.4656,-0.103572,0,0,0,0,0,0},
+    { 0.798158,-0.240364,1.48694,-0.108766,0,0,0,0,0,0},
+    { 0.765502,-0.179632,1.50276,-0.113987,0,0,0,0,0,0},
+    { 0.733226,-0.113261,1.51258,-0.119173,0,0,0,0,0,0},
+    { 0.701374,-0.0414666,1.51632,-0.12428,0,0,0,0,0,0},
+    { 0.670112,0.0350868,1.51426,-0.129257,0,0,0,0,0,0},
+    { 0.639542,0.115842,1.50676,-0.134075,0,0,0,0,0,0},
+    { 0.290029,0.195038,1.52162,0.321044,-1.35002,0.849842,-0.544197,0.330935,0.594751,1},
+    { 0.308629,0.255592,1.23534,0.313569,-1.23481,0.823417,-0.477193,0.2843,0.540394,1},
+    { 0.321083,0.319305,1.02776,0.276058,-1.23078,0.873269,-0.419084,0.244142,0.490373,1},
+    { 0.328664,0.385257,0.870402,0.24742,-1.18497,0.900636,-0.36886,0.209779,0.444872,1},
+    { 0.332384,0.452697,0.747127,0.2433,-1.02275,0.840399,-0.325641,0.180519,0.403868,1},
+    { 0.33304,0.520966,0.648206,0.197969,-1.0465,0.942307,-0.288294,0.155543,0.366772,1},
+    { 0.327168,0.582335,0.574242,0.199241,-0.858779,0.861981,-0.256077,0.134334,0.337788,1},
+    { 0.319545,0.642126,0.512276,0.159562,-0.860676,0.987629,-0.228116,0.116179,0.311345,1},
+    { 0.310681,0.699999,0.459701,0.149577,-0.710573,0.965053,-0.203904,0.100709,0.287502,1},
+    { 0.300937,0.755903,0.414497,0.132601,-0.585142,0.995377,-0.182755,0.0874227,0.265714,1},
+    { 0.290632,0.809744,0.375214,0.120189,-0.426571,1.00309,-0.164267,0.0760189,0.245859,1},
+    { 0.279995,0.861595,0.340679,0.110464,-0.245601,0.995998,-0.148048,0.0661952,0.227691,1},
+    { 0.2692,0.911468,0.310079,0.0988725,-0.0509756,1.01483,-0.133788,0.0577198,0.211053,1},
+    { 0.258366,0.959377,0.282815,0.09128,0.166057,1.00175,-0.121226,0.0503772,0.195815,1},
+    { 0.247639,1.00522,0.258454,0.0852264,0.394286,0.977061,-0.110202,0.0440155,0.181855,1},
+    { 0.237066,1.04916,0.236531,0.080643,0.624831,0.939644,-0.100521,0.038487,0.169119,1},
+    { 0.226744,1.09113,0.216765,0.0776439,0.846063,0.887251,-0.0920446,0.0336765,0.157449,1},
+    { 0.216707,1.1313,0.19882,0.0757596,1.04976,0.82632,-0.0846277,0.0294979,0.146822,1},
+    { 0.206998,1.16973,0.182447,0.0756312,1.2175,0.751605,-0.0781582,0.025861,0.137092,1},
+    { 0.197602,1.2067,0.167364,0.0700284,1.47501,0.737414,-0.0724607,0.0227069,0.128299,1},
+    { 0.188568,1.24213,0.153479,0.0752666,1.50513,0.623629,-0.0674625,0.0199743,0.120366,1},
+    { 0.179454,1.27321,0.140985,0.0753143,1.62497,0.568503,-0.0630266,0.0176054,0.113547,1},
+    { 0.170743,1.30272,0.129423,0.0728202,1.78999,0.537664,-0.0590542,0.0155611,0.107579,1},
+    { 0.162432,1.33067,0.118749,0.0766566,1.79086,0.468399,-0.0554655,0.0137947,0.102395,1},
+    { 0.15453,1.35709,0.108893,0.0777047,1.84471,0.425008,-0.0521786,0.0122627,0.0978775,1},
+    { 0.146994,1.38218,0.0997312,0.0667951,2.22554,0.456064,-0.0491225,0.0109262,0.0939354,1},
+    { 0.139848,1.40591,0.0912271,0.0696476,2.20189,0.404503,-0.0462746,0.00975731,0.0904579,1},
+    { 0.133034,1.42854,0.083265,0.0734708,2.14385,0.355618,-0.0435754,0.00872997,0.0874073,1},
+    { 0.12658,1.44997,0.0758375,0.0742478,2.17203,0.326978,-0.0410163,0.00782123,0.0846482,1},
+    { 0.120461,1.47034,0.0688774,0.0715876,2.30012,0.315667,-0.0386012,0.00701555,0.0821786,1},
+    { 0.114676,1.48962,0.0623711,0.0772785,2.17122,0.272389,-0.0363355,0.00629658,0.0799095,1},
+    { 0.109187,1.50797,0.0562503,0.0786507,2.17034,0.249351,-0.0342075,0.00565139,0.0778088,1},
+    { 0.104004,1.52539,0.0504992,0.0802968,2.15961,0.227558,-0.0322277,0.00507354,0.0758721,1},
+    { 0.0990815,1.54205,0.0450364,0.0825367,2.13126,0.206322,-0.0303745,0.00455525,0.0741203,1},
+    { 0.0944237,1.55795,0.039862,0.0841068,2.11934,0.188573,-0.0286638,0.00408941,0.0725053,1},
+    { 0.0900024,1.5732,0.034932,0.0886178,2.0359,0.166635,-0.0270814,0.00367121,0.0710622,1},
+    { 0.0857988,1.58744,0.0302518,0.091064,2.00346,0.151022,-0.0256142,0.00329697,0.0698091,1},
+    { 0.0817973,1.60113,0.0257701,0.0881533,2.09073,0.145248,-0.024252,0.00296048,0.0687305,1},
+    { 0.0780072,1.61424,0.0214919,0.0843035,2.20628,0.141411,-0.0229991,0.00265975,0.0678368,1},
+    { 0.0743907,1.62691,0.0173674,0.0887301,2.11352,0.125069,-0.0218365,0.0023894,0.0671266,1},
+    { 0.0709635,1.63903,0.0134337,0.0916837,2.06041,0.112688,-0.0207696,0.00214792,0.0666087,1},
+    { 0.0677079,1.65068,0.00966037,0.0822084,2.3127,0.11707,-0.0197734,0.00193204,0.0662859,1},
+    { 0.0646243,1.66185,0.00605405,0.0867938,2.20294,0.103308,-0.0188565,0.001739,0.0661451,1},
+    { 0.0616826,1.67262,0.00258737,0.0877172,2.19057,0.0952816,-0.0179881,0.00156572,0.0661839,1},
+    { 0.0588998,1.68293,-0.000720127,0.0816379,2.3638,0.0955061,-0.0171759,0.00141104,0.0664024,1},
+    { 0.0562466,1.69287,-0.00390168,0.0859042,2.25476,0.0846736,-0.0164151,0.00127185,0.0667916,1},
+    { 0.053733,1.70239,-0.00693246,0.0969907,2.00337,0.0699772,-0.0157083,0.00114709,0.0673517,1},
+    { 0.0513487,1.71151,-0.00981521,0.0894247,2.17859,0.0708816,-0.0150382,0.00103537,0.0680914,1},
+    { 0.0490916,1.72019,-0.0125328,0.0913973,2.13609,0.0648004,-0.0144163,0.000935405,0.0690135,1},
+    { 0.0469373,1.72856,-0.0151156,0.0826749,2.36514,0.0670407,-0.0138146,0.000845739,0.0701449,1},
+    { 0.044901,1.73648,-0.0175206,0.0837378,2.3375,0.0620427,-0.0132464,0.000765798,0.0714888,1}
+};
+
@@ -0,0 +1,1327 @@
+/*
+ * maetning-bench
+ *
+ * Offline benchmark of the saturation core. It runs SatProcessor, the same
+ * code path as the plugin's run(), without DPF or a plugin host, and reports
+ * ns/sample and samples/sec for each combination of saturation type,
+ * saturation step, block size, channel count, oversampling factor, ADAA
+ * order and evaluation mode.
+ *
+ * With --strips N, every case runs N processors of the same settings, like
+ * the channel strips of a mixer, and with --batch, it runs them as one
+ * SatBatch instead (see batch.h).
+ *
+ * Usage: maetning-bench [options]
+ *   --types LIST        saturation types (default 0-5)
+ *   --steps LIST        saturation steps (default 0,50,100)
+ *   --blocks LIST       block sizes in frames (default 16,32,...,8192)
+ *   --channels LIST     channel counts (default 1,2)
+ *   --oversampling LIST oversampling factors (default 1)
+ *   --adaa LIST         ADAA orders, 0 for off (default 0)
+ *   --eval LIST         evaluation modes, 0 exact, 1 lookup tables, 2 approximate division (default 0)
+ *   --isa NAME          auto, scalar, sse2, avx2, avx512 or neon (default auto)
+ *   --min-time SEC      minimum measuring time per case (default 0.02)
+ *   --automate          move the saturation by half a step every block, so every block ramps
+ *   --events N          move it the same way with N sample-accurate parameter events per block
+ *   --strips N          processors per case, each with its own buffers (default 1)
+ *   --batch             run the strips as one batch, without oversampling, ADAA or lookup tables
+ *   --label TEXT        free text stored in the report, e.g. a commit id
+ *   --json              write a JSON report instead of a table
+ *   --verify            compare the output of every instruction set and evaluation mode with the scalar
+ *                       kernels and the baseline of the plugin, and that of batches with single
+ *                       processors, and check ADAA gain ramps, instead of timing, see run_verify(),
+ *                       run_verify_batch() and run_verify_ramp()
+ *
+ * A LIST is comma separated, and each item is a number N, a range A-B or a
+ * range with a stride A-B:S, e.g. "0-100:10".
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "baseline.h"
+#include "batch.h"
+#include "options.h"
+#include "processor.h"
+
+// -----------------------------------------------------------------------------------------------------------
+
+struct BenchOptions
+{
+    std::vector<int> types;
+    std::vector<int> steps;
+    std::vector<int> blocks;
+    std::vector<int> channels;
+    std::vector<int> oversampling;
+    std::vector<int> adaa;
+    std::vector<int> eval;
+    std::string isa;
+    std::string label;
+    double min_time;
+    bool automate;
+    int events;
+    int strips;
+    bool batch;
+    bool json;
+    bool verify;
+    bool steps_set;
+};
+
+struct BenchResult
+{
+    int type;
+    int step;
+    int block;
+    int channels;
+    int strips;
+    int oversampling;
+    int adaa;
+    int eval;
+    float lut_error;
+    uint64_t samples;
+    double seconds;
+};
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "usage: maetning-bench [--types LIST] [--steps LIST] [--blocks LIST] [--channels LIST]\n"
+                 "                      [--oversampling LIST] [--adaa LIST] [--eval LIST] [--isa NAME]\n"
+                 "                      [--min-time SEC] [--automate] [--events N] [--strips N] [--batch]\n"
+                 "                      [--label TEXT] [--json] [--verify]\n");
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+   Noise slightly above full scale, so every knee of the curves is hit.
+ */
+static void bench_signal(std::vector<std::vector<float> >& in, std::vector<std::vector<float> >& out,
+                         std::vector<const float*>& inputs, std::vector<float*>& outputs, int channels, int block)
+{
+    in.assign(channels, std::vector<float>(block));
+    out.assign(channels, std::vector<float>(block));
+    inputs.resize(channels);
+    outputs.resize(channels);
+
+    uint32_t seed = 22222;
+    for (int ch = 0; ch < channels; ch++) {
+        for (int n = 0; n < block; n++) {
+            seed = seed*1664525 + 1013904223;
+            in[ch][n] = 1.5f*((seed >> 8)*(2.0f/16777216.0f) - 1.0f);
+        }
+        inputs[ch] = in[ch].data();
+        outputs[ch] = out[ch].data();
+    }
+}
+
+/**
+   Time one case. Blocks are processed until at least @a min_time seconds have passed.
+ */
+static BenchResult run_case(const BenchOptions& opt, int type, int step, int block, int channels,
+                            int oversampling, int adaa, int eval)
+{
+    std::vector<std::unique_ptr<SatProcessor> > dsps(opt.strips);
+
+    for (int i = 0; i < opt.strips; i++) {
+        SatProcessor& dsp = *(dsps[i] = std::unique_ptr<SatProcessor>(new SatProcessor(channels)));
+
+        if (opt.isa != "auto") {
+            dsp.setIsa(opt.isa.c_str());
+        }
+
+        dsp.setType(type);
+        dsp.setSaturation(step);
+        dsp.setMasterVolume(-1.0f);
+        dsp.setMasterMix(80.0f);
+        dsp.setOversampling(oversampling);
+        dsp.setAntialiasing(adaa);
+        dsp.setEvaluation(eval);
+        dsp.reset();
+
+        // Time the table, not the curve it replaces while it is being built
+        dsp.waitForLut();
+    }
+
+    std::vector<std::vector<float> > in;
+    std::vector<std::vector<float> > out;
+    std::vector<const float*> inputs;
+    std::vector<float*> outputs;
+    bench_signal(in, out, inputs, outputs, opt.strips*channels, block);
+
+    // With --automate, the saturation alternates between the step and half a step next to it
+    const float automated = (step < NUM_SATURATION_STEPS - 1) ? step + 0.5f : step - 0.5f;
+    uint64_t count = 0;
+
+    // With --events, it alternates the same way at evenly spaced frames within each block
+    std::vector<SatParameterEvent> events(opt.events);
+    for (int i = 0; i < opt.events; i++) {
+        events[i].frame = (uint32_t)((int64_t)i*block/opt.events);
+        events[i].index = SAT_PARAM_SATURATION;
+        events[i].value = (i & 1) ? automated : step;
+    }
+
+    // Warm up caches and branch predictors
+    for (int i = 0; i < 16; i++) {
+        const float saturation = (count++ & 1) ? automated : step;
+
+        for (int k = 0; k < opt.strips; k++) {
+            if (opt.automate) {
+                dsps[k]->setSaturation(saturation);
+            }
+            dsps[k]->process(&inputs[k*channels], &outputs[k*channels], block, events.data(), events.size());
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::time_point start = Clock::now();
+    double seconds = 0.0;
+    uint64_t blocks = 0;
+
+    // Check the clock every batch of blocks, so small blocks are not dominated by clock reads
+    const uint64_t batch = 1 + 65536/(block*opt.strips);
+
+    while (seconds < opt.min_time) {
+        for (uint64_t i = 0; i < batch; i++) {
+            const float saturation = (count++ & 1) ? automated : step;
+
+            for (int k = 0; k < opt.strips; k++) {
+                if (opt.automate) {
+                    dsps[k]->setSaturation(saturation);
+                }
+                dsps[k]->process(&inputs[k*channels], &outputs[k*channels], block, events.data(), events.size());
+            }
+        }
+        blocks += batch;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    BenchResult r;
+    r.type = type;
+    r.step = step;
+    r.block = block;
+    r.channels = channels;
+    r.strips = opt.strips;
+    r.oversampling = oversampling;
+    r.adaa = adaa;
+    r.eval = eval;
+    r.lut_error = dsps[0]->getLutError();
+    r.samples = blocks*block*channels*opt.strips;
+    r.seconds = seconds;
+    return r;
+}
+
+/**
+   Like run_case(), with the strips in one SatBatch.
+ */
+static BenchResult run_batch_case(const BenchOptions& opt, int type, int step, int block, int channels, int eval)
+{
+    SatBatch dsp(opt.strips, channels);
+
+    if (opt.isa != "auto") {
+        dsp.setIsa(opt.isa.c_str());
+    }
+
+    dsp.setEvaluation(eval);
+
+    for (int k = 0; k < opt.strips; k++) {
+        dsp.setType(k, type);
+        dsp.setSaturation(k, step);
+        dsp.setMasterVolume(k, -1.0f);
+        dsp.setMasterMix(k, 80.0f);
+    }
+    dsp.reset();
+
+    std::vector<std::vector<float> > in;
+    std::vector<std::vector<float> > out;
+    std::vector<const float*> inputs;
+    std::vector<float*> outputs;
+    bench_signal(in, out, inputs, outputs, opt.strips*channels, block);
+
+    const float automated = (step < NUM_SATURATION_STEPS - 1) ? step + 0.5f : step - 0.5f;
+    uint64_t count = 0;
+
+    for (int i = 0; i < 16; i++) {
+        const float saturation = (count++ & 1) ? automated : step;
+
+        for (int k = 0; k < opt.strips && opt.automate; k++) {
+            dsp.setSaturation(k, saturation);
+        }
+        dsp.process(inputs.data(), outputs.data(), block);
+    }
+
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::time_point start = Clock::now();
+    double seconds = 0.0;
+    uint64_t blocks = 0;
+    const uint64_t batch = 1 + 65536/(block*opt.strips);
+
+    while (seconds < opt.min_time) {
+        for (uint64_t i = 0; i < batch; i++) {
+            const float saturation = (count++ & 1) ? automated : step;
+
+            for (int k = 0; k < opt.strips && opt.automate; k++) {
+                dsp.setSaturation(k, saturation);
+            }
+            dsp.process(inputs.data(), outputs.data(), block);
+        }
+        blocks += batch;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    BenchResult r;
+    r.type = type;
+    r.step = step;
+    r.block = block;
+    r.channels = channels;
+    r.strips = opt.strips;
+    r.oversampling = 1;
+    r.adaa = SAT_ADAA_OFF;
+    r.eval = eval;
+    r.lut_error = 0.0f;
+    r.samples = blocks*block*channels*opt.strips;
+    r.seconds = seconds;
+    return r;
+}
+
+static void print_table(const std::vector<BenchResult>& results, const char* isa, bool automate, int events,
+                        bool batch)
+{
+    std::printf("# isa: %s%s", isa, automate ? ", automated" : "");
+    if (events > 0) {
+        std::printf(", %d events/block", events);
+    }
+    if (batch) {
+        std::printf(", batch");
+    }
+    std::printf("\n");
+    std::printf("%4s %4s %6s %3s %6s %3s %4s %4s %12s %14s %10s\n", "type", "step", "block", "ch", "strips", "os",
+                "adaa", "eval", "ns/sample", "samples/sec", "lut error");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::printf("%4d %4d %6d %3d %6d %3d %4d %4d %12.4f %14.4g %10.3g\n", r.type, r.step, r.block, r.channels,
+                    r.strips, r.oversampling, r.adaa, r.eval, 1e9*r.seconds/r.samples, r.samples/r.seconds,
+                    r.lut_error);
+    }
+}
+
+static void print_json(const std::vector<BenchResult>& results, const char* isa, bool automate, int events,
+                       bool batch, const std::string& label)
+{
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"maetning-bench\",\n");
+    std::printf("  \"label\": \"");
+    for (size_t i = 0; i < label.size(); i++) {
+        const char c = label[i];
+        if (c == '"' || c == '\\') {
+            std::printf("\\%c", c);
+        }
+        else if ((unsigned char)c >= 0x20) {
+            std::printf("%c", c);
+        }
+    }
+    std::printf("\",\n");
+    std::printf("  \"isa\": \"%s\",\n", isa);
+    std::printf("  \"automate\": %s,\n", automate ? "true" : "false");
+    std::printf("  \"events\": %d,\n", events);
+    std::printf("  \"batch\": %s,\n", batch ? "true" : "false");
+    std::printf("  \"results\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::printf("    {\"type\": %d, \"step\": %d, \"block_size\": %d, \"channels\": %d, \"strips\": %d, "
+                    "\"oversampling\": %d, \"adaa\": %d, \"eval\": %d, \"lut_error\": %.6g, \"samples\": %llu, "
+                    "\"seconds\": %.6f, \"ns_per_sample\": %.4f, \"samples_per_sec\": %.6g}%s\n",
+                    r.type, r.step, r.block, r.channels, r.strips, r.oversampling, r.adaa, r.eval, r.lut_error,
+                    (unsigned long long)r.samples, r.seconds, 1e9*r.seconds/r.samples, r.samples/r.seconds,
+                    (i + 1 < results.size()) ? "," : "");
+    }
+
+    std::printf("  ]\n");
+    std::printf("}\n");
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// Verification
+//
+// Every instruction set and evaluation mode is run on the same settings and
+// signals as a processor with the scalar kernels and exact evaluation, and
+// must stay within a tolerance of it. The tolerance depends on the mode: the
+// exact kernels differ from the scalar ones only where the compiler reorders
+// arithmetic (-ffast-math), approximate division by its error bound, and
+// lookup tables by the error measured for each table.
+//
+// The scalar reference is itself refactored code, so settled blocks are also
+// run through SatBaseline, the per-sample code of the plugin before the core
+// was split out of it. The scalar kernels and the exact evaluation of every
+// instruction set must match it within the exact tolerance.
+
+#define VERIFY_FRAMES 1024
+#define VERIFY_SIGNALS 6
+
+// Exact kernels: ULPs of the reference, or an absolute difference for outputs close to 0. Some curves are the
+// difference of terms that grow with up to the square of the input, so the absolute tolerance is per unit of the
+// squared input peak of the block (at least 1). Inputs far beyond full scale are a signal of their own, so they
+// do not loosen the tolerance for denormals, zeros and full scale.
+#define VERIFY_EXACT_ULPS 4
+#define VERIFY_EXACT_ABS 1e-6f
+
+// Approximate division: absolute difference per unit of the squared input peak
+#define VERIFY_APPROX_ABS 2e-5f
+
+static const char* const verify_signal_names[VERIFY_SIGNALS] = {
+    "sine", "noise", "impulse", "edge", "sweep", "extreme",
+};
+
+/**
+   Test signal @a kind for channel @a ch.
+ */
+static void verify_signal(int kind, int ch, std::vector<float>& x)
+{
+    // Denormals, zeros of both signs and full scale
+    static const float edge[] = {
+        1e-40f, -1e-40f, 0.0f, -0.0f, 1.0f, -1.0f, 1e-20f, 0.999999f,
+    };
+
+    // Far beyond full scale
+    static const float extreme[] = {
+        8.0f, -8.0f, 100.0f, -100.0f, 30.0f, -2.5f,
+    };
+
+    uint32_t seed = 12345 + ch;
+
+    for (int n = 0; n < VERIFY_FRAMES; n++) {
+        switch (kind) {
+        case 0:
+            x[n] = 0.9f*std::sin(0.13f*n + ch);
+            break;
+
+        case 1:
+            seed = seed*1664525 + 1013904223;
+            x[n] = 1.5f*((seed >> 8)*(2.0f/16777216.0f) - 1.0f);
+            break;
+
+        case 2:
+            x[n] = (n == 100 + ch) ? 1.0f : (n == 600) ? -1.0f : 0.0f;
+            break;
+
+        case 3:
+            x[n] = edge[(n + ch) % (sizeof(edge)/sizeof(edge[0]))];
+            break;
+
+        case 4:
+            x[n] = -4.0f + 8.0f*n/(VERIFY_FRAMES - 1);
+            break;
+
+        default:
+            x[n] = extreme[(n + ch) % (sizeof(extreme)/sizeof(extreme[0]))];
+            break;
+        }
+    }
+}
+
+/**
+   Distance of @a a and @a b in units in the last place.
+ */
+static uint32_t verify_ulps(float a, float b)
+{
+    int32_t ia;
+    int32_t ib;
+    std::memcpy(&ia, &a, sizeof(ia));
+    std::memcpy(&ib, &b, sizeof(ib));
+
+    // Order the bit patterns like the numbers they represent
+    if (ia < 0) ia = INT32_MIN - ia;
+    if (ib < 0) ib = INT32_MIN - ib;
+
+    const int64_t d = (int64_t)ia - ib;
+    return (uint32_t)((d < 0) ? -d : d);
+}
+
+struct VerifyTarget
+{
+    std::string isa;
+    int eval;
+    SatProcessor* dsp;
+
+    uint64_t samples;
+    uint64_t failures;
+    uint32_t max_ulps;
+    float max_abs;
+    std::string worst;
+};
+
+/**
+   Compare sample @a b with the reference @a a, within the tolerance of the evaluation mode of @a t for a squared
+   input peak of @a scale. Returns true if the difference is the largest so far.
+ */
+static bool verify_sample(VerifyTarget& t, float a, float b, float scale, float lut_tolerance)
+{
+    if (a == b || (a != a && b != b)) {
+        return false;
+    }
+
+    const uint32_t ulps = verify_ulps(a, b);
+    const float diff = std::fabs(a - b);
+    bool ok = ulps <= VERIFY_EXACT_ULPS || diff <= VERIFY_EXACT_ABS*scale;
+
+    if (t.eval == SAT_EVAL_APPROX) ok = ok || diff <= VERIFY_APPROX_ABS*scale;
+    if (t.eval == SAT_EVAL_LUT) ok = ok || diff <= lut_tolerance;
+
+    if (!ok) {
+        t.failures++;
+    }
+    if (ulps > t.max_ulps) {
+        t.max_ulps = ulps;
+    }
+    if (diff > t.max_abs || diff != diff) {
+        t.max_abs = diff;
+        return true;
+    }
+    return false;
+}
+
+/**
+   Compare the outputs @a out of @a channels channels with the reference @a ref and record the largest difference
+   in @a t, described by @a what. See verify_sample().
+ */
+static void verify_block(VerifyTarget& t, const std::vector<std::vector<float> >& ref,
+                         const std::vector<std::vector<float> >& out, int channels, float scale, float lut_tolerance,
+                         const char* what)
+{
+    for (int ch = 0; ch < channels; ch++) {
+        for (int n = 0; n < VERIFY_FRAMES; n++) {
+            if (verify_sample(t, ref[ch][n], out[ch][n], scale, lut_tolerance)) {
+                char text[160];
+                std::snprintf(text, sizeof(text), "%s frame %d", what, n);
+                t.worst = text;
+            }
+        }
+    }
+    t.samples += channels*VERIFY_FRAMES;
+}
+
+/**
+   Print the results of @a targets in a table headed @a name. Returns the number of samples out of tolerance.
+ */
+static uint64_t verify_report(const char* name, const std::vector<VerifyTarget>& targets)
+{
+    uint64_t failures = 0;
+
+    std::printf("%-7s %4s %12s %9s %11s %10s  %s\n", name, "eval", "samples", "max ulps", "max abs", "failures",
+                "largest difference");
+
+    for (size_t k = 0; k < targets.size(); k++) {
+        const VerifyTarget& t = targets[k];
+
+        std::printf("%-7s %4d %12llu %9u %11.3g %10llu  %s\n", t.isa.c_str(), t.eval, (unsigned long long)t.samples,
+                    t.max_ulps, t.max_abs, (unsigned long long)t.failures, t.worst.c_str());
+        failures += t.failures;
+    }
+
+    return failures;
+}
+
+/**
+   Run every combination of the types, oversampling factors and ADAA orders of @a opt with all saturation steps
+   (or those of --steps), three mix and three volume settings and all test signals through every instruction set
+   (or the one of --isa) and every evaluation mode of --eval. Returns the number of samples out of tolerance.
+
+   Without oversampling and ADAA, the blocks are settled and single band, so the scalar reference and the exact
+   evaluation of every instruction set are also compared with the baseline of the plugin (see baseline.h).
+ */
+static uint64_t run_verify(const BenchOptions& opt)
+{
+    static const char* const isas[] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+    static const float mixes[] = { 100.0f, 50.0f, 0.0f };
+    static const float volumes[] = { 0.0f, -6.0f, -51.0f };
+    const int channels = 2;
+
+    std::vector<int> steps = opt.steps;
+    if (!opt.steps_set) {
+        sat_parse_list("0-100", steps);
+    }
+
+    SatProcessor reference(channels);
+    reference.setIsa("scalar");
+
+    SatBaseline baseline;
+
+    std::vector<VerifyTarget> targets;
+
+    for (size_t i = 0; i < sizeof(isas)/sizeof(isas[0]); i++) {
+        if (sat_kernels_isa(isas[i]) == NULL || (opt.isa != "auto" && opt.isa != isas[i])) {
+            continue;
+        }
+        for (size_t e = 0; e < opt.eval.size(); e++) {
+            VerifyTarget t;
+            t.isa = isas[i];
+            t.eval = opt.eval[e];
+            t.dsp = new SatProcessor(channels);
+            t.dsp->setIsa(isas[i]);
+            t.dsp->setEvaluation(opt.eval[e]);
+            t.samples = 0;
+            t.failures = 0;
+            t.max_ulps = 0;
+            t.max_abs = 0.0f;
+            targets.push_back(t);
+        }
+    }
+
+    std::vector<std::vector<float> > in(channels, std::vector<float>(VERIFY_FRAMES));
+    std::vector<std::vector<float> > ref(channels, std::vector<float>(VERIFY_FRAMES));
+    std::vector<std::vector<float> > out(channels, std::vector<float>(VERIFY_FRAMES));
+    std::vector<std::vector<float> > base(channels, std::vector<float>(VERIFY_FRAMES));
+    std::vector<const float*> inputs(channels);
+    std::vector<float*> ref_outputs(channels);
+    std::vector<float*> outputs(channels);
+    std::vector<float*> base_outputs(channels);
+
+    for (int ch = 0; ch < channels; ch++) {
+        inputs[ch] = in[ch].data();
+        ref_outputs[ch] = ref[ch].data();
+        outputs[ch] = out[ch].data();
+        base_outputs[ch] = base[ch].data();
+    }
+
+    // The scalar reference first, then the exact evaluation of every other instruction set
+    std::vector<VerifyTarget> golden(1);
+    std::vector<int> golden_index(1, -1);
+
+    golden[0].isa = "scalar";
+    golden[0].eval = SAT_EVAL_EXACT;
+    golden[0].dsp = &reference;
+
+    for (size_t k = 0; k < targets.size(); k++) {
+        if (targets[k].eval == SAT_EVAL_EXACT && targets[k].isa != "scalar") {
+            golden.push_back(targets[k]);
+            golden_index.push_back((int)k);
+        }
+    }
+
+    for (size_t g = 0; g < golden.size(); g++) {
+        golden[g].samples = 0;
+        golden[g].failures = 0;
+        golden[g].max_ulps = 0;
+        golden[g].max_abs = 0.0f;
+    }
+
+    for (size_t ti = 0; ti < opt.types.size(); ti++)
+    for (size_t si = 0; si < steps.size(); si++)
+    for (size_t oi = 0; oi < opt.oversampling.size(); oi++)
+    for (size_t ai = 0; ai < opt.adaa.size(); ai++)
+    for (size_t mi = 0; mi < sizeof(mixes)/sizeof(mixes[0]); mi++)
+    for (size_t vi = 0; vi < sizeof(volumes)/sizeof(volumes[0]); vi++)
+    for (int signal = 0; signal < VERIFY_SIGNALS; signal++) {
+        float peak = 1.0f;
+        float scale;
+
+        for (int ch = 0; ch < channels; ch++) {
+            verify_signal(signal, ch, in[ch]);
+            for (int n = 0; n < VERIFY_FRAMES; n++) {
+                peak = std::fmax(peak, std::fabs(in[ch][n]));
+            }
+        }
+        scale = peak*peak;
+
+        char what[128];
+        std::snprintf(what, sizeof(what), "type %d step %d os %d adaa %d mix %g vol %g %s", opt.types[ti], steps[si],
+                      opt.oversampling[oi], opt.adaa[ai], mixes[mi], volumes[vi], verify_signal_names[signal]);
+
+        const bool settled = opt.oversampling[oi] == 1 && opt.adaa[ai] == SAT_ADAA_OFF;
+
+        if (settled) {
+            baseline.setParameterValue(SAT_PARAM_TYPE, opt.types[ti]);
+            baseline.setParameterValue(SAT_PARAM_SATURATION, steps[si]);
+            baseline.setParameterValue(SAT_PARAM_MASTERMIX, mixes[mi]);
+            baseline.setParameterValue(SAT_PARAM_MASTERVOLUME, volumes[vi]);
+            baseline.run(inputs.data(), base_outputs.data(), VERIFY_FRAMES);
+        }
+
+        for (size_t k = 0; k <= targets.size(); k++) {
+            SatProcessor& dsp = (k == 0) ? reference : *targets[k - 1].dsp;
+
+            dsp.setType(opt.types[ti]);
+            dsp.setSaturation(steps[si]);
+            dsp.setMasterMix(mixes[mi]);
+            dsp.setMasterVolume(volumes[vi]);
+            dsp.setOversampling(opt.oversampling[oi]);
+            dsp.setAntialiasing(opt.adaa[ai]);
+            dsp.reset();
+            dsp.waitForLut();
+            dsp.process(inputs.data(), (k == 0) ? ref_outputs.data() : outputs.data(), VERIFY_FRAMES);
+
+            if (settled) {
+                for (size_t g = 0; g < golden.size(); g++) {
+                    if (golden_index[g] == (int)k - 1) {
+                        verify_block(golden[g], base, (k == 0) ? ref : out, channels, scale, 0.0f, what);
+                    }
+                }
+            }
+
+            if (k == 0) {
+                continue;
+            }
+
+            const float lut_tolerance = 2.0f*dsp.getLutError() + VERIFY_EXACT_ABS;
+            verify_block(targets[k - 1], ref, out, channels, scale, lut_tolerance, what);
+        }
+    }
+
+    uint64_t failures = verify_report("isa", targets);
+
+    std::printf("\n");
+    failures += verify_report("base", golden);
+
+    for (size_t k = 0; k < targets.size(); k++) {
+        delete targets[k].dsp;
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// Batch verification
+//
+// A batch of strips with all types of --types and a spread of saturations,
+// mixes and volumes is compared with one processor per strip, both with the
+// same kernels, over small blocks in which the parameters of some strips
+// ramp. The types of the strips that ramp change in the middle of the first
+// block, so the fades end within the signals, and the types of some once more
+// in the middle of a later block, while they fade. Packing channels of
+// different strips into the lanes of one kernel must give the same output,
+// up to the reordering of -ffast-math.
+
+// More than two groups of lanes, and not a multiple of one
+#define VERIFY_BATCH_STRIPS 37
+
+// Parameter changes per strip and block, at most
+#define VERIFY_BATCH_PARAMS 5
+
+// Block sizes, in turn, so both long segments and short ones packed across lanes are checked
+static const int verify_batch_blocks[] = { 64, 7, 16, 3, 128, 1, 15 };
+
+/**
+   Write the parameter changes of strip @a strip in block @a block of @a frames frames of the batch verification
+   to @a params, sorted by frame, and return their number, at most VERIFY_BATCH_PARAMS.
+ */
+static int verify_batch_params(int strip, int block, int frames, const BenchOptions& opt,
+                               const std::vector<int>& steps, SatParameterEvent* params)
+{
+    static const float mixes[] = { 100.0f, 50.0f, 0.0f };
+    static const float volumes[] = { 0.0f, -6.0f, -51.0f };
+    const int types = (int)opt.types.size();
+    int count = 0;
+
+    for (int i = 0; i < VERIFY_BATCH_PARAMS; i++) {
+        params[i].frame = 0;
+    }
+
+    if (block == 0) {
+        params[count].index = SAT_PARAM_TYPE;
+        params[count++].value = opt.types[strip % opt.types.size()];
+        params[count].index = SAT_PARAM_SATURATION;
+        params[count++].value = steps[(strip*7) % steps.size()] + ((strip % 3 == 0) ? 0.5f : 0.0f);
+        params[count].index = SAT_PARAM_MASTERMIX;
+        params[count++].value = mixes[strip % 3];
+        params[count].index = SAT_PARAM_MASTERVOLUME;
+        params[count++].value = volumes[(strip/3) % 3];
+    }
+
+    // Ramps that start together, so batch and processors split their blocks at the same frames
+    if (block == 3 && strip % 2 == 0) {
+        params[count].index = SAT_PARAM_SATURATION;
+        params[count++].value = steps[(strip*11) % steps.size()] + 0.25f;
+    }
+    if (block == 5 && strip % 4 == 1) {
+        params[count].index = SAT_PARAM_MASTERMIX;
+        params[count++].value = 30.0f;
+        params[count].index = SAT_PARAM_MASTERVOLUME;
+        params[count++].value = -3.0f;
+    }
+
+    // Type changes in the middle of a block, the second one while the first fades. Strips that keep their type
+    // set it again, so all of them split the block at the same frame. The batch also splits all strips where
+    // the first fades end, which only the strips that keep their type, without ramps, do not.
+    if (block == 0 || block == 4) {
+        int shift = 0;
+
+        if (strip % 4 != 3) shift++;
+        if (strip % 4 == 0 && block == 4) shift++;
+
+        params[count].frame = frames/2;
+        params[count].index = SAT_PARAM_TYPE;
+        params[count++].value = opt.types[(strip + shift) % types];
+    }
+
+    return count;
+}
+
+/**
+   Compare a batch with one processor per strip for every instruction set (or the one of --isa) and every evaluation
+   mode of --eval but lookup tables. Returns the number of samples out of tolerance.
+ */
+static uint64_t run_verify_batch(const BenchOptions& opt)
+{
+    static const char* const isas[] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+    const int channels = 2;
+    const int strips = VERIFY_BATCH_STRIPS;
+    const int lanes = strips*channels;
+
+    std::vector<int> steps = opt.steps;
+    if (!opt.steps_set) {
+        sat_parse_list("0-100", steps);
+    }
+
+    std::vector<std::vector<float> > in(lanes, std::vector<float>(VERIFY_FRAMES));
+    std::vector<std::vector<float> > ref(lanes, std::vector<float>(VERIFY_FRAMES));
+    std::vector<std::vector<float> > out(lanes, std::vector<float>(VERIFY_FRAMES));
+    std::vector<const float*> inputs(lanes);
+    std::vector<float*> ref_outputs(lanes);
+    std::vector<float*> outputs(lanes);
+
+    std::vector<VerifyTarget> targets;
+
+    for (size_t i = 0; i < sizeof(isas)/sizeof(isas[0]); i++) {
+        if (sat_kernels_isa(isas[i]) == NULL || (opt.isa != "auto" && opt.isa != isas[i])) {
+            continue;
+        }
+        for (size_t e = 0; e < opt.eval.size(); e++) {
+            if (opt.eval[e] == SAT_EVAL_LUT) {
+                continue;
+            }
+
+            VerifyTarget t;
+            t.isa = isas[i];
+            t.eval = opt.eval[e];
+            t.dsp = NULL;
+            t.samples = 0;
+            t.failures = 0;
+            t.max_ulps = 0;
+            t.max_abs = 0.0f;
+
+            for (int signal = 0; signal < VERIFY_SIGNALS; signal++) {
+                SatBatch batch(strips, channels);
+                std::vector<std::unique_ptr<SatProcessor> > dsps(strips);
+                float peak = 1.0f;
+
+                batch.setIsa(isas[i]);
+                batch.setEvaluation(t.eval);
+
+                for (int k = 0; k < strips; k++) {
+                    dsps[k] = std::unique_ptr<SatProcessor>(new SatProcessor(channels));
+                    dsps[k]->setIsa(isas[i]);
+                    dsps[k]->setEvaluation(t.eval);
+                }
+
+                for (int l = 0; l < lanes; l++) {
+                    verify_signal(signal, l, in[l]);
+                    for (int n = 0; n < VERIFY_FRAMES; n++) {
+                        peak = std::fmax(peak, std::fabs(in[l][n]));
+                    }
+                }
+
+                for (int b = 0, pos = 0; pos < VERIFY_FRAMES; b++) {
+                    const int block = verify_batch_blocks[b % (sizeof(verify_batch_blocks)/sizeof(int))];
+                    const int frames = (VERIFY_FRAMES - pos < block) ? VERIFY_FRAMES - pos : block;
+
+                    for (int l = 0; l < lanes; l++) {
+                        inputs[l] = in[l].data() + pos;
+                        ref_outputs[l] = ref[l].data() + pos;
+                        outputs[l] = out[l].data() + pos;
+                    }
+
+                    // The processors take the changes as events, the batch at the start of each part of the block
+                    std::vector<SatParameterEvent> params(strips*VERIFY_BATCH_PARAMS);
+                    std::vector<int> counts(strips);
+                    int split = frames;
+
+                    for (int k = 0; k < strips; k++) {
+                        SatParameterEvent* const p = &params[k*VERIFY_BATCH_PARAMS];
+                        counts[k] = verify_batch_params(k, b, frames, opt, steps, p);
+
+                        // The first block starts from the settings at its start
+                        int first = 0;
+
+                        if (b == 0) {
+                            for (; first < counts[k] && p[first].frame == 0; first++) {
+                                dsps[k]->setParameter(p[first].index, p[first].value);
+                            }
+                            dsps[k]->reset();
+                        }
+                        dsps[k]->process(&inputs[k*channels], &ref_outputs[k*channels], frames, p + first,
+                                         counts[k] - first);
+
+                        for (int i = 0; i < counts[k]; i++) {
+                            if (p[i].frame > 0 && (int)p[i].frame < split) split = p[i].frame;
+                        }
+                    }
+
+                    for (int part = 0, begin = 0; part < 2 && begin < frames; part++) {
+                        const int end = (part == 0) ? split : frames;
+
+                        for (int k = 0; k < strips; k++) {
+                            const SatParameterEvent* const p = &params[k*VERIFY_BATCH_PARAMS];
+
+                            for (int i = 0; i < counts[k]; i++) {
+                                if ((part == 0) == ((int)p[i].frame < split)) {
+                                    batch.setParameter(k, p[i].index, p[i].value);
+                                }
+                            }
+                        }
+                        if (b == 0 && part == 0) {
+                            batch.reset();
+                        }
+
+                        for (int l = 0; l < lanes; l++) {
+                            inputs[l] = in[l].data() + pos + begin;
+                            outputs[l] = out[l].data() + pos + begin;
+                        }
+                        batch.process(inputs.data(), outputs.data(), end - begin);
+                        begin = end;
+                    }
+                    pos += frames;
+                }
+
+                for (int l = 0; l < lanes; l++) {
+                    for (int n = 0; n < VERIFY_FRAMES; n++) {
+                        if (verify_sample(t, ref[l][n], out[l][n], peak*peak, 0.0f)) {
+                            char text[128];
+                            std::snprintf(text, sizeof(text), "strip %d channel %d %s frame %d", l/channels,
+                                          l % channels, verify_signal_names[signal], n);
+                            t.worst = text;
+                        }
+                    }
+                }
+                t.samples += lanes*VERIFY_FRAMES;
+            }
+
+            targets.push_back(t);
+        }
+    }
+
+    uint64_t failures = 0;
+
+    std::printf("\n%-7s %4s %12s %9s %11s %10s  %s\n", "batch", "eval", "samples", "max ulps", "max abs",
+                "failures", "largest difference");
+
+    for (size_t k = 0; k < targets.size(); k++) {
+        const VerifyTarget& t = targets[k];
+
+        std::printf("%-7s %4d %12llu %9u %11.3g %10llu  %s\n", t.isa.c_str(), t.eval, (unsigned long long)t.samples,
+                    t.max_ulps, t.max_abs, (unsigned long long)t.failures, t.worst.c_str());
+        failures += t.failures;
+    }
+
+    return failures;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// Ramp verification
+//
+// DC through a master volume or master mix ramp comes out as a straight
+// line, whatever the curve, since only the gains move. With ADAA on, every
+// type must follow it monotonically and without steps, across the blocks the
+// ramp is processed in.
+//
+// A saturation ramp across the row where types 4 and 5 switch kernels does
+// not move in a straight line, but it must not step either: no increment may
+// be much larger than the mean of their sizes. This runs without ADAA, which
+// steps the coefficients of a ramp every SAT_ADAA_RAMP_STEP samples.
+
+// Ramp length in frames at 48 kHz, and a block size that does not divide it
+#define VERIFY_RAMP_FRAMES 960
+#define VERIFY_RAMP_BLOCK 100
+
+// Largest deviation of a sample-to-sample increment from the mean increment, relative to it
+#define VERIFY_RAMP_DEVIATION 0.01
+
+// Largest increment across a kernel switch, relative to the mean size of the increments
+#define VERIFY_RAMP_SWITCH_STEP 8.0
+
+/**
+   Run DC of both signs through a saturation ramp from one step below to one step above the row where a type of
+   @a opt switches kernels, and check that the output does not step. Prints a row of the ramp table and returns the
+   number of samples out of tolerance.
+ */
+static uint64_t run_verify_switch(const BenchOptions& opt)
+{
+    const uint32_t frames = VERIFY_RAMP_FRAMES + 2*VERIFY_RAMP_BLOCK;
+    std::vector<float> in[2] = { std::vector<float>(frames, 0.5f), std::vector<float>(frames, -0.5f) };
+    std::vector<float> out[2] = { std::vector<float>(frames), std::vector<float>(frames) };
+
+    uint64_t samples = 0;
+    uint64_t errors = 0;
+    double worst = 0.0;
+    std::string where;
+
+    for (size_t ti = 0; ti < opt.types.size(); ti++) {
+        SatCoeffs c;
+        const int first = sat_coeffs_interpolate(opt.types[ti], 0.0f, c);
+        int row = 1;
+
+        while (row < NUM_SATURATION_STEPS && sat_coeffs_interpolate(opt.types[ti], (float)row, c) == first) {
+            row++;
+        }
+        if (row == NUM_SATURATION_STEPS) {
+            continue;
+        }
+
+        SatProcessor dsp(2);
+        dsp.setIsa("scalar");
+        dsp.setSampleRate(48000.0);
+        dsp.setSmoothingTime(VERIFY_RAMP_FRAMES/48.0f);
+        dsp.setType(opt.types[ti]);
+        dsp.setSaturation(row - 1.0f);
+        dsp.setAntialiasing(SAT_ADAA_OFF);
+        dsp.reset();
+
+        const float* inputs[2];
+        float* outputs[2];
+
+        // Settle, then start the ramp with the next block
+        for (int i = 0; i < 2; i++) {
+            for (int ch = 0; ch < 2; ch++) {
+                inputs[ch] = in[ch].data();
+                outputs[ch] = out[ch].data();
+            }
+            dsp.process(inputs, outputs, VERIFY_RAMP_BLOCK);
+        }
+
+        dsp.setSaturation(row + 1.0f);
+
+        for (uint32_t pos = 0; pos < frames; pos += VERIFY_RAMP_BLOCK) {
+            for (int ch = 0; ch < 2; ch++) {
+                inputs[ch] = in[ch].data() + pos;
+                outputs[ch] = out[ch].data() + pos;
+            }
+            dsp.process(inputs, outputs, (frames - pos < VERIFY_RAMP_BLOCK) ? frames - pos : VERIFY_RAMP_BLOCK);
+        }
+
+        for (int ch = 0; ch < 2; ch++) {
+            double sum = 0.0;
+
+            for (uint32_t n = 0; n < VERIFY_RAMP_FRAMES; n++) {
+                sum += std::fabs((double)out[ch][n + 1] - out[ch][n]);
+            }
+
+            const double mean = sum/VERIFY_RAMP_FRAMES;
+
+            for (uint32_t n = 0; n < VERIFY_RAMP_FRAMES; n++) {
+                const double step = std::fabs((double)out[ch][n + 1] - out[ch][n])/mean;
+
+                if (!(step <= VERIFY_RAMP_SWITCH_STEP)) {
+                    errors++;
+                }
+                if (!(step <= worst)) {
+                    char text[64];
+                    std::snprintf(text, sizeof(text), "type %d channel %d frame %u", opt.types[ti], ch, n);
+                    worst = step;
+                    where = text;
+                }
+            }
+            samples += VERIFY_RAMP_FRAMES;
+        }
+    }
+
+    std::printf("%-7s %4d %12llu %11.3g %10llu  %s\n", "switch", SAT_ADAA_OFF, (unsigned long long)samples, worst,
+                (unsigned long long)errors, where.c_str());
+
+    return errors;
+}
+
+/**
+   Run DC through a master volume and a master mix ramp with every type of @a opt and both ADAA orders, and check
+   that the output moves in equal increments, then through saturation ramps, see run_verify_switch(). Returns the
+   number of samples out of tolerance.
+ */
+static uint64_t run_verify_ramp(const BenchOptions& opt)
+{
+    static const char* const names[2] = { "volume", "mix" };
+    const uint32_t frames = VERIFY_RAMP_FRAMES + 2*VERIFY_RAMP_BLOCK;
+    uint64_t failures = 0;
+
+    std::vector<float> in(frames, 0.5f);
+    std::vector<float> out(frames);
+
+    std::printf("\n%-7s %4s %12s %11s %10s  %s\n", "ramp", "adaa", "samples", "max step", "failures",
+                "largest step");
+
+    for (int param = 0; param < 2; param++)
+    for (int order = SAT_ADAA_FIRST_ORDER; order <= SAT_ADAA_SECOND_ORDER; order++) {
+        uint64_t samples = 0;
+        uint64_t errors = 0;
+        double worst = 0.0;
+        std::string where;
+
+        for (size_t ti = 0; ti < opt.types.size(); ti++) {
+            SatProcessor dsp(1);
+            dsp.setIsa("scalar");
+            dsp.setSampleRate(48000.0);
+            dsp.setSmoothingTime(VERIFY_RAMP_FRAMES/48.0f);
+            dsp.setType(opt.types[ti]);
+            dsp.setSaturation(50.0f);
+            dsp.setAntialiasing(order);
+            dsp.setMasterVolume(-12.0f);
+            dsp.setMasterMix(50.0f);
+            dsp.reset();
+
+            // Settle the ADAA history, then start the ramp with the next block
+            for (int i = 0; i < 2; i++) {
+                const float* input = in.data();
+                float* output = out.data();
+                dsp.process(&input, &output, VERIFY_RAMP_BLOCK);
+            }
+
+            if (param == 0) {
+                dsp.setMasterVolume(0.0f);
+            }
+            else {
+                dsp.setMasterMix(100.0f);
+            }
+
+            for (uint32_t pos = 0; pos < frames; pos += VERIFY_RAMP_BLOCK) {
+                const float* input = in.data() + pos;
+                float* output = out.data() + pos;
+                dsp.process(&input, &output, (frames - pos < VERIFY_RAMP_BLOCK) ? frames - pos : VERIFY_RAMP_BLOCK);
+            }
+
+            // The ramp starts from the value before it, and reaches its target one frame after its last frame
+            const double mean = ((double)out[VERIFY_RAMP_FRAMES] - out[0])/VERIFY_RAMP_FRAMES;
+
+            for (uint32_t n = 0; n < VERIFY_RAMP_FRAMES; n++) {
+                const double step = (double)out[n + 1] - out[n];
+                const double deviation = std::fabs(step - mean)/std::fabs(mean);
+
+                if (!(step*mean > 0.0) || !(deviation <= VERIFY_RAMP_DEVIATION)) {
+                    errors++;
+                }
+                if (!(deviation <= worst)) {
+                    char text[64];
+                    std::snprintf(text, sizeof(text), "type %d frame %u", opt.types[ti], n);
+                    worst = deviation;
+                    where = text;
+                }
+            }
+            samples += VERIFY_RAMP_FRAMES;
+        }
+
+        std::printf("%-7s %4d %12llu %11.3g %10llu  %s\n", names[param], order, (unsigned long long)samples, worst,
+                    (unsigned long long)errors, where.c_str());
+        failures += errors;
+    }
+
+    return failures + run_verify_switch(opt);
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    BenchOptions opt;
+    sat_parse_list("0-5", opt.types);
+    sat_parse_list("0,50,100", opt.steps);
+    sat_parse_list("16,32,64,128,256,512,1024,2048,4096,8192", opt.blocks);
+    sat_parse_list("1,2", opt.channels);
+    sat_parse_list("1", opt.oversampling);
+    sat_parse_list("0", opt.adaa);
+    sat_parse_list("0", opt.eval);
+    opt.isa = "auto";
+    opt.min_time = 0.02;
+    opt.automate = false;
+    opt.events = 0;
+    opt.strips = 1;
+    opt.batch = false;
+    opt.json = false;
+    opt.verify = false;
+    opt.steps_set = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool ok = true;
+
+        if (std::strcmp(arg, "--json") == 0) {
+            opt.json = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--verify") == 0) {
+            opt.verify = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--automate") == 0) {
+            opt.automate = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--batch") == 0) {
+            opt.batch = true;
+            continue;
+        }
+        if (value == NULL) {
+            usage();
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--types") == 0) ok = sat_parse_list(value, opt.types);
+        else if (std::strcmp(arg, "--steps") == 0) ok = opt.steps_set = sat_parse_list(value, opt.steps);
+        else if (std::strcmp(arg, "--blocks") == 0) ok = sat_parse_list(value, opt.blocks);
+        else if (std::strcmp(arg, "--channels") == 0) ok = sat_parse_list(value, opt.channels);
+        else if (std::strcmp(arg, "--oversampling") == 0) ok = sat_parse_list(value, opt.oversampling);
+        else if (std::strcmp(arg, "--adaa") == 0) ok = sat_parse_list(value, opt.adaa);
+        else if (std::strcmp(arg, "--eval") == 0) ok = sat_parse_list(value, opt.eval);
+        else if (std::strcmp(arg, "--isa") == 0) opt.isa = value;
+        else if (std::strcmp(arg, "--label") == 0) opt.label = value;
+        else if (std::strcmp(arg, "--min-time") == 0) opt.min_time = std::atof(value);
+        else if (std::strcmp(arg, "--events") == 0) opt.events = std::atoi(value);
+        else if (std::strcmp(arg, "--strips") == 0) opt.strips = std::atoi(value);
+        else ok = false;
+
+        if (!ok) {
+            usage();
+            return 1;
+        }
+        i++;
+    }
+
+    for (size_t i = 0; i < opt.types.size(); i++) {
+        if (opt.types[i] < 0 || opt.types[i] >= NUM_SATURATIONS) {
+            std::fprintf(stderr, "maetning-bench: type %d out of range\n", opt.types[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.steps.size(); i++) {
+        if (opt.steps[i] < 0 || opt.steps[i] >= NUM_SATURATION_STEPS) {
+            std::fprintf(stderr, "maetning-bench: step %d out of range\n", opt.steps[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.blocks.size(); i++) {
+        if (opt.blocks[i] < 1) {
+            std::fprintf(stderr, "maetning-bench: block size %d out of range\n", opt.blocks[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.channels.size(); i++) {
+        if (opt.channels[i] < 1) {
+            std::fprintf(stderr, "maetning-bench: channel count %d out of range\n", opt.channels[i]);
+            return 1;
+        }
+    }
+
+    if (opt.events < 0) {
+        std::fprintf(stderr, "maetning-bench: event count %d out of range\n", opt.events);
+        return 1;
+    }
+    if (opt.strips < 1) {
+        std::fprintf(stderr, "maetning-bench: strip count %d out of range\n", opt.strips);
+        return 1;
+    }
+
+    for (size_t i = 0; i < opt.oversampling.size(); i++) {
+        const int os = opt.oversampling[i];
+        if (os != 1 && os != 2 && os != 4 && os != 8) {
+            std::fprintf(stderr, "maetning-bench: oversampling factor %d is not 1, 2, 4 or 8\n", os);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.adaa.size(); i++) {
+        if (opt.adaa[i] < SAT_ADAA_OFF || opt.adaa[i] > SAT_ADAA_SECOND_ORDER) {
+            std::fprintf(stderr, "maetning-bench: ADAA order %d is not 0, 1 or 2\n", opt.adaa[i]);
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < opt.eval.size(); i++) {
+        if (opt.eval[i] < SAT_EVAL_EXACT || opt.eval[i] > SAT_EVAL_APPROX) {
+            std::fprintf(stderr, "maetning-bench: evaluation mode %d is not 0, 1 or 2\n", opt.eval[i]);
+            return 1;
+        }
+    }
+
+    const char* isa = NULL;
+    sat_kernels_detect(&isa);
+
+    if (opt.isa != "auto") {
+        if (sat_kernels_isa(opt.isa.c_str()) == NULL) {
+            std::fprintf(stderr, "maetning-bench: instruction set '%s' is not available\n", opt.isa.c_str());
+            return 1;
+        }
+        isa = opt.isa.c_str();
+    }
+
+    if (opt.verify) {
+        uint64_t failures = run_verify(opt);
+        failures += run_verify_batch(opt);
+        failures += run_verify_ramp(opt);
+        return (failures == 0) ? 0 : 1;
+    }
+
+    // Batches only have the plain signal chain
+    if (opt.batch) {
+        if (opt.events > 0) {
+            std::fprintf(stderr, "maetning-bench: --batch takes no --events\n");
+            return 1;
+        }
+        for (size_t i = 0; i < opt.oversampling.size(); i++) {
+            if (opt.oversampling[i] != 1) {
+                std::fprintf(stderr, "maetning-bench: --batch only runs oversampling factor 1\n");
+                return 1;
+            }
+        }
+        for (size_t i = 0; i < opt.adaa.size(); i++) {
+            if (opt.adaa[i] != SAT_ADAA_OFF) {
+                std::fprintf(stderr, "maetning-bench: --batch only runs ADAA order 0\n");
+                return 1;
+            }
+        }
+        for (size_t i = 0; i < opt.eval.size(); i++) {
+            if (opt.eval[i] == SAT_EVAL_LUT) {
+                std::fprintf(stderr, "maetning-bench: --batch has no lookup tables, evaluation mode 1\n");
+                return 1;
+            }
+        }
+    }
+
+    std::vector<BenchResult> results;
+
+    for (size_t t = 0; t < opt.types.size(); t++) {
+        for (size_t s = 0; s < opt.steps.size(); s++) {
+            for (size_t b = 0; b < opt.blocks.size(); b++) {
+                for (size_t c = 0; c < opt.channels.size(); c++) {
+                    for (size_t o = 0; o < opt.oversampling.size(); o++) {
+                        for (size_t a = 0; a < opt.adaa.size(); a++) {
+                            for (size_t e = 0; e < opt.eval.size(); e++) {
+                                if (opt.batch) {
+                                    results.push_back(run_batch_case(opt, opt.types[t], opt.steps[s], opt.blocks[b],
+                                                                     opt.channels[c], opt.eval[e]));
+                                    continue;
+                                }
+                                results.push_back(run_case(opt, opt.types[t], opt.steps[s], opt.blocks[b],
+                                                           opt.channels[c], opt.oversampling[o], opt.adaa[a],
+                                                           opt.eval[e]));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (opt.json) {
+        print_json(results, isa, opt.automate, opt.events, opt.batch, opt.label);
+    }
+    else {
+        print_table(results, isa, opt.automate, opt.events, opt.batch);
+    }
+
+    return 0;
+}
@@ -0,0 +1,1129 @@
+/*
+ * maetning-host
+ *
+ * Headless stand-in host for the built plugin binaries. It loads the LADSPA
+ * binary and the LV2 bundle like a DAW does, streams noise through them in
+ * blocks while a parameter is automated, and times them against SatProcessor
+ * driven the same way, so the cost of the format wrappers can be measured
+ * without a DAW. For each block size it reports ns/sample and ns per call of
+ * the plugin and of the core, and the difference per call, which is what the
+ * wrapper and the host interface add.
+ *
+ * Before timing, the plugin and the core process the same signal with the
+ * same settings, and the largest difference of their outputs is reported, so
+ * a binary that does not match the core (or a misconnected port) shows up.
+ *
+ * Usage: maetning-host [options]
+ *   --ladspa FILE       LADSPA binary to load, e.g. bin/maetning-ladspa.so
+ *   --lv2 BUNDLE        LV2 bundle to load, e.g. bin/maetning.lv2
+ *   --blocks LIST       block sizes in frames (default 32,64,256,1024,4096)
+ *   --rate HZ           sample rate (default 48000)
+ *   --set NAME=VALUE    set a control input, by name or symbol, e.g. Type=4 (may be repeated)
+ *   --automate NAME     control input moved through its range once per second, or none (default Saturation)
+ *   --min-time SEC      minimum measuring time per case, of the plugin and the core each (default 0.2)
+ *   --label TEXT        free text stored in the report, e.g. a commit id
+ *   --json              write a JSON report instead of a table
+ *
+ * Without --ladspa and --lv2, bin/maetning-ladspa.so and bin/maetning.lv2
+ * are loaded. A LIST is comma separated, and each item is a number N, a range
+ * A-B or a range with a stride A-B:S.
+ *
+ * Only what the plugin needs is implemented: LV2 plugins get the urid:map,
+ * urid:unmap, options and boundedBlockLength features, and atom ports get an
+ * empty sequence. The port list of an LV2 plugin is read from the Turtle files
+ * of its bundle with a plain text scan, which is enough for the files that DPF
+ * generates, but is not a Turtle parser.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+#include <strings.h>
+
+#include "ladspa/ladspa.h"
+#include "lv2/lv2.h"
+#include "lv2/atom.h"
+#include "lv2/buf-size.h"
+#include "lv2/options.h"
+#include "lv2/parameters.h"
+#include "lv2/urid.h"
+
+#include "options.h"
+#include "processor.h"
+
+// -----------------------------------------------------------------------------------------------------------
+
+// Size of the atom port buffers in bytes
+#define HOST_ATOM_CAPACITY 8192
+
+// Blocks processed by the plugin and the core before comparing their outputs
+#define HOST_CHECK_BLOCKS 64
+#define HOST_CHECK_FRAMES 64
+
+// Calls timed at a time, alternating between the plugin and the core
+#define HOST_BATCH 32
+
+// Parameter names of the plugin, in the order of SAT_PARAM_*
+static const char* const host_core_params[NUM_SAT_PARAMS] = {
+    "Saturation", "Type", "MasterVolume", "MasterMix", "Oversampling", "Antialiasing",
+    "Bands", "Crossover1", "Crossover2", "Crossover3",
+    "Saturation2", "Type2", "Saturation3", "Type3", "Saturation4", "Type4",
+};
+
+enum
+{
+    HOST_PORT_AUDIO,
+    HOST_PORT_CONTROL,
+    HOST_PORT_CV,
+    HOST_PORT_ATOM
+};
+
+struct HostPort
+{
+    std::string name;
+    std::string symbol;
+    int kind;
+    bool output;
+    float min;
+    float max;
+    float def;
+};
+
+struct HostOptions
+{
+    std::string ladspa;
+    std::string lv2;
+    std::vector<int> blocks;
+    std::vector<std::string> set;
+    std::string automate;
+    std::string label;
+    int rate;
+    double min_time;
+    bool json;
+};
+
+struct HostResult
+{
+    std::string format;
+    int block;
+    int channels;
+    uint64_t plugin_calls;
+    double plugin_seconds;
+    uint64_t core_calls;
+    double core_seconds;
+};
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "usage: maetning-host [--ladspa FILE] [--lv2 BUNDLE] [--blocks LIST] [--rate HZ]\n"
+                 "                     [--set NAME=VALUE]... [--automate NAME] [--min-time SEC] [--label TEXT]\n"
+                 "                     [--json]\n");
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// Plugins
+
+/**
+   A loaded and instantiated plugin. The host connects the audio, CV and control ports, the plugin connects the
+   ports that only the format knows about, like atom ports.
+ */
+class HostPlugin
+{
+public:
+    virtual ~HostPlugin() {}
+
+    virtual const char* getFormat() const = 0;
+    virtual void connect(uint32_t port, float* data) = 0;
+    virtual void activate() = 0;
+    virtual void run(uint32_t frames) = 0;
+
+    const std::vector<HostPort>& getPorts() const
+    {
+        return ports;
+    }
+
+protected:
+    std::vector<HostPort> ports;
+};
+
+class LadspaPlugin : public HostPlugin
+{
+public:
+    LadspaPlugin()
+        : lib(NULL),
+          descriptor(NULL),
+          handle(NULL),
+          active(false)
+    {
+    }
+
+    ~LadspaPlugin() override
+    {
+        if (active && descriptor->deactivate != NULL) {
+            descriptor->deactivate(handle);
+        }
+        if (handle != NULL) {
+            descriptor->cleanup(handle);
+        }
+        if (lib != NULL) {
+            dlclose(lib);
+        }
+    }
+
+    /**
+       Load the first plugin of the binary at @a path. Prints the reason and returns false if it fails.
+     */
+    bool load(const std::string& path, uint32_t rate)
+    {
+        lib = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (lib == NULL) {
+            std::fprintf(stderr, "maetning-host: %s\n", dlerror());
+            return false;
+        }
+
+        const LADSPA_Descriptor_Function get = (LADSPA_Descriptor_Function)dlsym(lib, "ladspa_descriptor");
+        descriptor = (get != NULL) ? get(0) : NULL;
+        if (descriptor == NULL) {
+            std::fprintf(stderr, "maetning-host: %s has no LADSPA plugin\n", path.c_str());
+            return false;
+        }
+
+        for (unsigned long i = 0; i < descriptor->PortCount; i++) {
+            const LADSPA_PortDescriptor d = descriptor->PortDescriptors[i];
+            const LADSPA_PortRangeHint& hint = descriptor->PortRangeHints[i];
+
+            HostPort port;
+            port.name = descriptor->PortNames[i];
+            port.symbol = port.name;
+            port.kind = LADSPA_IS_PORT_AUDIO(d) ? HOST_PORT_AUDIO : HOST_PORT_CONTROL;
+            port.output = LADSPA_IS_PORT_OUTPUT(d);
+            port.min = LADSPA_IS_HINT_BOUNDED_BELOW(hint.HintDescriptor) ? hint.LowerBound : 0.0f;
+            port.max = LADSPA_IS_HINT_BOUNDED_ABOVE(hint.HintDescriptor) ? hint.UpperBound : 1.0f;
+            port.def = ladspa_default(hint.HintDescriptor, port.min, port.max);
+            ports.push_back(port);
+        }
+
+        handle = descriptor->instantiate(descriptor, rate);
+        if (handle == NULL) {
+            std::fprintf(stderr, "maetning-host: cannot instantiate %s\n", path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    const char* getFormat() const override
+    {
+        return "ladspa";
+    }
+
+    void connect(uint32_t port, float* data) override
+    {
+        descriptor->connect_port(handle, port, data);
+    }
+
+    void activate() override
+    {
+        if (descriptor->activate != NULL) {
+            descriptor->activate(handle);
+        }
+        active = true;
+    }
+
+    void run(uint32_t frames) override
+    {
+        descriptor->run(handle, frames);
+    }
+
+private:
+    /**
+       Default value of a control port from its hints, as the LADSPA header defines it.
+     */
+    static float ladspa_default(LADSPA_PortRangeHintDescriptor hint, float min, float max)
+    {
+        const bool log = LADSPA_IS_HINT_LOGARITHMIC(hint) && min > 0.0f && max > 0.0f;
+        float w = 0.0f;
+
+        switch (hint & LADSPA_HINT_DEFAULT_MASK) {
+        case LADSPA_HINT_DEFAULT_MINIMUM: return min;
+        case LADSPA_HINT_DEFAULT_MAXIMUM: return max;
+        case LADSPA_HINT_DEFAULT_0: return 0.0f;
+        case LADSPA_HINT_DEFAULT_1: return 1.0f;
+        case LADSPA_HINT_DEFAULT_100: return 100.0f;
+        case LADSPA_HINT_DEFAULT_440: return 440.0f;
+        case LADSPA_HINT_DEFAULT_LOW: w = 0.25f; break;
+        case LADSPA_HINT_DEFAULT_MIDDLE: w = 0.5f; break;
+        case LADSPA_HINT_DEFAULT_HIGH: w = 0.75f; break;
+        default: return min;
+        }
+
+        return log ? std::exp(std::log(min)*(1.0f - w) + std::log(max)*w) : min*(1.0f - w) + max*w;
+    }
+
+    void* lib;
+    const LADSPA_Descriptor* descriptor;
+    LADSPA_Handle handle;
+    bool active;
+};
+
+class Lv2Plugin : public HostPlugin
+{
+public:
+    Lv2Plugin()
+        : lib(NULL),
+          descriptor(NULL),
+          handle(NULL),
+          active(false)
+    {
+    }
+
+    ~Lv2Plugin() override
+    {
+        if (active && descriptor->deactivate != NULL) {
+            descriptor->deactivate(handle);
+        }
+        if (handle != NULL) {
+            descriptor->cleanup(handle);
+        }
+        if (lib != NULL) {
+            dlclose(lib);
+        }
+    }
+
+    /**
+       Load the first plugin of the bundle at @a path, for blocks of up to @a max_block frames. Prints the reason
+       and returns false if it fails.
+     */
+    bool load(const std::string& path, uint32_t rate, uint32_t max_block)
+    {
+        const std::string bundle = (!path.empty() && path[path.size() - 1] == '/') ? path : path + "/";
+
+        std::string manifest;
+        if (!read_file(bundle + "manifest.ttl", manifest)) {
+            std::fprintf(stderr, "maetning-host: cannot read %smanifest.ttl\n", bundle.c_str());
+            return false;
+        }
+
+        std::vector<std::string> binary;
+        std::vector<std::string> see_also;
+        ttl_uris(manifest, "lv2:binary", binary);
+        ttl_uris(manifest, "rdfs:seeAlso", see_also);
+
+        if (binary.empty()) {
+            std::fprintf(stderr, "maetning-host: %smanifest.ttl names no binary\n", bundle.c_str());
+            return false;
+        }
+
+        // The ports may be described in the manifest or any file it refers to
+        std::string text = manifest;
+        for (size_t i = 0; i < see_also.size(); i++) {
+            std::string more;
+            if (read_file(bundle + see_also[i], more)) {
+                text += more;
+            }
+        }
+
+        if (!ttl_ports(text, ports)) {
+            std::fprintf(stderr, "maetning-host: cannot read the ports from the files of %s\n", bundle.c_str());
+            return false;
+        }
+
+        const std::string library = bundle + binary[0];
+        lib = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (lib == NULL) {
+            std::fprintf(stderr, "maetning-host: %s\n", dlerror());
+            return false;
+        }
+
+        const LV2_Descriptor_Function get = (LV2_Descriptor_Function)dlsym(lib, "lv2_descriptor");
+        descriptor = (get != NULL) ? get(0) : NULL;
+        if (descriptor == NULL) {
+            std::fprintf(stderr, "maetning-host: %s has no LV2 plugin\n", library.c_str());
+            return false;
+        }
+
+        map.handle = &uris;
+        map.map = map_uri;
+        unmap.handle = &uris;
+        unmap.unmap = unmap_uri;
+
+        option_block = (int32_t)max_block;
+        option_rate = (float)rate;
+
+        const LV2_URID atom_int = map_uri(&uris, LV2_ATOM__Int);
+        const LV2_Options_Option list[] = {
+            { LV2_OPTIONS_INSTANCE, 0, map_uri(&uris, LV2_BUF_SIZE__maxBlockLength), sizeof(int32_t), atom_int,
+              &option_block },
+            { LV2_OPTIONS_INSTANCE, 0, map_uri(&uris, LV2_BUF_SIZE__nominalBlockLength), sizeof(int32_t), atom_int,
+              &option_block },
+            { LV2_OPTIONS_INSTANCE, 0, map_uri(&uris, LV2_PARAMETERS__sampleRate), sizeof(float),
+              map_uri(&uris, LV2_ATOM__Float), &option_rate },
+            { LV2_OPTIONS_INSTANCE, 0, 0, 0, 0, NULL },
+        };
+        options.assign(list, list + sizeof(list)/sizeof(list[0]));
+
+        feature_map.URI = LV2_URID__map;
+        feature_map.data = &map;
+        feature_unmap.URI = LV2_URID__unmap;
+        feature_unmap.data = &unmap;
+        feature_options.URI = LV2_OPTIONS__options;
+        feature_options.data = options.data();
+        feature_bounded.URI = LV2_BUF_SIZE__boundedBlockLength;
+        feature_bounded.data = NULL;
+
+        features.push_back(&feature_map);
+        features.push_back(&feature_unmap);
+        features.push_back(&feature_options);
+        features.push_back(&feature_bounded);
+        features.push_back(NULL);
+
+        handle = descriptor->instantiate(descriptor, rate, bundle.c_str(), features.data());
+        if (handle == NULL) {
+            std::fprintf(stderr, "maetning-host: cannot instantiate %s\n", descriptor->URI);
+            return false;
+        }
+
+        // Atom ports get an empty sequence, or room for one
+        atom_sequence = map_uri(&uris, LV2_ATOM__Sequence);
+        atom_chunk = map_uri(&uris, LV2_ATOM__Chunk);
+        atoms.resize(ports.size());
+
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            if (ports[i].kind == HOST_PORT_ATOM) {
+                atoms[i].resize(HOST_ATOM_CAPACITY/sizeof(uint64_t));
+                descriptor->connect_port(handle, i, atoms[i].data());
+            }
+        }
+        prepareAtoms();
+
+        return true;
+    }
+
+    const char* getFormat() const override
+    {
+        return "lv2";
+    }
+
+    void connect(uint32_t port, float* data) override
+    {
+        descriptor->connect_port(handle, port, data);
+    }
+
+    void activate() override
+    {
+        if (descriptor->activate != NULL) {
+            descriptor->activate(handle);
+        }
+        active = true;
+    }
+
+    void run(uint32_t frames) override
+    {
+        prepareAtoms();
+        descriptor->run(handle, frames);
+    }
+
+private:
+    /**
+       Empty the input sequences, and give the outputs the whole buffer, as hosts do before each run.
+     */
+    void prepareAtoms()
+    {
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            if (ports[i].kind != HOST_PORT_ATOM) {
+                continue;
+            }
+
+            LV2_Atom_Sequence* seq = (LV2_Atom_Sequence*)atoms[i].data();
+
+            if (ports[i].output) {
+                seq->atom.size = HOST_ATOM_CAPACITY - sizeof(LV2_Atom);
+                seq->atom.type = atom_chunk;
+            }
+            else {
+                seq->atom.size = sizeof(LV2_Atom_Sequence_Body);
+                seq->atom.type = atom_sequence;
+                seq->body.unit = 0;
+                seq->body.pad = 0;
+            }
+        }
+    }
+
+    static LV2_URID map_uri(LV2_URID_Map_Handle handle, const char* uri)
+    {
+        std::deque<std::string>& uris = *(std::deque<std::string>*)handle;
+
+        for (size_t i = 0; i < uris.size(); i++) {
+            if (uris[i] == uri) {
+                return (LV2_URID)(i + 1);
+            }
+        }
+
+        uris.push_back(uri);
+        return (LV2_URID)uris.size();
+    }
+
+    static const char* unmap_uri(LV2_URID_Unmap_Handle handle, LV2_URID urid)
+    {
+        const std::deque<std::string>& uris = *(const std::deque<std::string>*)handle;
+        return (urid > 0 && urid <= uris.size()) ? uris[urid - 1].c_str() : NULL;
+    }
+
+    static bool read_file(const std::string& path, std::string& text)
+    {
+        std::ifstream file(path.c_str());
+        if (!file) {
+            return false;
+        }
+
+        std::stringstream s;
+        s << file.rdbuf();
+        text = s.str();
+        return true;
+    }
+
+    /**
+       Append the relative URI after every @a predicate in @a text, e.g. the file of "lv2:binary <x.so>".
+     */
+    static void ttl_uris(const std::string& text, const char* predicate, std::vector<std::string>& uris)
+    {
+        for (size_t pos = text.find(predicate); pos != std::string::npos; pos = text.find(predicate, pos + 1)) {
+            const size_t begin = text.find('<', pos);
+            const size_t end = (begin != std::string::npos) ? text.find('>', begin) : std::string::npos;
+
+            if (end != std::string::npos) {
+                uris.push_back(text.substr(begin + 1, end - begin - 1));
+            }
+        }
+    }
+
+    /**
+       The value after @a predicate in @a block, a number or a quoted string.
+     */
+    static bool ttl_value(const std::string& block, const char* predicate, std::string& value)
+    {
+        const size_t pos = block.find(predicate);
+        if (pos == std::string::npos) {
+            return false;
+        }
+
+        size_t begin = pos + std::strlen(predicate);
+        while (begin < block.size() && std::isspace((unsigned char)block[begin])) {
+            begin++;
+        }
+
+        if (begin < block.size() && block[begin] == '"') {
+            const size_t end = block.find('"', begin + 1);
+            value = block.substr(begin + 1, end - begin - 1);
+            return end != std::string::npos;
+        }
+
+        size_t end = begin;
+        while (end < block.size() && !std::isspace((unsigned char)block[end]) && block[end] != ';') {
+            end++;
+        }
+        value = block.substr(begin, end - begin);
+        return end > begin;
+    }
+
+    /**
+       Read the ports from the "lv2:port [ ... ]" blocks in @a text. Every index must be described once.
+     */
+    static bool ttl_ports(const std::string& text, std::vector<HostPort>& ports)
+    {
+        std::vector<bool> found;
+
+        for (size_t pos = text.find("lv2:index"); pos != std::string::npos; pos = text.find("lv2:index", pos + 1)) {
+            // The block around the index, skipping nested blocks such as scale points
+            size_t begin = pos;
+            for (int depth = 0; begin > 0; begin--) {
+                if (text[begin - 1] == ']') depth++;
+                if (text[begin - 1] == '[' && depth-- == 0) break;
+            }
+            size_t end = pos;
+            for (int depth = 0; end < text.size(); end++) {
+                if (text[end] == '[') depth++;
+                if (text[end] == ']' && depth-- == 0) break;
+            }
+            const std::string block = text.substr(begin, end - begin);
+
+            std::string value;
+            HostPort port;
+
+            ttl_value(block, "lv2:index", value);
+            const uint32_t index = (uint32_t)std::strtoul(value.c_str(), NULL, 10);
+
+            port.kind = (block.find("lv2:AudioPort") != std::string::npos) ? HOST_PORT_AUDIO
+                      : (block.find("lv2:ControlPort") != std::string::npos) ? HOST_PORT_CONTROL
+                      : (block.find("lv2:CVPort") != std::string::npos) ? HOST_PORT_CV
+                      : HOST_PORT_ATOM;
+            port.output = block.find("lv2:OutputPort") != std::string::npos;
+            port.symbol = ttl_value(block, "lv2:symbol", value) ? value : "";
+            port.name = ttl_value(block, "lv2:name", value) ? value : port.symbol;
+            port.def = ttl_value(block, "lv2:default", value) ? std::strtof(value.c_str(), NULL) : 0.0f;
+            port.min = ttl_value(block, "lv2:minimum", value) ? std::strtof(value.c_str(), NULL) : 0.0f;
+            port.max = ttl_value(block, "lv2:maximum", value) ? std::strtof(value.c_str(), NULL) : 1.0f;
+
+            if (index >= 4096) {
+                return false;
+            }
+            if (index >= ports.size()) {
+                ports.resize(index + 1);
+                found.resize(index + 1, false);
+            }
+            if (found[index]) {
+                return false;
+            }
+
+            ports[index] = port;
+            found[index] = true;
+        }
+
+        for (size_t i = 0; i < found.size(); i++) {
+            if (!found[i]) {
+                return false;
+            }
+        }
+
+        return !ports.empty();
+    }
+
+    void* lib;
+    const LV2_Descriptor* descriptor;
+    LV2_Handle handle;
+    bool active;
+
+    std::deque<std::string> uris;
+    LV2_URID_Map map;
+    LV2_URID_Unmap unmap;
+    int32_t option_block;
+    float option_rate;
+    std::vector<LV2_Options_Option> options;
+    LV2_Feature feature_map;
+    LV2_Feature feature_unmap;
+    LV2_Feature feature_options;
+    LV2_Feature feature_bounded;
+    std::vector<const LV2_Feature*> features;
+
+    LV2_URID atom_sequence;
+    LV2_URID atom_chunk;
+    std::vector<std::vector<uint64_t> > atoms;
+};
+
+// -----------------------------------------------------------------------------------------------------------
+// Host
+
+/**
+   The buffers of a plugin and a core processor with the same settings, and the calls that time them.
+ */
+class HostSession
+{
+public:
+    HostSession(HostPlugin& plugin, const HostOptions& opt, uint32_t max_block)
+        : plugin(plugin),
+          opt(opt),
+          channels(0),
+          automated(-1),
+          ok(true)
+    {
+        const std::vector<HostPort>& ports = plugin.getPorts();
+
+        controls.resize(ports.size(), 0.0f);
+
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            const HostPort& p = ports[i];
+
+            if (p.kind == HOST_PORT_CONTROL) {
+                controls[i] = p.def;
+                plugin.connect(i, &controls[i]);
+            }
+            else if (p.kind == HOST_PORT_AUDIO || p.kind == HOST_PORT_CV) {
+                buffers.push_back(std::vector<float>(max_block, 0.0f));
+                plugin.connect(i, buffers.back().data());
+
+                if (p.kind == HOST_PORT_AUDIO && !p.output) {
+                    audio_in.push_back(buffers.size() - 1);
+                }
+                if (p.kind == HOST_PORT_AUDIO && p.output) {
+                    audio_out.push_back(buffers.size() - 1);
+                }
+            }
+        }
+
+        channels = (int)audio_in.size();
+        if (channels == 0 || audio_out.size() != audio_in.size()) {
+            std::fprintf(stderr, "maetning-host: %s plugin has %u inputs and %u outputs, expected the same number\n",
+                         plugin.getFormat(), (uint32_t)audio_in.size(), (uint32_t)audio_out.size());
+            ok = false;
+            return;
+        }
+
+        // The plugin's parameters in the core, by name
+        core_index.resize(ports.size(), -1);
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            for (int k = 0; k < NUM_SAT_PARAMS; k++) {
+                if (ports[i].kind == HOST_PORT_CONTROL && !ports[i].output && matches(ports[i], host_core_params[k])) {
+                    core_index[i] = k;
+                }
+            }
+        }
+
+        for (size_t s = 0; s < opt.set.size(); s++) {
+            const size_t eq = opt.set[s].find('=');
+            const int port = (eq != std::string::npos) ? find(opt.set[s].substr(0, eq)) : -1;
+
+            if (port < 0) {
+                std::fprintf(stderr, "maetning-host: %s plugin has no control input for --set %s\n",
+                             plugin.getFormat(), opt.set[s].c_str());
+                ok = false;
+                return;
+            }
+            controls[port] = std::strtof(opt.set[s].c_str() + eq + 1, NULL);
+        }
+
+        if (opt.automate != "none") {
+            automated = find(opt.automate);
+
+            if (automated < 0) {
+                std::fprintf(stderr, "maetning-host: %s plugin has no control input %s to automate\n",
+                             plugin.getFormat(), opt.automate.c_str());
+                ok = false;
+                return;
+            }
+        }
+
+        // Noise slightly above full scale, so every knee of the curves is hit
+        uint32_t seed = 22222;
+        noise.resize(channels, std::vector<float>(max_block));
+        for (int ch = 0; ch < channels; ch++) {
+            for (uint32_t n = 0; n < max_block; n++) {
+                seed = seed*1664525 + 1013904223;
+                noise[ch][n] = 1.5f*((seed >> 8)*(2.0f/16777216.0f) - 1.0f);
+            }
+            std::memcpy(buffers[audio_in[ch]].data(), noise[ch].data(), max_block*sizeof(float));
+        }
+
+        plugin.activate();
+    }
+
+    bool isOk() const
+    {
+        return ok;
+    }
+
+    int getChannels() const
+    {
+        return channels;
+    }
+
+    /**
+       Process the same blocks with the plugin and a new core, and return the largest difference of the outputs.
+     */
+    float compare()
+    {
+        SatProcessor dsp(channels);
+        setupCore(dsp);
+
+        std::vector<std::vector<float> > core_out(channels, std::vector<float>(HOST_CHECK_FRAMES));
+        std::vector<const float*> inputs(channels);
+        std::vector<float*> outputs(channels);
+
+        for (int ch = 0; ch < channels; ch++) {
+            inputs[ch] = noise[ch].data();
+            outputs[ch] = core_out[ch].data();
+        }
+
+        float diff = 0.0f;
+
+        for (int i = 0; i < HOST_CHECK_BLOCKS; i++) {
+            plugin.run(HOST_CHECK_FRAMES);
+            dsp.process(inputs.data(), outputs.data(), HOST_CHECK_FRAMES);
+
+            for (int ch = 0; ch < channels; ch++) {
+                const std::vector<float>& out = buffers[audio_out[ch]];
+
+                for (int n = 0; n < HOST_CHECK_FRAMES; n++) {
+                    diff = std::max(diff, std::abs(out[n] - core_out[ch][n]));
+                }
+            }
+        }
+
+        return diff;
+    }
+
+    /**
+       Time the plugin and a core at block size @a block.
+     */
+    HostResult run(int block)
+    {
+        HostResult r;
+        r.format = plugin.getFormat();
+        r.block = block;
+        r.channels = channels;
+
+        // The core gets the value the way the plugin passes it on
+        SatProcessor dsp(channels);
+        setupCore(dsp);
+
+        std::vector<std::vector<float> > core_out(channels, std::vector<float>(block));
+        std::vector<const float*> inputs(channels);
+        std::vector<float*> outputs(channels);
+
+        for (int ch = 0; ch < channels; ch++) {
+            inputs[ch] = noise[ch].data();
+            outputs[ch] = core_out[ch].data();
+        }
+
+        // Like a host: the new control value is written to the port, and the plugin picks it up in run()
+        const int port = automated;
+        float* const control = (port >= 0) ? &controls[port] : NULL;
+        const int index = (port >= 0) ? core_index[port] : -1;
+        Automation plugin_automation = automation(block);
+        Automation core_automation = automation(block);
+
+        const auto plugin_call = [&]() {
+            if (control != NULL) {
+                *control = plugin_automation.next();
+            }
+            plugin.run(block);
+        };
+        const auto core_call = [&]() {
+            if (index >= 0) {
+                dsp.setParameter(index, core_automation.next());
+            }
+            dsp.process(inputs.data(), outputs.data(), block);
+        };
+
+        // Warm up caches and branch predictors
+        for (int i = 0; i < 16; i++) {
+            plugin_call();
+            core_call();
+        }
+
+        // Alternate between short batches of both, so they see the same load and clock speed of the machine
+        r.plugin_seconds = 0.0;
+        r.core_seconds = 0.0;
+        r.plugin_calls = 0;
+        r.core_calls = 0;
+
+        while (r.plugin_seconds + r.core_seconds < 2.0*opt.min_time) {
+            r.plugin_seconds += measure(plugin_call);
+            r.core_seconds += measure(core_call);
+            r.plugin_calls += HOST_BATCH;
+            r.core_calls += HOST_BATCH;
+        }
+
+        return r;
+    }
+
+private:
+    /**
+       A triangle through the range of the automated port, once per second.
+     */
+    struct Automation
+    {
+        float min;
+        float max;
+        double step;
+        double phase;
+
+        float next()
+        {
+            phase += step;
+            phase -= (phase >= 2.0) ? 2.0 : 0.0;
+            return min + (max - min)*(float)((phase < 1.0) ? phase : 2.0 - phase);
+        }
+    };
+
+    Automation automation(int block) const
+    {
+        Automation a;
+        a.min = (automated >= 0) ? plugin.getPorts()[automated].min : 0.0f;
+        a.max = (automated >= 0) ? plugin.getPorts()[automated].max : 0.0f;
+        a.step = 2.0*block/opt.rate;
+        a.phase = 0.0;
+        return a;
+    }
+
+    /**
+       Time HOST_BATCH calls of @a process, in seconds.
+     */
+    template <typename F>
+    static double measure(const F& process)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const Clock::time_point start = Clock::now();
+
+        for (int i = 0; i < HOST_BATCH; i++) {
+            process();
+        }
+
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+       Give @a dsp the defaults of the plugin's ports, as a new plugin has, and then the host's values.
+     */
+    void setupCore(SatProcessor& dsp) const
+    {
+        const std::vector<HostPort>& ports = plugin.getPorts();
+
+        dsp.setSampleRate(opt.rate);
+
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            if (core_index[i] >= 0) {
+                dsp.setParameter(core_index[i], ports[i].def);
+            }
+        }
+
+        dsp.reset();
+
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            if (core_index[i] >= 0) {
+                dsp.setParameter(core_index[i], controls[i]);
+            }
+        }
+    }
+
+    static bool matches(const HostPort& port, const std::string& name)
+    {
+        return strcasecmp(port.name.c_str(), name.c_str()) == 0 || strcasecmp(port.symbol.c_str(), name.c_str()) == 0;
+    }
+
+    /**
+       The control input called @a name, or -1.
+     */
+    int find(const std::string& name) const
+    {
+        const std::vector<HostPort>& ports = plugin.getPorts();
+
+        for (uint32_t i = 0; i < ports.size(); i++) {
+            if (ports[i].kind == HOST_PORT_CONTROL && !ports[i].output && matches(ports[i], name)) {
+                return (int)i;
+            }
+        }
+
+        return -1;
+    }
+
+    HostPlugin& plugin;
+    const HostOptions& opt;
+
+    int channels;
+    int automated;
+    bool ok;
+
+    std::vector<float> controls;
+    std::vector<std::vector<float> > buffers;
+    std::vector<size_t> audio_in;
+    std::vector<size_t> audio_out;
+    std::vector<int> core_index;
+    std::vector<std::vector<float> > noise;
+};
+
+// -----------------------------------------------------------------------------------------------------------
+
+static void print_table(const std::vector<HostResult>& results, const HostOptions& opt,
+                        const std::vector<std::string>& checks)
+{
+    std::printf("# rate: %d, automated: %s\n", opt.rate, opt.automate.c_str());
+    for (size_t i = 0; i < checks.size(); i++) {
+        std::printf("# %s\n", checks[i].c_str());
+    }
+    std::printf("%-6s %6s %3s %14s %12s %14s %12s %14s %10s\n", "format", "block", "ch", "plugin ns/smp",
+                "core ns/smp", "plugin ns/call", "core ns/call", "overhead ns/call", "overhead");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const HostResult& r = results[i];
+        const double samples = (double)r.block*r.channels;
+        const double plugin_call = 1e9*r.plugin_seconds/r.plugin_calls;
+        const double core_call = 1e9*r.core_seconds/r.core_calls;
+
+        std::printf("%-6s %6d %3d %14.4f %12.4f %14.1f %12.1f %16.1f %9.1f%%\n", r.format.c_str(), r.block,
+                    r.channels, plugin_call/samples, core_call/samples, plugin_call, core_call, plugin_call - core_call,
+                    100.0*(plugin_call - core_call)/core_call);
+    }
+}
+
+static void print_string(const std::string& s)
+{
+    std::printf("\"");
+    for (size_t i = 0; i < s.size(); i++) {
+        const char c = s[i];
+        if (c == '"' || c == '\\') {
+            std::printf("\\%c", c);
+        }
+        else if ((unsigned char)c >= 0x20) {
+            std::printf("%c", c);
+        }
+    }
+    std::printf("\"");
+}
+
+static void print_json(const std::vector<HostResult>& results, const HostOptions& opt,
+                       const std::vector<std::string>& formats, const std::vector<float>& diffs)
+{
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"maetning-host\",\n");
+    std::printf("  \"label\": ");
+    print_string(opt.label);
+    std::printf(",\n");
+    std::printf("  \"sample_rate\": %d,\n", opt.rate);
+    std::printf("  \"automated\": ");
+    print_string(opt.automate);
+    std::printf(",\n");
+    std::printf("  \"max_difference\": {");
+    for (size_t i = 0; i < formats.size(); i++) {
+        std::printf("\"%s\": %.6g%s", formats[i].c_str(), diffs[i], (i + 1 < formats.size()) ? ", " : "");
+    }
+    std::printf("},\n");
+    std::printf("  \"results\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const HostResult& r = results[i];
+        const double plugin_call = 1e9*r.plugin_seconds/r.plugin_calls;
+        const double core_call = 1e9*r.core_seconds/r.core_calls;
+
+        std::printf("    {\"format\": \"%s\", \"block_size\": %d, \"channels\": %d, \"plugin_calls\": %llu, "
+                    "\"plugin_seconds\": %.6f, \"core_calls\": %llu, \"core_seconds\": %.6f, "
+                    "\"plugin_ns_per_call\": %.1f, \"core_ns_per_call\": %.1f, \"overhead_ns_per_call\": %.1f}%s\n",
+                    r.format.c_str(), r.block, r.channels, (unsigned long long)r.plugin_calls, r.plugin_seconds,
+                    (unsigned long long)r.core_calls, r.core_seconds, plugin_call, core_call, plugin_call - core_call,
+                    (i + 1 < results.size()) ? "," : "");
+    }
+
+    std::printf("  ]\n");
+    std::printf("}\n");
+}
+
+/**
+   Compare @a plugin with the core and time it at every block size. Returns false if the plugin cannot be used.
+ */
+static bool run_plugin(HostPlugin& plugin, const HostOptions& opt, uint32_t max_block,
+                       std::vector<HostResult>& results, std::vector<std::string>& checks,
+                       std::vector<std::string>& formats, std::vector<float>& diffs)
+{
+    HostSession session(plugin, opt, max_block);
+
+    if (!session.isOk()) {
+        return false;
+    }
+
+    const float diff = session.compare();
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "%s: %d channels, largest difference to the core %.3g", plugin.getFormat(),
+                  session.getChannels(), diff);
+    checks.push_back(line);
+    formats.push_back(plugin.getFormat());
+    diffs.push_back(diff);
+
+    for (size_t b = 0; b < opt.blocks.size(); b++) {
+        results.push_back(session.run(opt.blocks[b]));
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    HostOptions opt;
+    sat_parse_list("32,64,256,1024,4096", opt.blocks);
+    opt.automate = "Saturation";
+    opt.rate = 48000;
+    opt.min_time = 0.2;
+    opt.json = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool ok = true;
+
+        if (std::strcmp(arg, "--json") == 0) {
+            opt.json = true;
+            continue;
+        }
+        if (value == NULL) {
+            usage();
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--ladspa") == 0) opt.ladspa = value;
+        else if (std::strcmp(arg, "--lv2") == 0) opt.lv2 = value;
+        else if (std::strcmp(arg, "--blocks") == 0) ok = sat_parse_list(value, opt.blocks);
+        else if (std::strcmp(arg, "--rate") == 0) opt.rate = std::atoi(value);
+        else if (std::strcmp(arg, "--set") == 0) opt.set.push_back(value);
+        else if (std::strcmp(arg, "--automate") == 0) opt.automate = value;
+        else if (std::strcmp(arg, "--min-time") == 0) opt.min_time = std::atof(value);
+        else if (std::strcmp(arg, "--label") == 0) opt.label = value;
+        else ok = false;
+
+        if (!ok) {
+            usage();
+            return 1;
+        }
+        i++;
+    }
+
+    if (opt.ladspa.empty() && opt.lv2.empty()) {
+        opt.ladspa = "bin/maetning-ladspa.so";
+        opt.lv2 = "bin/maetning.lv2";
+    }
+
+    uint32_t max_block = 0;
+    for (size_t i = 0; i < opt.blocks.size(); i++) {
+        if (opt.blocks[i] < 1) {
+            std::fprintf(stderr, "maetning-host: block size %d out of range\n", opt.blocks[i]);
+            return 1;
+        }
+        max_block = std::max(max_block, (uint32_t)opt.blocks[i]);
+    }
+    max_block = std::max(max_block, (uint32_t)HOST_CHECK_FRAMES);
+
+    if (opt.rate < 8000 || opt.rate > 768000) {
+        std::fprintf(stderr, "maetning-host: sample rate %d out of range\n", opt.rate);
+        return 1;
+    }
+
+    std::vector<HostResult> results;
+    std::vector<std::string> checks;
+    std::vector<std::string> formats;
+    std::vector<float> diffs;
+
+    if (!opt.ladspa.empty()) {
+        LadspaPlugin plugin;
+        if (!plugin.load(opt.ladspa, opt.rate) || !run_plugin(plugin, opt, max_block, results, checks, formats, diffs)) {
+            return 1;
+        }
+    }
+
+    if (!opt.lv2.empty()) {
+        Lv2Plugin plugin;
+        if (!plugin.load(opt.lv2, opt.rate, max_block) ||
+            !run_plugin(plugin, opt, max_block, results, checks, formats, diffs)) {
+            return 1;
+        }
+    }
+
+    if (opt.json) {
+        print_json(results, opt, formats, diffs);
+    }
+    else {
+        print_table(results, opt, checks);
+    }
+
+    return 0;
+}
@@ -0,0 +1,522 @@
+/*
+ * maetning-jitter
+ *
+ * Callback latency benchmark of the saturation core. Where maetning-bench
+ * measures throughput with blocks processed back to back, this calls
+ * SatProcessor like a host calls the plugin's run(): once per buffer period,
+ * from a SCHED_FIFO thread that sleeps in between, so caches and branch
+ * predictors cool down like they do in a live rig. The saturation is
+ * automated through its whole range, once per second, so every curve passes
+ * its knees, e.g. the high gain switch of types 4 and 5.
+ *
+ * Every callback, the parameter change included, is timed, and each case
+ * reports the mean, median, p99, p99.9 and maximum callback duration, the
+ * maximum as a share of the buffer period, and the callbacks that took longer
+ * than the period. --histogram adds the distribution in power of two bins.
+ *
+ * Usage: maetning-jitter [options]
+ *   --types LIST        saturation types (default 0-5)
+ *   --blocks LIST       buffer sizes in frames (default 32,64,128,256,512,1024)
+ *   --rates LIST        sample rates in Hz (default 48000)
+ *   --channels LIST     channel counts (default 2)
+ *   --oversampling LIST oversampling factors (default 1)
+ *   --adaa LIST         ADAA orders, 0 for off (default 0)
+ *   --eval LIST         evaluation modes, 0 exact, 1 lookup tables, 2 approximate division (default 0)
+ *   --isa NAME          auto, scalar, sse2, avx2, avx512 or neon (default auto)
+ *   --seconds SEC       duration of each case in real time (default 0.5)
+ *   --priority N        SCHED_FIFO priority, 0 for the normal scheduler (default 80)
+ *   --label TEXT        free text stored in the report, e.g. a commit id
+ *   --histogram         print the histogram of every case
+ *   --json              write a JSON report instead of a table
+ *
+ * A LIST is comma separated, and each item is a number N, a range A-B or a
+ * range with a stride A-B:S, e.g. "44100,48000,96000,192000".
+ *
+ * Realtime scheduling and locking the memory need privileges, e.g.
+ * CAP_SYS_NICE and CAP_IPC_LOCK or a realtime group in limits.conf. Without
+ * them, the benchmark warns and runs with the normal scheduler, and the tail
+ * figures then include preemption by other processes.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "options.h"
+#include "processor.h"
+
+// -----------------------------------------------------------------------------------------------------------
+
+// Histogram bins: bin 0 counts callbacks below 1 us, bin i those from 2^(i-1) up to 2^i us, and the last one
+// everything longer
+#define JITTER_BINS 18
+
+// Untimed callbacks at the start of each case, while the processor settles
+#define JITTER_WARMUP 64
+
+// Period of the saturation automation in seconds
+#define JITTER_AUTOMATION_PERIOD 1.0
+
+struct JitterOptions
+{
+    std::vector<int> types;
+    std::vector<int> blocks;
+    std::vector<int> rates;
+    std::vector<int> channels;
+    std::vector<int> oversampling;
+    std::vector<int> adaa;
+    std::vector<int> eval;
+    std::string isa;
+    std::string label;
+    double seconds;
+    int priority;
+    bool histogram;
+    bool json;
+};
+
+struct JitterResult
+{
+    int type;
+    int block;
+    int rate;
+    int channels;
+    int oversampling;
+    int adaa;
+    int eval;
+
+    uint64_t callbacks;
+    uint64_t overruns;
+    double period_us;
+    double mean_us;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+    uint64_t bins[JITTER_BINS];
+};
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "usage: maetning-jitter [--types LIST] [--blocks LIST] [--rates LIST] [--channels LIST]\n"
+                 "                       [--oversampling LIST] [--adaa LIST] [--eval LIST] [--isa NAME]\n"
+                 "                       [--seconds SEC] [--priority N] [--label TEXT] [--histogram] [--json]\n");
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+static inline int64_t now_ns()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec*1000000000 + t.tv_nsec;
+}
+
+static inline void sleep_until(int64_t ns)
+{
+    struct timespec t;
+    t.tv_sec = (time_t)(ns/1000000000);
+    t.tv_nsec = (long)(ns % 1000000000);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) != 0) {
+    }
+}
+
+/**
+   Duration in @a sorted at quantile @a q, 0 to 1.
+ */
+static double quantile(const std::vector<double>& sorted, double q)
+{
+    size_t i = (size_t)std::ceil(q*sorted.size());
+    i = (i > 0) ? i - 1 : 0;
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+/**
+   Run one case in real time, calling the processor once per buffer period for @a opt.seconds seconds.
+ */
+static JitterResult run_case(const JitterOptions& opt, int type, int block, int rate, int channels,
+                             int oversampling, int adaa, int eval)
+{
+    SatProcessor dsp(channels);
+
+    if (opt.isa != "auto") {
+        dsp.setIsa(opt.isa.c_str());
+    }
+
+    dsp.setSampleRate(rate);
+    dsp.setType(type);
+    dsp.setSaturation(0.0f);
+    dsp.setMasterVolume(-1.0f);
+    dsp.setMasterMix(80.0f);
+    dsp.setOversampling(oversampling);
+    dsp.setAntialiasing(adaa);
+    dsp.setEvaluation(eval);
+    dsp.reset();
+
+    std::vector<std::vector<float> > in(channels, std::vector<float>(block));
+    std::vector<std::vector<float> > out(channels, std::vector<float>(block));
+    std::vector<const float*> inputs(channels);
+    std::vector<float*> outputs(channels);
+
+    // Noise slightly above full scale, so every knee of the curves is hit
+    uint32_t seed = 22222;
+    for (int ch = 0; ch < channels; ch++) {
+        for (int n = 0; n < block; n++) {
+            seed = seed*1664525 + 1013904223;
+            in[ch][n] = 1.5f*((seed >> 8)*(2.0f/16777216.0f) - 1.0f);
+        }
+        inputs[ch] = in[ch].data();
+        outputs[ch] = out[ch].data();
+    }
+
+    const double period = (double)block/rate;
+    const int64_t period_ns = (int64_t)(1e9*period);
+    const uint64_t callbacks = (uint64_t)std::ceil(opt.seconds/period);
+
+    // The saturation goes up and down through its whole range, as a triangle
+    const double automation_step = 2.0*period/JITTER_AUTOMATION_PERIOD;
+    double automation = 0.0;
+
+    std::vector<double> durations(callbacks);
+
+    int64_t deadline = now_ns();
+
+    for (uint64_t i = 0; i < JITTER_WARMUP + callbacks; i++) {
+        deadline += period_ns;
+        sleep_until(deadline);
+
+        const int64_t start = now_ns();
+
+        automation += automation_step;
+        automation -= (automation >= 2.0) ? 2.0 : 0.0;
+        dsp.setSaturation(100.0f*(float)((automation < 1.0) ? automation : 2.0 - automation));
+        dsp.process(inputs.data(), outputs.data(), block);
+
+        const int64_t end = now_ns();
+
+        if (i >= JITTER_WARMUP) {
+            durations[i - JITTER_WARMUP] = 1e-3*(double)(end - start);
+        }
+
+        // After a callback that took longer than a period, the next one is due right away, like in a host
+        if (end > deadline + period_ns) {
+            deadline = end - period_ns;
+        }
+    }
+
+    JitterResult r;
+    r.type = type;
+    r.block = block;
+    r.rate = rate;
+    r.channels = channels;
+    r.oversampling = oversampling;
+    r.adaa = adaa;
+    r.eval = eval;
+    r.callbacks = callbacks;
+    r.overruns = 0;
+    r.period_us = 1e6*period;
+    r.mean_us = 0.0;
+
+    for (int b = 0; b < JITTER_BINS; b++) {
+        r.bins[b] = 0;
+    }
+
+    for (uint64_t i = 0; i < callbacks; i++) {
+        const double us = durations[i];
+        int b = 0;
+
+        while (b < JITTER_BINS - 1 && us >= std::ldexp(1.0, b)) {
+            b++;
+        }
+
+        r.bins[b]++;
+        r.mean_us += us;
+        r.overruns += (us > r.period_us) ? 1 : 0;
+    }
+    r.mean_us /= callbacks;
+
+    std::sort(durations.begin(), durations.end());
+    r.p50_us = quantile(durations, 0.5);
+    r.p99_us = quantile(durations, 0.99);
+    r.p999_us = quantile(durations, 0.999);
+    r.max_us = durations.back();
+
+    return r;
+}
+
+static void print_histogram(const JitterResult& r)
+{
+    uint64_t peak = 1;
+    for (int b = 0; b < JITTER_BINS; b++) {
+        peak = std::max(peak, r.bins[b]);
+    }
+
+    for (int b = 0; b < JITTER_BINS; b++) {
+        if (r.bins[b] == 0) {
+            continue;
+        }
+
+        char range[32];
+        if (b == 0) {
+            std::snprintf(range, sizeof(range), "< 1 us");
+        }
+        else if (b == JITTER_BINS - 1) {
+            std::snprintf(range, sizeof(range), ">= %.0f us", std::ldexp(1.0, b - 1));
+        }
+        else {
+            std::snprintf(range, sizeof(range), "%.0f-%.0f us", std::ldexp(1.0, b - 1), std::ldexp(1.0, b));
+        }
+
+        const int bar = (int)(40*r.bins[b]/peak);
+        std::printf("#   %14s %9llu %.*s\n", range, (unsigned long long)r.bins[b], (bar > 0) ? bar : 1,
+                    "########################################");
+    }
+}
+
+static void print_table(const std::vector<JitterResult>& results, const char* isa, const char* sched,
+                        bool histogram)
+{
+    std::printf("# isa: %s, scheduler: %s\n", isa, sched);
+    std::printf("%4s %5s %6s %3s %3s %4s %4s %9s %9s %9s %9s %9s %9s %9s %7s %8s\n", "type", "block", "rate", "ch",
+                "os", "adaa", "eval", "callbacks", "period us", "mean us", "p50 us", "p99 us", "p99.9 us", "max us",
+                "max %", "overruns");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const JitterResult& r = results[i];
+        std::printf("%4d %5d %6d %3d %3d %4d %4d %9llu %9.1f %9.2f %9.2f %9.2f %9.2f %9.2f %7.2f %8llu\n", r.type,
+                    r.block, r.rate, r.channels, r.oversampling, r.adaa, r.eval, (unsigned long long)r.callbacks,
+                    r.period_us, r.mean_us, r.p50_us, r.p99_us, r.p999_us, r.max_us, 100.0*r.max_us/r.period_us,
+                    (unsigned long long)r.overruns);
+
+        if (histogram) {
+            print_histogram(r);
+        }
+    }
+}
+
+static void print_json(const std::vector<JitterResult>& results, const char* isa, const char* sched,
+                       const std::string& label)
+{
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"maetning-jitter\",\n");
+    std::printf("  \"label\": \"");
+    for (size_t i = 0; i < label.size(); i++) {
+        const char c = label[i];
+        if (c == '"' || c == '\\') {
+            std::printf("\\%c", c);
+        }
+        else if ((unsigned char)c >= 0x20) {
+            std::printf("%c", c);
+        }
+    }
+    std::printf("\",\n");
+    std::printf("  \"isa\": \"%s\",\n", isa);
+    std::printf("  \"scheduler\": \"%s\",\n", sched);
+    std::printf("  \"histogram_bins_us\": \"bin 0 below 1, bin i from 2^(i-1) below 2^i, the last one above\",\n");
+    std::printf("  \"results\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const JitterResult& r = results[i];
+        std::printf("    {\"type\": %d, \"block_size\": %d, \"sample_rate\": %d, \"channels\": %d, "
+                    "\"oversampling\": %d, \"adaa\": %d, \"eval\": %d, \"callbacks\": %llu, \"overruns\": %llu, "
+                    "\"period_us\": %.3f, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p99_us\": %.3f, "
+                    "\"p999_us\": %.3f, \"max_us\": %.3f, \"histogram\": [",
+                    r.type, r.block, r.rate, r.channels, r.oversampling, r.adaa, r.eval,
+                    (unsigned long long)r.callbacks, (unsigned long long)r.overruns, r.period_us, r.mean_us,
+                    r.p50_us, r.p99_us, r.p999_us, r.max_us);
+
+        for (int b = 0; b < JITTER_BINS; b++) {
+            std::printf("%llu%s", (unsigned long long)r.bins[b], (b + 1 < JITTER_BINS) ? ", " : "");
+        }
+
+        std::printf("]}%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+
+    std::printf("  ]\n");
+    std::printf("}\n");
+}
+
+/**
+   Move the calling thread to SCHED_FIFO at @a priority and lock the memory. Returns the name of the scheduler
+   that is in effect.
+ */
+static const char* set_realtime(int priority)
+{
+    if (priority <= 0) {
+        return "other";
+    }
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::fprintf(stderr, "maetning-jitter: cannot lock memory, page faults may show up in the tail\n");
+    }
+
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+
+    const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0) {
+        std::fprintf(stderr, "maetning-jitter: cannot use SCHED_FIFO (%s), running with the normal scheduler\n",
+                     std::strerror(error));
+        return "other";
+    }
+
+    return "fifo";
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    JitterOptions opt;
+    sat_parse_list("0-5", opt.types);
+    sat_parse_list("32,64,128,256,512,1024", opt.blocks);
+    sat_parse_list("48000", opt.rates);
+    sat_parse_list("2", opt.channels);
+    sat_parse_list("1", opt.oversampling);
+    sat_parse_list("0", opt.adaa);
+    sat_parse_list("0", opt.eval);
+    opt.isa = "auto";
+    opt.seconds = 0.5;
+    opt.priority = 80;
+    opt.histogram = false;
+    opt.json = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool ok = true;
+
+        if (std::strcmp(arg, "--json") == 0) {
+            opt.json = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--histogram") == 0) {
+            opt.histogram = true;
+            continue;
+        }
+        if (value == NULL) {
+            usage();
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--types") == 0) ok = sat_parse_list(value, opt.types);
+        else if (std::strcmp(arg, "--blocks") == 0) ok = sat_parse_list(value, opt.blocks);
+        else if (std::strcmp(arg, "--rates") == 0) ok = sat_parse_list(value, opt.rates);
+        else if (std::strcmp(arg, "--channels") == 0) ok = sat_parse_list(value, opt.channels);
+        else if (std::strcmp(arg, "--oversampling") == 0) ok = sat_parse_list(value, opt.oversampling);
+        else if (std::strcmp(arg, "--adaa") == 0) ok = sat_parse_list(value, opt.adaa);
+        else if (std::strcmp(arg, "--eval") == 0) ok = sat_parse_list(value, opt.eval);
+        else if (std::strcmp(arg, "--isa") == 0) opt.isa = value;
+        else if (std::strcmp(arg, "--label") == 0) opt.label = value;
+        else if (std::strcmp(arg, "--seconds") == 0) opt.seconds = std::atof(value);
+        else if (std::strcmp(arg, "--priority") == 0) opt.priority = std::atoi(value);
+        else ok = false;
+
+        if (!ok) {
+            usage();
+            return 1;
+        }
+        i++;
+    }
+
+    for (size_t i = 0; i < opt.types.size(); i++) {
+        if (opt.types[i] < 0 || opt.types[i] >= NUM_SATURATIONS) {
+            std::fprintf(stderr, "maetning-jitter: type %d out of range\n", opt.types[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.blocks.size(); i++) {
+        if (opt.blocks[i] < 1) {
+            std::fprintf(stderr, "maetning-jitter: block size %d out of range\n", opt.blocks[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.rates.size(); i++) {
+        if (opt.rates[i] < 8000 || opt.rates[i] > 768000) {
+            std::fprintf(stderr, "maetning-jitter: sample rate %d out of range\n", opt.rates[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.channels.size(); i++) {
+        if (opt.channels[i] < 1) {
+            std::fprintf(stderr, "maetning-jitter: channel count %d out of range\n", opt.channels[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.oversampling.size(); i++) {
+        const int os = opt.oversampling[i];
+        if (os != 1 && os != 2 && os != 4 && os != 8) {
+            std::fprintf(stderr, "maetning-jitter: oversampling factor %d is not 1, 2, 4 or 8\n", os);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.adaa.size(); i++) {
+        if (opt.adaa[i] < SAT_ADAA_OFF || opt.adaa[i] > SAT_ADAA_SECOND_ORDER) {
+            std::fprintf(stderr, "maetning-jitter: ADAA order %d is not 0, 1 or 2\n", opt.adaa[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.eval.size(); i++) {
+        if (opt.eval[i] < SAT_EVAL_EXACT || opt.eval[i] > SAT_EVAL_APPROX) {
+            std::fprintf(stderr, "maetning-jitter: evaluation mode %d is not 0, 1 or 2\n", opt.eval[i]);
+            return 1;
+        }
+    }
+    if (opt.seconds <= 0.0) {
+        std::fprintf(stderr, "maetning-jitter: duration %g out of range\n", opt.seconds);
+        return 1;
+    }
+
+    const char* isa = NULL;
+    sat_kernels_detect(&isa);
+
+    if (opt.isa != "auto") {
+        if (sat_kernels_isa(opt.isa.c_str()) == NULL) {
+            std::fprintf(stderr, "maetning-jitter: instruction set '%s' is not available\n", opt.isa.c_str());
+            return 1;
+        }
+        isa = opt.isa.c_str();
+    }
+
+    const char* sched = set_realtime(opt.priority);
+
+    std::vector<JitterResult> results;
+
+    for (size_t t = 0; t < opt.types.size(); t++) {
+        for (size_t b = 0; b < opt.blocks.size(); b++) {
+            for (size_t s = 0; s < opt.rates.size(); s++) {
+                for (size_t c = 0; c < opt.channels.size(); c++) {
+                    for (size_t o = 0; o < opt.oversampling.size(); o++) {
+                        for (size_t a = 0; a < opt.adaa.size(); a++) {
+                            for (size_t e = 0; e < opt.eval.size(); e++) {
+                                results.push_back(run_case(opt, opt.types[t], opt.blocks[b], opt.rates[s],
+                                                           opt.channels[c], opt.oversampling[o], opt.adaa[a],
+                                                           opt.eval[e]));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (opt.json) {
+        print_json(results, isa, sched, opt.label);
+    }
+    else {
+        print_table(results, isa, sched, opt.histogram);
+    }
+
+    return 0;
+}
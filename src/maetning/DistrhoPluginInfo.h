@@ -17,14 +17,36 @@
 #ifndef DISTRHO_PLUGIN_INFO_H_INCLUDED
 #define DISTRHO_PLUGIN_INFO_H_INCLUDED
 
+// Channel count of this build, e.g. make CHANNELS=6. Every channel count is a plugin of its own.
+#ifndef MAETNING_CHANNELS
+#define MAETNING_CHANNELS 2
+#endif
+
+// DSP load output parameters for profiling, e.g. make PROBE=1 (see probe.h). Off in release builds.
+#ifndef MAETNING_PROBE
+#define MAETNING_PROBE 0
+#endif
+
+#define MAETNING_STRINGIFY(x) MAETNING_STRINGIFY2(x)
+#define MAETNING_STRINGIFY2(x) #x
+
+// The stereo plugin keeps its original name
+#if MAETNING_CHANNELS == 2
+#define MAETNING_SUFFIX ""
+#elif MAETNING_CHANNELS == 1
+#define MAETNING_SUFFIX "_mono"
+#else
+#define MAETNING_SUFFIX "_" MAETNING_STRINGIFY(MAETNING_CHANNELS) "ch"
+#endif
+
 #define DISTRHO_PLUGIN_BRAND "soerenbnoergaard"
-#define DISTRHO_PLUGIN_NAME  "maetning"
-#define DISTRHO_PLUGIN_URI   "http://github.com/soerenbnoergaard/maetning"
+#define DISTRHO_PLUGIN_NAME  "maetning" MAETNING_SUFFIX
+#define DISTRHO_PLUGIN_URI   "http://github.com/soerenbnoergaard/maetning" MAETNING_SUFFIX
 
 #define DISTRHO_PLUGIN_HAS_UI       0
 #define DISTRHO_PLUGIN_IS_RT_SAFE   1
-#define DISTRHO_PLUGIN_NUM_INPUTS   2
-#define DISTRHO_PLUGIN_NUM_OUTPUTS  2
-#define DISTRHO_PLUGIN_WANT_LATENCY 0
+#define DISTRHO_PLUGIN_NUM_INPUTS   MAETNING_CHANNELS
+#define DISTRHO_PLUGIN_NUM_OUTPUTS  MAETNING_CHANNELS
+#define DISTRHO_PLUGIN_WANT_LATENCY 1
 
 #endif // DISTRHO_PLUGIN_INFO_H_INCLUDED
@@ -15,22 +15,41 @@
  */
 
 #include "DistrhoPlugin.hpp"
+#include "processor.h"
 
-START_NAMESPACE_DISTRHO
+#if MAETNING_PROBE
+#include "probe.h"
+#endif
 
-#define PARAM_SATURATION 0
-#define PARAM_TYPE 1
-#define PARAM_MASTERVOLUME 2
-#define PARAM_MASTERMIX 3
+START_NAMESPACE_DISTRHO
 
-#define NUM_PARAMS 4
-#define NUM_SATURATIONS 6
-#include "sat0.h"
-#include "sat1.h"
-#include "sat2.h"
-#include "sat3.h"
-#include "sat4.h"
-#include "sat5.h"
+#define PARAM_SATURATION SAT_PARAM_SATURATION
+#define PARAM_TYPE SAT_PARAM_TYPE
+#define PARAM_MASTERVOLUME SAT_PARAM_MASTERVOLUME
+#define PARAM_MASTERMIX SAT_PARAM_MASTERMIX
+#define PARAM_OVERSAMPLING SAT_PARAM_OVERSAMPLING
+#define PARAM_ANTIALIASING SAT_PARAM_ANTIALIASING
+#define PARAM_BANDS SAT_PARAM_BANDS
+#define PARAM_CROSSOVER1 SAT_PARAM_CROSSOVER1
+#define PARAM_CROSSOVER2 SAT_PARAM_CROSSOVER2
+#define PARAM_CROSSOVER3 SAT_PARAM_CROSSOVER3
+#define PARAM_SATURATION2 SAT_PARAM_SATURATION2
+#define PARAM_TYPE2 SAT_PARAM_TYPE2
+#define PARAM_SATURATION3 SAT_PARAM_SATURATION3
+#define PARAM_TYPE3 SAT_PARAM_TYPE3
+#define PARAM_SATURATION4 SAT_PARAM_SATURATION4
+#define PARAM_TYPE4 SAT_PARAM_TYPE4
+
+// Output parameters of the DSP load probe, after the regular ones
+#if MAETNING_PROBE
+#define PARAM_LOAD_AVERAGE (NUM_SAT_PARAMS + 0)
+#define PARAM_LOAD_WORST (NUM_SAT_PARAMS + 1)
+#define PARAM_LOAD_BLOCKS (NUM_SAT_PARAMS + 2)
+
+#define NUM_PARAMS (NUM_SAT_PARAMS + 3)
+#else
+#define NUM_PARAMS NUM_SAT_PARAMS
+#endif
 
 // -----------------------------------------------------------------------------------------------------------
 
@@ -40,8 +59,17 @@ START_NAMESPACE_DISTRHO
 class MaetningPlugin : public Plugin
 {
 public:
-    MaetningPlugin() : Plugin(NUM_PARAMS, 0, 0) // 1st argument: Number of parameters
+    MaetningPlugin()
+        : Plugin(NUM_PARAMS, 0, 0), // 1st argument: Number of parameters
+          dsp(DISTRHO_PLUGIN_NUM_INPUTS),
+          latency(0)
     {
+#if MAETNING_PROBE
+        param_load_average = 0.0f;
+        param_load_worst = 0.0f;
+        param_load_blocks = 0.0f;
+#endif
+
         sampleRateChanged(getSampleRate());
     }
 
@@ -59,7 +87,7 @@ protected:
     */
     const char* getLabel() const override
     {
-        return "maetning";
+        return "maetning" MAETNING_SUFFIX;
     }
 
    /**
@@ -110,7 +138,11 @@ protected:
     int64_t getUniqueId() const override
     {
         /* soerenbnoergaard: I just made something up */
+#if MAETNING_CHANNELS == 2
         return d_cconst('e', 'K', 'A', 'p');
+#else
+        return d_cconst('e', 'K', 'c', MAETNING_CHANNELS);
+#endif
     }
 
    /* --------------------------------------------------------------------------------------------------------
@@ -164,6 +196,122 @@ protected:
             parameter.ranges.max = 100.0f;
             break;
 
+        case PARAM_OVERSAMPLING:
+            // Not automable, since changing it changes the latency
+            parameter.hints  = kParameterIsInteger;
+            parameter.name   = "Oversampling";
+            parameter.symbol = "Oversampling";
+            parameter.unit   = "x";
+            parameter.ranges.def = 1.0f;
+            parameter.ranges.min = 1.0f;
+            parameter.ranges.max = 1.0f * OVERSAMPLING_MAX_FACTOR;
+            break;
+
+        case PARAM_ANTIALIASING:
+            // 0: off, 1: first order, 2: second order ADAA. Not automable, since second order adds latency
+            parameter.hints  = kParameterIsInteger;
+            parameter.name   = "Antialiasing";
+            parameter.symbol = "Antialiasing";
+            parameter.unit   = "";
+            parameter.ranges.def = 0.0f;
+            parameter.ranges.min = 0.0f;
+            parameter.ranges.max = 1.0f * SAT_ADAA_SECOND_ORDER;
+            break;
+
+        case PARAM_BANDS:
+            // 1: the whole signal, 2 to 4: multiband. Not automable, since a new number of bands resets the filters
+            parameter.hints  = kParameterIsInteger;
+            parameter.name   = "Bands";
+            parameter.symbol = "Bands";
+            parameter.unit   = "";
+            parameter.ranges.def = 1.0f;
+            parameter.ranges.min = 1.0f;
+            parameter.ranges.max = 1.0f * SAT_MAX_BANDS;
+            break;
+
+        case PARAM_CROSSOVER1:
+        case PARAM_CROSSOVER2:
+        case PARAM_CROSSOVER3:
+            {
+                static const char* const names[] = { "Crossover1", "Crossover2", "Crossover3" };
+                static const float defaults[] = { SAT_CROSSOVER1_HZ, SAT_CROSSOVER2_HZ, SAT_CROSSOVER3_HZ };
+                const uint32_t j = index - PARAM_CROSSOVER1;
+
+                parameter.hints  = kParameterIsAutomable | kParameterIsLogarithmic;
+                parameter.name   = names[j];
+                parameter.symbol = names[j];
+                parameter.unit   = "Hz";
+                parameter.ranges.def = defaults[j];
+                parameter.ranges.min = 20.0f;
+                parameter.ranges.max = 20000.0f;
+            }
+            break;
+
+        case PARAM_SATURATION2:
+        case PARAM_SATURATION3:
+        case PARAM_SATURATION4:
+            {
+                static const char* const names[] = { "Saturation2", "Saturation3", "Saturation4" };
+
+                parameter.hints  = kParameterIsAutomable;
+                parameter.name   = names[(index - PARAM_SATURATION2)/2];
+                parameter.symbol = names[(index - PARAM_SATURATION2)/2];
+                parameter.unit   = "%";
+                parameter.ranges.def = 0.0f;
+                parameter.ranges.min = 0.0f;
+                parameter.ranges.max = 100.0f;
+            }
+            break;
+
+        case PARAM_TYPE2:
+        case PARAM_TYPE3:
+        case PARAM_TYPE4:
+            {
+                static const char* const names[] = { "Type2", "Type3", "Type4" };
+
+                parameter.hints  = kParameterIsAutomable;
+                parameter.name   = names[(index - PARAM_TYPE2)/2];
+                parameter.symbol = names[(index - PARAM_TYPE2)/2];
+                parameter.unit   = "";
+                parameter.ranges.def = 0.0f;
+                parameter.ranges.min = 0.0f;
+                parameter.ranges.max = 1.0f * NUM_SATURATIONS - 1.0f;
+            }
+            break;
+
+#if MAETNING_PROBE
+        case PARAM_LOAD_AVERAGE:
+            parameter.hints  = kParameterIsOutput;
+            parameter.name   = "LoadAverage";
+            parameter.symbol = "LoadAverage";
+            parameter.unit   = "ns";
+            parameter.ranges.def = 0.0f;
+            parameter.ranges.min = 0.0f;
+            parameter.ranges.max = 1000.0f;
+            break;
+
+        case PARAM_LOAD_WORST:
+            parameter.hints  = kParameterIsOutput;
+            parameter.name   = "LoadWorst";
+            parameter.symbol = "LoadWorst";
+            parameter.unit   = "ns";
+            parameter.ranges.def = 0.0f;
+            parameter.ranges.min = 0.0f;
+            parameter.ranges.max = 1000.0f;
+            break;
+
+        case PARAM_LOAD_BLOCKS:
+            // Exact up to 2^24 blocks, about a day at 256 frames and 48 kHz
+            parameter.hints  = kParameterIsOutput | kParameterIsInteger;
+            parameter.name   = "LoadBlocks";
+            parameter.symbol = "LoadBlocks";
+            parameter.unit   = "";
+            parameter.ranges.def = 0.0f;
+            parameter.ranges.min = 0.0f;
+            parameter.ranges.max = 16777216.0f;
+            break;
+#endif
+
         default:
             break;
         }
@@ -198,6 +346,50 @@ protected:
             return param_mastermix;
             break;
 
+        case PARAM_OVERSAMPLING:
+            return param_oversampling;
+            break;
+
+        case PARAM_ANTIALIASING:
+            return param_antialiasing;
+            break;
+
+        case PARAM_BANDS:
+            return param_bands;
+            break;
+
+        case PARAM_CROSSOVER1:
+        case PARAM_CROSSOVER2:
+        case PARAM_CROSSOVER3:
+            return param_crossover[index - PARAM_CROSSOVER1];
+            break;
+
+        case PARAM_SATURATION2:
+        case PARAM_SATURATION3:
+        case PARAM_SATURATION4:
+            return param_band_saturation[(index - PARAM_SATURATION2)/2];
+            break;
+
+        case PARAM_TYPE2:
+        case PARAM_TYPE3:
+        case PARAM_TYPE4:
+            return param_band_type[(index - PARAM_TYPE2)/2];
+            break;
+
+#if MAETNING_PROBE
+        case PARAM_LOAD_AVERAGE:
+            return param_load_average;
+            break;
+
+        case PARAM_LOAD_WORST:
+            return param_load_worst;
+            break;
+
+        case PARAM_LOAD_BLOCKS:
+            return param_load_blocks;
+            break;
+#endif
+
         default:
             return 0.0;
             break;
@@ -215,28 +407,58 @@ protected:
         switch (index) {
         case PARAM_SATURATION:
             param_saturation = value;
-            param_saturation_int = (int)value;
+            dsp.setSaturation(value);
             break;
 
         case PARAM_TYPE:
             param_type = value;
-            param_type_int = (int)value;
+            dsp.setType((int)value);
             break;
 
         case PARAM_MASTERVOLUME:
             param_mastervolume = value;
-            if (value < -50) {
-                param_mastervolume_lin = 0.0;
-            }
-            else {
-                param_mastervolume_lin = pow(10.0, value/20.0);
-            }
+            dsp.setMasterVolume(value);
             break;
 
         case PARAM_MASTERMIX:
             param_mastermix = value;
-            param_mastermix_wet = value/100.0;
-            param_mastermix_dry = 1.0 - param_mastermix_wet;
+            dsp.setMasterMix(value);
+            break;
+
+        case PARAM_OVERSAMPLING:
+            param_oversampling = value;
+            dsp.setOversampling((uint32_t)value);
+            break;
+
+        case PARAM_ANTIALIASING:
+            param_antialiasing = value;
+            dsp.setAntialiasing((int)value);
+            break;
+
+        case PARAM_BANDS:
+            param_bands = value;
+            dsp.setBands((uint32_t)value);
+            break;
+
+        case PARAM_CROSSOVER1:
+        case PARAM_CROSSOVER2:
+        case PARAM_CROSSOVER3:
+            param_crossover[index - PARAM_CROSSOVER1] = value;
+            dsp.setCrossover(index - PARAM_CROSSOVER1, value);
+            break;
+
+        case PARAM_SATURATION2:
+        case PARAM_SATURATION3:
+        case PARAM_SATURATION4:
+            param_band_saturation[(index - PARAM_SATURATION2)/2] = value;
+            dsp.setBandSaturation(1 + (index - PARAM_SATURATION2)/2, value);
+            break;
+
+        case PARAM_TYPE2:
+        case PARAM_TYPE3:
+        case PARAM_TYPE4:
+            param_band_type[(index - PARAM_TYPE2)/2] = value;
+            dsp.setBandType(1 + (index - PARAM_TYPE2)/2, (int)value);
             break;
 
         default:
@@ -247,167 +469,48 @@ protected:
    /* --------------------------------------------------------------------------------------------------------
     * Audio/MIDI Processing */
 
+   /**
+      Activate this plugin.
+    */
+    void activate() override
+    {
+        // Buffers are allocated with the processor and work in chunks of their own, whatever the block size, and
+        // the reset sets up the crossovers of the current bands, so run() starts without setting up anything
+        dsp.reset();
+        latency = dsp.getLatency();
+        setLatency(latency);
+
+#if MAETNING_PROBE
+        probe.reset();
+        param_load_average = 0.0f;
+        param_load_worst = 0.0f;
+        param_load_blocks = 0.0f;
+#endif
+    }
+
    /**
       Run/process function for plugins without MIDI input.
       @note Some parameters might be null if there are no audio inputs or outputs.
     */
     void run(const float** inputs, float** outputs, uint32_t frames) override
     {
-        float x = 0.0;
-        float y = 0.0;
-        float s = 0.0;
-
-        float p0 = 0.0;
-        float p1 = 0.0;
-        float p2 = 0.0;
-        float p3 = 0.0;
-        float p4 = 0.0;
-        float p5 = 0.0;
-        float p6 = 0.0;
-        float p7 = 0.0;
-        float p8 = 0.0;
-        float p9 = 0.0;
-        float bp = 0.0;
-        float bn = 0.0;
-        float abs_x = 0.0;
-
-        switch (param_type_int) {
-        case 0:
-            p0 = sat0_coeffs[param_saturation_int][0];
-            p1 = sat0_coeffs[param_saturation_int][1];
-            p2 = sat0_coeffs[param_saturation_int][2];
-            p3 = sat0_coeffs[param_saturation_int][3];
-            p4 = sat0_coeffs[param_saturation_int][4];
-            bp = p2 - p1*p2/p0;
-            bn = p4 - p3*p4/p0;
-            break;
-
-        case 1:
-            p0 = sat1_coeffs[param_saturation_int][0];
-            p1 = sat1_coeffs[param_saturation_int][1];
-            p2 = sat1_coeffs[param_saturation_int][2];
-            break;
-
-        case 2:
-            p0 = sat2_coeffs[param_saturation_int][0];
-            p1 = sat2_coeffs[param_saturation_int][1];
-            p2 = sat2_coeffs[param_saturation_int][2];
-            p3 = sat2_coeffs[param_saturation_int][3];
-            break;
-
-        case 3:
-            p0 = sat3_coeffs[param_saturation_int][0];
-            p1 = sat3_coeffs[param_saturation_int][1];
-            p2 = sat3_coeffs[param_saturation_int][2];
-            break;
-
-        case 4:
-            p0 = sat4_coeffs[param_saturation_int][0];
-            p1 = sat4_coeffs[param_saturation_int][1];
-            p2 = sat4_coeffs[param_saturation_int][2];
-            p3 = sat4_coeffs[param_saturation_int][3];
-            p4 = sat4_coeffs[param_saturation_int][4];
-            p5 = sat4_coeffs[param_saturation_int][5];
-            p6 = sat4_coeffs[param_saturation_int][6];
-            p7 = sat4_coeffs[param_saturation_int][7];
-            p8 = sat4_coeffs[param_saturation_int][8];
-            p9 = sat4_coeffs[param_saturation_int][9];
-            break;
-
-        case 5:
-            p0 = sat5_coeffs[param_saturation_int][0];
-            p1 = sat5_coeffs[param_saturation_int][1];
-            p2 = sat5_coeffs[param_saturation_int][2];
-            p3 = sat5_coeffs[param_saturation_int][3];
-            p4 = sat5_coeffs[param_saturation_int][4];
-            p5 = sat5_coeffs[param_saturation_int][5];
-            p6 = sat5_coeffs[param_saturation_int][6];
-            p7 = sat5_coeffs[param_saturation_int][7];
-            p8 = sat5_coeffs[param_saturation_int][8];
-            p9 = sat5_coeffs[param_saturation_int][9];
-            break;
-
-        };
-
-        for (uint32_t ch = 0; ch < 2; ch++) {
-            for (uint32_t n = 0; n < frames; n++) {
-                x = inputs[ch][n];
-                y = 0;
-
-                // Apply saturation
-                switch (param_type_int) {
-                case 0:
-                    y = p0*x;
-                    if (y > p2) {
-                        y = p1*x + bp;
-                    }
-                    else if (y < p4) {
-                        y = p3*x + bn;
-                    }
-                    break;
-
-                case 1:
-                    y = x / (p1 + p0*std::abs(x)) + p2*std::abs(x);
-                    break;
-
-                case 2:
-                    s = p0 * x;
-                    if (s < -0.6) {
-                        y = p1*s*s + p2*s + p3;
-                    }
-                    else if (s > 0.6) {
-                        y = (-p1)*s*s + p2*s + (-p3);
-                    }
-                    else {
-                        y = s;
-                    }
-                    break;
-
-                case 3:
-                    s = p0*x;
-                    if (s < -0.75) {
-                        y = p1*s + p2;
-                    }
-                    else if (s > 0.75) {
-                        y = p1*s - p2;
-                    }
-                    else {
-                        y = s;
-                    }
-                    break;
-
-                case 4:
-                case 5:
-                    abs_x = std::abs(x);
-
-                    if (p9 == 0) {
-                        // Low-gain algorithm
-                        y = x / (p0 + p1*abs_x + p2*abs_x*abs_x) + p3*abs_x;
-                    }
-                    else {
-                        // High-gain algorithm
-                        if (x < 0) {
-                            y = x / (p0 + p1*abs_x) + p2*abs_x;
-                        }
-                        else {
-                            y = p3*(p4*x*x + p5*x)/(x*x + p6*x + p7) + p8*x;
-                        }
-                    }
-                    break;
-
-                default:
-                    y = x;
-                }
-
-                // Mix wet and dry signal
-                y = param_mastermix_wet*y + param_mastermix_dry*x;
-
-                // Apply master volume
-                y *= param_mastervolume_lin;
-
-                // Write to output
-                y = outputs[ch][n] = y;
-            }
+#if MAETNING_PROBE
+        probe.begin();
+#endif
+
+        dsp.process(inputs, outputs, frames);
+
+#if MAETNING_PROBE
+        probe.end(frames*DISTRHO_PLUGIN_NUM_INPUTS);
+        param_load_average = probe.getAverage();
+        param_load_worst = probe.getWorst();
+        param_load_blocks = (float)probe.getBlocks();
+#endif
+
+        // A new oversampling factor takes effect in process(), and second order ADAA adds a sample
+        if (dsp.getLatency() != latency) {
+            latency = dsp.getLatency();
+            setLatency(latency);
         }
     }
 
@@ -420,6 +523,9 @@ protected:
     */
     void sampleRateChanged(double newSampleRate) override
     {
+        // Parameter smoothing ramps are a fixed time long, and the crossovers are designed for the rate. The
+        // oversampling filters and the lookup tables do not depend on it.
+        dsp.setSampleRate(newSampleRate);
     }
 
     // -------------------------------------------------------------------------------------------------------
@@ -427,14 +533,28 @@ protected:
 private:
 
     float param_saturation;
-    int param_saturation_int;
     float param_type;
-    int param_type_int;
     float param_mastervolume;
-    float param_mastervolume_lin;
     float param_mastermix;
-    float param_mastermix_wet;
-    float param_mastermix_dry;
+    float param_oversampling;
+    float param_antialiasing;
+
+    // Multiband mode, with the saturation and type of bands 2 to 4
+    float param_bands;
+    float param_crossover[SAT_MAX_BANDS - 1];
+    float param_band_saturation[SAT_MAX_BANDS - 1];
+    float param_band_type[SAT_MAX_BANDS - 1];
+
+#if MAETNING_PROBE
+    float param_load_average;
+    float param_load_worst;
+    float param_load_blocks;
+
+    SatLoadProbe probe;
+#endif
+
+    SatProcessor dsp;
+    uint32_t latency;
 
    /**
       Set our plugin class as non-copyable and add a leak detector just in case.
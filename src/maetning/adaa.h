@@ -0,0 +1,531 @@
+/*
+ * Antiderivative anti-aliasing (ADAA)
+ *
+ * Instead of sampling y = f(x), first order ADAA outputs the mean of f over
+ * the line between two input samples, and second order ADAA the mean over the
+ * last three samples, weighted by a triangle:
+ *
+ *   1st order:  y[n] = (F1(x[n]) - F1(x[n-1])) / (x[n] - x[n-1])
+ *
+ *   2nd order:  y[n] = 2 / (x[n] - x[n-2]) * (D[n] - D[n-1])
+ *               D[n] = (F2(x[n]) - F2(x[n-1])) / (x[n] - x[n-1])
+ *
+ * where F1 is the antiderivative of f and F2 that of F1. This suppresses the
+ * harmonics above Nyquist that would otherwise alias, without oversampling.
+ * The output is delayed by half a sample (1st order) or one sample (2nd
+ * order), so the dry signal is averaged the same way, which is what ADAA of
+ * f(x) = x gives: (x[n] + x[n-1]) / 2 and (x[n] + x[n-1] + x[n-2]) / 3.
+ *
+ * The differences are ill-conditioned when the samples are close together.
+ * Below SAT_ADAA_TOLERANCE, the divided difference is replaced by the
+ * function it tends to, evaluated at the midpoint. D[n] is worse off, since
+ * the rounding error of F2 is divided twice by a small distance, so below
+ * SAT_ADAA_QUADRATURE_WIDTH it is computed as the mean of F1 with 2-point
+ * Gauss-Legendre quadrature instead.
+ *
+ * All curves are piecewise polynomial or rational, so F1 and F2 are derived
+ * analytically. Rational pieces lead to log and atan terms, so the kernels
+ * are scalar and evaluated in double precision. Every antiderivative is 0 at
+ * x = 0, which keeps the values small for small signals.
+ *
+ * The log and atan terms of types 1, 4 and 5 are only evaluated once or
+ * twice per sample. Everything that depends on the coefficients alone is set
+ * up once per block, when the antiderivative is made from them.
+ */
+
+#ifndef ADAA_H_INCLUDED
+#define ADAA_H_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+
+#include "saturation.h"
+
+#define SAT_ADAA_OFF 0
+#define SAT_ADAA_FIRST_ORDER 1
+#define SAT_ADAA_SECOND_ORDER 2
+
+#define SAT_ADAA_TOLERANCE 1e-5
+#define SAT_ADAA_QUADRATURE_WIDTH 1e-3
+
+// Frames per coefficient step when ADAA follows a coefficient ramp
+#define SAT_ADAA_RAMP_STEP 16
+
+/**
+   The last two input samples of one channel.
+ */
+struct SatAdaaState
+{
+    double x1, x2;
+};
+
+// Like SatRampFunc with constant coefficients: the gains are wet + n*dwet and dry + n*ddry at sample n
+typedef void (*SatAdaaFunc)(const float* in, float* out, uint32_t frames, const SatCoeffs& c,
+                            float wet, float dry, float dwet, float ddry, SatAdaaState& state);
+
+// -----------------------------------------------------------------------------------------------------------
+// Building blocks
+//
+// Everything here has internal linkage, see saturation.h.
+
+namespace {
+
+/**
+   Antiderivatives of a function of three polynomial pieces of at most second degree,
+   q[0] below lo, q[1] from lo to hi and q[2] above hi, each given as { q0, q1, q2 }.
+ */
+struct SatPiecewiseAntiderivative
+{
+    double lo, hi;
+    double q[3][3];
+
+    // Integration constants making F1 and F2 continuous at lo and hi
+    double k1[3], k2[3];
+
+    void init()
+    {
+        k1[1] = 0.0;
+        k2[1] = 0.0;
+        k1[0] = P1(1, lo) - P1(0, lo);
+        k2[0] = P2(1, lo) - P2(0, lo) - k1[0]*lo;
+        k1[2] = P1(1, hi) - P1(2, hi);
+        k2[2] = P2(1, hi) - P2(2, hi) - k1[2]*hi;
+    }
+
+    double P1(int k, double x) const
+    {
+        return x*(q[k][0] + x*(q[k][1]/2.0 + x*q[k][2]/3.0));
+    }
+
+    double P2(int k, double x) const
+    {
+        return x*x*(q[k][0]/2.0 + x*(q[k][1]/6.0 + x*q[k][2]/12.0));
+    }
+
+    int piece(double x) const
+    {
+        return (x < lo) ? 0 : (x > hi) ? 2 : 1;
+    }
+
+    double F1(double x) const
+    {
+        const int k = piece(x);
+        return P1(k, x) + k1[k];
+    }
+
+    double F2(double x) const
+    {
+        const int k = piece(x);
+        return P2(k, x) + k1[k]*x + k2[k];
+    }
+};
+
+/**
+   Antiderivatives of f(x) = x / (a + b|x|) + c|x|.
+   With u = b|x| / a, they are written around the power series of log(1 + u), which is used for small u,
+   where the closed forms cancel. F2 is divided by the square of the sample distance, so it needs every digit.
+ */
+struct SatRationalAntiderivative
+{
+    // 1 / a, b / a and c
+    double inv_a, b_a, c;
+
+    void init(double a, double b, double c)
+    {
+        inv_a = 1.0/a;
+        b_a = b/a;
+        this->c = c;
+    }
+
+    // (u - log(1 + u)) / u^2 = sum of (-u)^(k - 2) / k for k >= 2
+    static double h1(double u)
+    {
+        if (std::abs(u) < 0.1) {
+            double s = 0.0;
+            for (int k = 17; k >= 2; k--) {
+                s = 1.0/k - u*s;
+            }
+            return s;
+        }
+        return (u - std::log1p(u))/(u*u);
+    }
+
+    // (u^2 / 2 + u - (1 + u) log(1 + u)) / u^3 = sum of (-u)^(k - 3) / (k (k - 1)) for k >= 3
+    static double h2(double u)
+    {
+        if (std::abs(u) < 0.1) {
+            double s = 0.0;
+            for (int k = 18; k >= 3; k--) {
+                s = 1.0/(k*(k - 1)) - u*s;
+            }
+            return s;
+        }
+        return (u*u/2.0 + u - (1.0 + u)*std::log1p(u))/(u*u*u);
+    }
+
+    double F1(double x) const
+    {
+        const double v = std::abs(x);
+        return v*v*inv_a*h1(b_a*v) + c*x*v/2.0;
+    }
+
+    double F2(double x) const
+    {
+        const double v = std::abs(x);
+        const double odd = v*v*v*inv_a*h2(b_a*v);
+        return ((x < 0.0) ? -odd : odd) + c*v*v*v/6.0;
+    }
+};
+
+/**
+   Integrals from 0 to v of 1 / Q(t) and t / Q(t) with Q(t) = a + b*t + c*t^2, c != 0 and no root of Q in [0, v],
+   and the integral of the latter once more.
+ */
+struct SatQuadraticIntegrals
+{
+    double a, b, c;
+
+    // Discriminant 4ac - b^2, and with r its square root: 1 / a, 1 / 2c, 2c / r, b / r and the factor of i0
+    double d;
+    double inv_a, inv_2c, c_r, b_r, i0_scale;
+
+    void init(double a, double b, double c)
+    {
+        this->a = a;
+        this->b = b;
+        this->c = c;
+
+        d = 4.0*a*c - b*b;
+        inv_a = 1.0/a;
+        inv_2c = 0.5/c;
+
+        const double r = std::sqrt(std::abs(d));
+        c_r = (d != 0.0) ? 2.0*c/r : 0.0;
+        b_r = (d != 0.0) ? b/r : 0.0;
+        i0_scale = (d > 0.0) ? 2.0/r : (d < 0.0) ? 1.0/r : 0.0;
+    }
+
+    void integrate(double v, double& i0, double& i1, double& ii1) const
+    {
+        const double log_q = std::log1p((b + c*v)*v*inv_a);
+
+        if (d > 0.0) {
+            // atan(X) - atan(Y) = atan((X - Y) / (1 + XY)), without cancellation for small v, with X = (2cv + b) / r
+            // and Y = b / r. X - Y is not negative, so past 1 + XY = 0 the difference is pi more than the atan.
+            const double x = c_r*v + b_r;
+            const double num = c_r*v;
+            const double den = 1.0 + x*b_r;
+            const double angle = (den != 0.0) ? std::atan(num/den) : 0.5*M_PI;
+            i0 = i0_scale*((den < 0.0) ? angle + M_PI : angle);
+        }
+        else if (d < 0.0) {
+            const double x = c_r*v + b_r;
+            i0 = i0_scale*std::log1p(2.0*(x - b_r)/((x + 1.0)*(b_r - 1.0)));
+        }
+        else {
+            i0 = 4.0*c*v/(b*(2.0*c*v + b));
+        }
+
+        i1 = (log_q - b*i0)*inv_2c;
+        ii1 = (v*log_q - 2.0*v + 2.0*a*i0 + 2.0*b*i1 - b*v*i0)*inv_2c;
+    }
+};
+
+// -----------------------------------------------------------------------------------------------------------
+// Antiderivatives of the curves in saturation.h
+
+template <int KERNEL>
+struct SatAntiderivative;
+
+template <>
+struct SatAntiderivative<SAT_KERNEL_PIECEWISE>
+{
+    SatPiecewiseAntiderivative p;
+
+    SatAntiderivative(const SatCoeffs& c)
+    {
+        // The upper knee is tested first, so the lower line ends where the upper one starts if they overlap
+        p.hi = (double)c.p2/c.p0;
+        p.lo = std::fmin((double)c.p4/c.p0, p.hi);
+
+        p.q[0][0] = c.bn; p.q[0][1] = c.p3; p.q[0][2] = 0.0;
+        p.q[1][0] = 0.0;  p.q[1][1] = c.p0; p.q[1][2] = 0.0;
+        p.q[2][0] = c.bp; p.q[2][1] = c.p1; p.q[2][2] = 0.0;
+        p.init();
+    }
+
+    double F1(double x) const { return p.F1(x); }
+    double F2(double x) const { return p.F2(x); }
+};
+
+template <>
+struct SatAntiderivative<SAT_KERNEL_RATIONAL>
+{
+    SatRationalAntiderivative r;
+
+    SatAntiderivative(const SatCoeffs& c)
+    {
+        r.init(c.p1, c.p0, c.p2);
+    }
+
+    double F1(double x) const { return r.F1(x); }
+    double F2(double x) const { return r.F2(x); }
+};
+
+template <>
+struct SatAntiderivative<SAT_KERNEL_TUBE>
+{
+    SatPiecewiseAntiderivative p;
+
+    SatAntiderivative(const SatCoeffs& c)
+    {
+        // The curve is written in s = p0*x
+        const double g = c.p0;
+        p.lo = -0.6f/g;
+        p.hi = 0.6f/g;
+
+        p.q[0][0] = c.p3;  p.q[0][1] = c.p2*g; p.q[0][2] = c.p1*g*g;
+        p.q[1][0] = 0.0;   p.q[1][1] = g;      p.q[1][2] = 0.0;
+        p.q[2][0] = -c.p3; p.q[2][1] = c.p2*g; p.q[2][2] = -c.p1*g*g;
+        p.init();
+    }
+
+    double F1(double x) const { return p.F1(x); }
+    double F2(double x) const { return p.F2(x); }
+};
+
+template <>
+struct SatAntiderivative<SAT_KERNEL_MECH>
+{
+    SatPiecewiseAntiderivative p;
+
+    SatAntiderivative(const SatCoeffs& c)
+    {
+        // The curve is written in s = p0*x
+        const double g = c.p0;
+        p.lo = -0.75f/g;
+        p.hi = 0.75f/g;
+
+        p.q[0][0] = c.p2;  p.q[0][1] = c.p1*g; p.q[0][2] = 0.0;
+        p.q[1][0] = 0.0;   p.q[1][1] = g;      p.q[1][2] = 0.0;
+        p.q[2][0] = -c.p2; p.q[2][1] = c.p1*g; p.q[2][2] = 0.0;
+        p.init();
+    }
+
+    double F1(double x) const { return p.F1(x); }
+    double F2(double x) const { return p.F2(x); }
+};
+
+template <>
+struct SatAntiderivative<SAT_KERNEL_LOWGAIN>
+{
+    // f(x) = x / (a + b|x| + c x^2) + d|x|
+    SatQuadraticIntegrals q;
+    double d;
+
+    SatAntiderivative(const SatCoeffs& k)
+        : d(k.p3)
+    {
+        q.init(k.p0, k.p1, k.p2);
+    }
+
+    double F1(double x) const
+    {
+        const double v = std::abs(x);
+        double i0, i1, ii1;
+        q.integrate(v, i0, i1, ii1);
+        return i1 + d*x*v/2.0;
+    }
+
+    double F2(double x) const
+    {
+        const double v = std::abs(x);
+        double i0, i1, ii1;
+        q.integrate(v, i0, i1, ii1);
+        return ((x < 0.0) ? -ii1 : ii1) + d*v*v*v/6.0;
+    }
+};
+
+template <>
+struct SatAntiderivative<SAT_KERNEL_HIGHGAIN>
+{
+    // Below 0 the curve is rational, above 0 it is p3*(p4 + (e*x - p4*p7) / Q(x)) + p8*x,
+    // with Q(x) = x^2 + p6*x + p7 and e = p5 - p4*p6
+    SatRationalAntiderivative neg;
+    SatQuadraticIntegrals q;
+    double p3, p4, p7, p8, e;
+
+    SatAntiderivative(const SatCoeffs& c)
+        : p3(c.p3), p4(c.p4), p7(c.p7), p8(c.p8), e((double)c.p5 - (double)c.p4*c.p6)
+    {
+        neg.init(c.p0, c.p1, c.p2);
+        q.init(c.p7, c.p6, 1.0);
+    }
+
+    double F1(double x) const
+    {
+        if (x < 0.0) {
+            return neg.F1(x);
+        }
+
+        double i0, i1, ii1;
+        q.integrate(x, i0, i1, ii1);
+        return p3*(p4*x + e*i1 - p4*p7*i0) + p8*x*x/2.0;
+    }
+
+    double F2(double x) const
+    {
+        if (x < 0.0) {
+            return neg.F2(x);
+        }
+
+        double i0, i1, ii1;
+        q.integrate(x, i0, i1, ii1);
+        return p3*(p4*x*x/2.0 + e*ii1 - p4*p7*(x*i0 - i1)) + p8*x*x*x/6.0;
+    }
+};
+
+/**
+   D = mean of F1 between @a x0 and @a x1, given F2 at both.
+ */
+template <typename ANTIDERIVATIVE>
+static inline double sat_adaa_mean(const ANTIDERIVATIVE& ad, double x0, double x1, double f2_x0, double f2_x1)
+{
+    const double dx = x0 - x1;
+
+    if (std::abs(dx) < SAT_ADAA_QUADRATURE_WIDTH) {
+        // Gauss-Legendre nodes at +-1/sqrt(3) of the half width
+        const double mid = 0.5*(x0 + x1);
+        const double h = 0.28867513459481287*dx;
+        return 0.5*(ad.F1(mid - h) + ad.F1(mid + h));
+    }
+
+    return (f2_x0 - f2_x1)/dx;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------------
+// Block kernels
+
+/**
+   Like sat_block(), with first order ADAA, and the gains ramped by @a dwet and @a ddry per sample. The samples
+   before this block are taken from @a state.
+ */
+template <int KERNEL>
+static void sat_block_adaa1(const float* in, float* out, uint32_t frames, const SatCoeffs& c,
+                            float wet, float dry, float dwet, float ddry, SatAdaaState& state)
+{
+    const SatAntiderivative<KERNEL> ad(c);
+
+    // F1 of the previous sample is evaluated again, since the coefficients may have changed
+    double x1 = state.x1;
+    double x2 = state.x2;
+    double f1_x1 = ad.F1(x1);
+
+    for (uint32_t n = 0; n < frames; n++) {
+        const double x0 = in[n];
+        const double f1_x0 = ad.F1(x0);
+        const double dx = x0 - x1;
+        const double mid = 0.5*(x0 + x1);
+
+        const double y = (std::abs(dx) < SAT_ADAA_TOLERANCE)
+            ? SatCurve<KERNEL>::apply(c, mid)
+            : (f1_x0 - f1_x1)/dx;
+
+        out[n] = (float)((wet + (double)n*dwet)*y + (dry + (double)n*ddry)*mid);
+
+        x2 = x1;
+        x1 = x0;
+        f1_x1 = f1_x0;
+    }
+
+    state.x1 = x1;
+    state.x2 = x2;
+}
+
+/**
+   Like sat_block(), with second order ADAA, and the gains ramped by @a dwet and @a ddry per sample. The samples
+   before this block are taken from @a state.
+ */
+template <int KERNEL>
+static void sat_block_adaa2(const float* in, float* out, uint32_t frames, const SatCoeffs& c,
+                            float wet, float dry, float dwet, float ddry, SatAdaaState& state)
+{
+    const SatAntiderivative<KERNEL> ad(c);
+
+    double x1 = state.x1;
+    double x2 = state.x2;
+    double f2_x1 = ad.F2(x1);
+
+    // D[n-1], from the previous two samples
+    double d1 = sat_adaa_mean(ad, x1, x2, f2_x1, ad.F2(x2));
+
+    for (uint32_t n = 0; n < frames; n++) {
+        const double x0 = in[n];
+        const double f2_x0 = ad.F2(x0);
+
+        const double d0 = sat_adaa_mean(ad, x0, x1, f2_x0, f2_x1);
+
+        double y;
+
+        if (std::abs(x0 - x2) < SAT_ADAA_TOLERANCE) {
+            // x[n] and x[n-2] coincide, so the mean is taken between their midpoint and x[n-1]
+            const double xbar = 0.5*(x0 + x2);
+            const double delta = xbar - x1;
+
+            if (std::abs(delta) < SAT_ADAA_TOLERANCE) {
+                y = SatCurve<KERNEL>::apply(c, 0.5*(xbar + x1));
+            }
+            else {
+                y = 2.0/delta*(ad.F1(xbar) + (f2_x1 - ad.F2(xbar))/delta);
+            }
+        }
+        else {
+            y = 2.0*(d0 - d1)/(x0 - x2);
+        }
+
+        out[n] = (float)((wet + (double)n*dwet)*y + (dry + (double)n*ddry)*(x0 + x1 + x2)/3.0);
+
+        x2 = x1;
+        x1 = x0;
+        f2_x1 = f2_x0;
+        d1 = d0;
+    }
+
+    state.x1 = x1;
+    state.x2 = x2;
+}
+
+static const SatAdaaFunc sat_adaa_funcs[2][NUM_SAT_KERNELS] = {
+    {
+        sat_block_adaa1<SAT_KERNEL_PIECEWISE>,
+        sat_block_adaa1<SAT_KERNEL_RATIONAL>,
+        sat_block_adaa1<SAT_KERNEL_TUBE>,
+        sat_block_adaa1<SAT_KERNEL_MECH>,
+        sat_block_adaa1<SAT_KERNEL_LOWGAIN>,
+        sat_block_adaa1<SAT_KERNEL_HIGHGAIN>,
+    },
+    {
+        sat_block_adaa2<SAT_KERNEL_PIECEWISE>,
+        sat_block_adaa2<SAT_KERNEL_RATIONAL>,
+        sat_block_adaa2<SAT_KERNEL_TUBE>,
+        sat_block_adaa2<SAT_KERNEL_MECH>,
+        sat_block_adaa2<SAT_KERNEL_LOWGAIN>,
+        sat_block_adaa2<SAT_KERNEL_HIGHGAIN>,
+    },
+};
+
+/**
+   Remember the last input samples of a block processed without ADAA, so ADAA can be switched on without a click.
+   Call it before processing the block, which may overwrite @a in.
+ */
+static inline void sat_adaa_history(const float* in, uint32_t frames, SatAdaaState& state)
+{
+    if (frames > 0) {
+        state.x2 = (frames > 1) ? in[frames - 2] : state.x1;
+        state.x1 = in[frames - 1];
+    }
+}
+
+#endif // ADAA_H_INCLUDED
@@ -0,0 +1,480 @@
+/*
+ * Batch processor, see batch.h.
+ */
+
+#include <cstring>
+
+#include "batch.h"
+#include "denormals.h"
+
+/**
+   Set lane @a l of @a lc to coefficients @a c and gains @a wet and @a dry.
+ */
+static void sat_lane_set(SatLaneCoeffs& lc, uint32_t l, const SatCoeffs& c, float wet, float dry)
+{
+    lc.p0[l] = c.p0;
+    lc.p1[l] = c.p1;
+    lc.p2[l] = c.p2;
+    lc.p3[l] = c.p3;
+    lc.p4[l] = c.p4;
+    lc.p5[l] = c.p5;
+    lc.p6[l] = c.p6;
+    lc.p7[l] = c.p7;
+    lc.p8[l] = c.p8;
+    lc.p9[l] = c.p9;
+    lc.bp[l] = c.bp;
+    lc.bn[l] = c.bn;
+    lc.wet[l] = wet;
+    lc.dry[l] = dry;
+}
+
+/**
+   Run the ramp kernel of segment @a s on @a frames samples, entering its ramp @a offset samples in.
+ */
+static void sat_batch_ramp(const SatKernels* kernels, const float* in, float* out, uint32_t frames,
+                           const SatSegment& s, uint32_t offset)
+{
+    if (offset == 0) {
+        kernels->ramp[s.kernel](in, out, frames, s.c, s.dc, s.wet, s.dry, s.dwet, s.ddry);
+        return;
+    }
+
+    const float t = (float)offset;
+    const SatCoeffs k = sat_coeffs_ramp(s.c, s.dc, t);
+
+    kernels->ramp[s.kernel](in, out, frames, k, s.dc, s.wet + t*s.dwet, s.dry + t*s.ddry, s.dwet, s.ddry);
+}
+
+/**
+   Division mode of the kernels for evaluation mode @a evaluation. Without lookup tables, SAT_EVAL_LUT is exact.
+ */
+static int sat_batch_math(int evaluation)
+{
+    return (evaluation == SAT_EVAL_APPROX) ? SAT_MATH_APPROX : SAT_MATH_EXACT;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+SatBatch::Strip::Strip()
+    : saturation(0.0f),
+      volume(1.0f),
+      mix(1.0f),
+      type(0),
+      type_active(0),
+      kernel_active(sat_coeffs_kernel(0, 0.0f)),
+      fade_type(0),
+      fade_kernel(kernel_active),
+      fade_remaining(0),
+      fading(false),
+      segment_type(0),
+      cached(false)
+{
+}
+
+SatBatch::SatBatch(uint32_t count, uint32_t channels)
+    : kernels(sat_kernels_detect(&isa)),
+      num_strips(count),
+      channels(channels),
+      sample_rate(48000.0),
+      smoothing_time(SAT_SMOOTHING_TIME_MS),
+      fade_length(0),
+      evaluation(SAT_EVAL_EXACT),
+      strips(count),
+      order(count*channels),
+      groups((count*channels + SAT_LANES - 1)/SAT_LANES + SAT_BATCH_KEYS),
+      num_groups(0),
+      fades(0),
+      copies(0),
+      packed(false),
+      interleaved(SAT_BATCH_PACK_FRAMES*SAT_LANES),
+      silence(SAT_BATCH_PACK_FRAMES),
+      spare(SAT_BATCH_PACK_FRAMES),
+      fade_buffer(SAT_FADE_CHUNK)
+{
+    updateSmoothingLength();
+}
+
+uint32_t SatBatch::getStrips() const
+{
+    return num_strips;
+}
+
+uint32_t SatBatch::getChannels() const
+{
+    return channels;
+}
+
+void SatBatch::setSampleRate(double rate)
+{
+    sample_rate = rate;
+    updateSmoothingLength();
+}
+
+void SatBatch::setSmoothingTime(float ms)
+{
+    smoothing_time = ms;
+    updateSmoothingLength();
+}
+
+void SatBatch::updateSmoothingLength()
+{
+    const uint32_t length = (uint32_t)(smoothing_time*0.001*sample_rate + 0.5);
+
+    fade_length = length;
+
+    for (uint32_t i = 0; i < num_strips; i++) {
+        strips[i].saturation.setLength(length);
+        strips[i].volume.setLength(length);
+        strips[i].mix.setLength(length);
+
+        if (strips[i].fade_remaining > length) {
+            strips[i].fade_remaining = length;
+        }
+    }
+}
+
+void SatBatch::setSaturation(uint32_t strip, float percent)
+{
+    strips[strip].saturation.setTarget(percent);
+}
+
+void SatBatch::setType(uint32_t strip, int type)
+{
+    strips[strip].type = type;
+}
+
+void SatBatch::setMasterVolume(uint32_t strip, float db)
+{
+    strips[strip].volume.setTarget(sat_volume_gain(db));
+}
+
+void SatBatch::setMasterMix(uint32_t strip, float percent)
+{
+    strips[strip].mix.setTarget(percent/100.0);
+}
+
+void SatBatch::setParameter(uint32_t strip, uint32_t index, float value)
+{
+    switch (index) {
+    case SAT_PARAM_SATURATION:
+        setSaturation(strip, value);
+        break;
+
+    case SAT_PARAM_TYPE:
+        setType(strip, (int)value);
+        break;
+
+    case SAT_PARAM_MASTERVOLUME:
+        setMasterVolume(strip, value);
+        break;
+
+    case SAT_PARAM_MASTERMIX:
+        setMasterMix(strip, value);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void SatBatch::setEvaluation(int mode)
+{
+    evaluation = mode;
+    kernels = sat_kernels_isa(isa, sat_batch_math(evaluation));
+}
+
+void SatBatch::reset()
+{
+    for (uint32_t i = 0; i < num_strips; i++) {
+        strips[i].saturation.snap();
+        strips[i].volume.snap();
+        strips[i].mix.snap();
+        strips[i].type_active = strips[i].type;
+        strips[i].kernel_active = sat_coeffs_kernel(strips[i].type, strips[i].saturation.getValue());
+        strips[i].fade_remaining = 0;
+        strips[i].cached = false;
+    }
+    packed = false;
+}
+
+bool SatBatch::setIsa(const char* isa)
+{
+    const SatKernels* funcs = sat_kernels_isa(isa, sat_batch_math(evaluation));
+
+    if (funcs == NULL) {
+        return false;
+    }
+
+    kernels = funcs;
+    this->isa = isa;
+    return true;
+}
+
+const char* SatBatch::getIsa() const
+{
+    return isa;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void SatBatch::process(const float* const* inputs, float* const* outputs, uint32_t frames)
+{
+    const SatDenormalGuard guard;
+
+    for (uint32_t i = 0; i < num_strips; i++) {
+        strips[i].saturation.update();
+        strips[i].volume.update();
+        strips[i].mix.update();
+    }
+
+    for (uint32_t pos = 0; pos < frames; ) {
+        // A new type or kernel fades in from the one in effect, unless a fade is still running, see SatProcessor
+        for (uint32_t i = 0; i < num_strips; i++) {
+            Strip& strip = strips[i];
+            const int kernel = sat_coeffs_kernel(strip.type, strip.saturation.getGoal());
+
+            if ((strip.type != strip.type_active || kernel != strip.kernel_active) && strip.fade_remaining == 0) {
+                strip.fade_type = strip.type_active;
+                strip.fade_kernel = strip.kernel_active;
+                strip.type_active = strip.type;
+                strip.kernel_active = kernel;
+                strip.fade_remaining = fade_length;
+            }
+        }
+
+        // Up to where the next ramp or fade of any strip ends
+        uint32_t n = frames - pos;
+
+        for (uint32_t i = 0; i < num_strips; i++) {
+            const uint32_t a = strips[i].saturation.getRemaining();
+            const uint32_t b = strips[i].volume.getRemaining();
+            const uint32_t c = strips[i].mix.getRemaining();
+            const uint32_t d = strips[i].fade_remaining;
+
+            if (a > 0 && a < n) n = a;
+            if (b > 0 && b < n) n = b;
+            if (c > 0 && c < n) n = c;
+            if (d > 0 && d < n) n = d;
+        }
+
+        for (uint32_t i = 0; i < num_strips; i++) {
+            if (prepareSegment(strips[i], n)) {
+                packed = false;
+            }
+        }
+
+        if (!packed) {
+            pack();
+        }
+        processSegment(inputs, outputs, pos, n);
+
+        pos += n;
+    }
+}
+
+/**
+   Advance the smoothers and the fade of @a strip by @a frames frames, and set up its segment, unless it is settled
+   and kept. While a type fades in, the segment of the old type fades out, like in SatProcessor::prepareFade().
+   Returns true if the segment was set up.
+ */
+bool SatBatch::prepareSegment(Strip& strip, uint32_t frames)
+{
+    const int type = strip.type_active;
+
+    if (strip.cached && strip.segment_type == type && strip.fade_remaining == 0
+        && strip.saturation.getRemaining() == 0 && strip.volume.getRemaining() == 0
+        && strip.mix.getRemaining() == 0) {
+        return false;
+    }
+
+    const float saturation0 = strip.saturation.getValue();
+    const float saturation1 = strip.saturation.advance(frames);
+    const float volume0 = strip.volume.getValue();
+    const float volume1 = strip.volume.advance(frames);
+    const float mix0 = strip.mix.getValue();
+    const float mix1 = strip.mix.advance(frames);
+
+    sat_segment_prepare(strip.segment, type, strip.kernel_active, saturation0, saturation1, volume0, volume1, mix0,
+                        mix1, frames);
+    strip.segment_type = type;
+    strip.fading = (strip.fade_remaining > 0);
+
+    if (strip.fading) {
+        SatSegment& old = strip.fade_segment;
+
+        const float fade0 = 1.0f - (float)strip.fade_remaining/fade_length;
+        strip.fade_remaining -= frames;
+        const float fade1 = 1.0f - (float)strip.fade_remaining/fade_length;
+
+        sat_segment_prepare(old, strip.fade_type, strip.fade_kernel, saturation0, saturation1, volume0, volume1, mix0,
+                            mix1, frames);
+        sat_segment_fade(old, 1.0f - fade0, 1.0f - fade1, frames);
+        old.dry = 0.0f;
+        old.ddry = 0.0f;
+
+        sat_segment_fade(strip.segment, fade0, fade1, frames);
+    }
+
+    strip.cached = !strip.segment.ramp;
+    return true;
+}
+
+/**
+   Sort the channels by kernel and ramp, and pack those that run a curve into groups of up to SAT_LANES, with the
+   coefficients of their segments. Channels that are muted or copied go last.
+ */
+void SatBatch::pack()
+{
+    uint32_t counts[SAT_BATCH_KEY_COPY + 1] = {};
+
+    for (uint32_t i = 0; i < num_strips; i++) {
+        counts[key(strips[i])] += channels;
+    }
+
+    uint32_t starts[SAT_BATCH_KEY_COPY + 1];
+    uint32_t ends[SAT_BATCH_KEY_COPY + 1];
+    uint32_t total = 0;
+
+    for (int k = 0; k <= SAT_BATCH_KEY_COPY; k++) {
+        starts[k] = ends[k] = total;
+        total += counts[k];
+    }
+
+    for (uint32_t i = 0; i < num_strips; i++) {
+        const int k = key(strips[i]);
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            order[ends[k]++] = i*channels + ch;
+        }
+    }
+
+    num_groups = 0;
+
+    for (int k = 0; k < SAT_BATCH_KEYS; k++) {
+        for (uint32_t first = starts[k]; first < ends[k]; first += SAT_LANES) {
+            Group& g = groups[num_groups++];
+
+            g.kernel = k/2;
+            g.ramp = (k & 1) != 0;
+            g.first = first;
+            g.used = (ends[k] - first < SAT_LANES) ? ends[k] - first : SAT_LANES;
+
+            // Unused lanes repeat the coefficients of the first one
+            for (uint32_t l = 0; l < SAT_LANES; l++) {
+                const SatSegment& s = strips[order[first + ((l < g.used) ? l : 0)]/channels].segment;
+
+                sat_lane_set(g.c, l, s.c, s.wet, s.dry);
+                if (g.ramp) {
+                    sat_lane_set(g.dc, l, s.dc, s.dwet, s.ddry);
+                }
+            }
+        }
+    }
+
+    fades = starts[SAT_BATCH_KEY_FADE];
+    copies = starts[SAT_BATCH_KEY_COPY];
+    packed = true;
+}
+
+/**
+   Key of the channels of strip @a strip in pack(): the kernel of its segment and whether it ramps,
+   SAT_BATCH_KEY_FADE if it crossfades types, or SAT_BATCH_KEY_COPY if the output is muted or a copy of the input.
+ */
+int SatBatch::key(const Strip& strip)
+{
+    const SatSegment& s = strip.segment;
+
+    if (strip.fading) {
+        return SAT_BATCH_KEY_FADE;
+    }
+    if (!s.ramp && s.wet == 0.0f) {
+        return SAT_BATCH_KEY_COPY;
+    }
+    return 2*s.kernel + (s.ramp ? 1 : 0);
+}
+
+/**
+   Process frames @a pos to @a pos + @a frames of all strips as packed by pack(). Segments shorter than
+   SAT_BATCH_PACK_FRAMES are interleaved group by group and run through the lane kernels.
+ */
+void SatBatch::processSegment(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames)
+{
+    // Muted, or a copy of the input at the dry gain
+    for (uint32_t j = copies; j < num_strips*channels; j++) {
+        const float dry = strips[order[j]/channels].segment.dry;
+        const float* const in = inputs[order[j]] + pos;
+        float* const out = outputs[order[j]] + pos;
+
+        if (dry == 0.0f) {
+            std::memset(out, 0, frames*sizeof(float));
+            continue;
+        }
+        for (uint32_t n = 0; n < frames; n++) {
+            out[n] = in[n]*dry;
+        }
+    }
+
+    // Crossfading strips channel by channel, chunk by chunk, like SatProcessor::saturate()
+    float* const old = &fade_buffer[0];
+
+    for (uint32_t j = fades; j < copies; j++) {
+        const Strip& strip = strips[order[j]/channels];
+        const float* const in = inputs[order[j]] + pos;
+        float* const out = outputs[order[j]] + pos;
+
+        for (uint32_t i = 0; i < frames; i += SAT_FADE_CHUNK) {
+            const uint32_t n = (frames - i < SAT_FADE_CHUNK) ? frames - i : SAT_FADE_CHUNK;
+
+            // Before the new curve, as the output may be the input
+            sat_batch_ramp(kernels, in + i, old, n, strip.fade_segment, i);
+            sat_batch_ramp(kernels, in + i, out + i, n, strip.segment, i);
+
+            for (uint32_t k = 0; k < n; k++) {
+                out[i + k] += old[k];
+            }
+        }
+    }
+
+    float* const x = &interleaved[0];
+
+    for (uint32_t k = 0; k < num_groups; k++) {
+        const Group& g = groups[k];
+
+        // Segments long enough to fill vectors with frames run channel by channel
+        if (frames >= SAT_BATCH_PACK_FRAMES) {
+            for (uint32_t j = g.first; j < g.first + g.used; j++) {
+                const SatSegment& s = strips[order[j]/channels].segment;
+                const float* const in = inputs[order[j]] + pos;
+                float* const out = outputs[order[j]] + pos;
+
+                if (!g.ramp) {
+                    kernels->block[g.kernel](in, out, frames, s.c, s.wet, s.dry);
+                }
+                else {
+                    kernels->ramp[g.kernel](in, out, frames, s.c, s.dc, s.wet, s.dry, s.dwet, s.ddry);
+                }
+            }
+            continue;
+        }
+
+        // Unused lanes read silence and write to a spare buffer
+        const float* in[SAT_LANES];
+        float* out[SAT_LANES];
+
+        for (uint32_t l = 0; l < SAT_LANES; l++) {
+            in[l] = (l < g.used) ? inputs[order[g.first + l]] + pos : &silence[0];
+            out[l] = (l < g.used) ? outputs[order[g.first + l]] + pos : &spare[0];
+        }
+
+        kernels->interleave(in, x, g.used, frames);
+
+        if (!g.ramp) {
+            kernels->lanes[g.kernel](x, x, g.used, frames, g.c);
+        }
+        else {
+            kernels->lanes_ramp[g.kernel](x, x, g.used, frames, g.c, g.dc);
+        }
+
+        kernels->deinterleave(x, out, g.used, frames);
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * Batch processor
+ *
+ * Runs many channel strips in one call, e.g. the channels of a mixing server
+ * that would otherwise each be a plugin instance processing small blocks.
+ * Every strip has a saturation type, saturation, master volume and master mix
+ * of its own, smoothed like those of SatProcessor, and all strips have the
+ * same channel count. A new type fades in over the smoothing time, like in
+ * SatProcessor, and so does the other kernel of types 4 and 5. The channels of a strip that crossfades run on their own,
+ * with both curves, until the fade has ended.
+ *
+ * The channels of all strips are sorted by kernel once, and grouped SAT_LANES
+ * at a time with the coefficients of each channel side by side, the layout of
+ * the lane kernels (see saturation.h). While no strip starts or ends a ramp,
+ * the groups and their coefficients are kept from call to call, so a settled
+ * strip costs no more than running its kernel.
+ *
+ * A channel with many frames fills vectors with frames of its own, so long
+ * segments run channel by channel. Short ones, where the frames of a channel
+ * would leave most of a vector empty, are interleaved, so one pass of a curve
+ * serves the same frame of up to SAT_LANES channels, whichever strips they
+ * belong to.
+ *
+ * A batch covers the plain signal chain only: there is no oversampling, ADAA
+ * or lookup table evaluation, and no silence shortcut. Muted strips and strips
+ * at a mix of 0 % are still cleared or copied without running a curve. A strip
+ * in a batch gives the same output as a SatProcessor with the same settings,
+ * up to rounding where the compiler reorders arithmetic.
+ */
+
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "processor.h"
+
+// Segments shorter than this are packed across lanes, see processSegment()
+#define SAT_BATCH_PACK_FRAMES 16
+
+// Channels are sorted by kernel, and within a kernel into settled and ramping ones. After them come the channels
+// of strips that crossfade types, and last those without a curve.
+#define SAT_BATCH_KEYS (2*NUM_SAT_KERNELS)
+#define SAT_BATCH_KEY_FADE SAT_BATCH_KEYS
+#define SAT_BATCH_KEY_COPY (SAT_BATCH_KEYS + 1)
+
+class SatBatch
+{
+public:
+    /**
+       Create a batch of @a count strips of @a channels channels each.
+       This allocates all buffers, and picks the SIMD kernels for this CPU.
+     */
+    SatBatch(uint32_t count, uint32_t channels);
+
+    uint32_t getStrips() const;
+    uint32_t getChannels() const;
+
+    /**
+       Sample rate in Hz, which sets the length of the smoothing ramps of all strips.
+     */
+    void setSampleRate(double rate);
+
+    /**
+       Length of the smoothing ramps in milliseconds, SAT_SMOOTHING_TIME_MS by default.
+     */
+    void setSmoothingTime(float ms);
+
+    /**
+       Saturation of strip @a strip in percent, 0 to 100, smoothed, see SatProcessor::setSaturation().
+     */
+    void setSaturation(uint32_t strip, float percent);
+
+    /**
+       Saturation type of strip @a strip, 0 to NUM_SATURATIONS - 1, crossfaded like SatProcessor::setType().
+     */
+    void setType(uint32_t strip, int type);
+
+    /**
+       Master volume of strip @a strip in dB, smoothed. Below -50 dB the strip is muted.
+     */
+    void setMasterVolume(uint32_t strip, float db);
+
+    /**
+       Amount of saturated signal of strip @a strip in percent, 0 to 100, smoothed.
+     */
+    void setMasterMix(uint32_t strip, float percent);
+
+    /**
+       Set parameter @a index of strip @a strip, one of SAT_PARAM_*. Oversampling, anti-aliasing and the
+       multiband parameters are ignored.
+     */
+    void setParameter(uint32_t strip, uint32_t index, float value);
+
+    /**
+       How the curves are evaluated, SAT_EVAL_EXACT or SAT_EVAL_APPROX. SAT_EVAL_LUT evaluates them exactly.
+     */
+    void setEvaluation(int mode);
+
+    /**
+       Clear the coefficients kept from the last call and end all ramps.
+     */
+    void reset();
+
+    /**
+       Process @a frames frames of all strips. Channel @a ch of strip @a strip is inputs[strip*channels + ch] and
+       outputs[strip*channels + ch]. The output of a channel may be the same buffer as its input.
+     */
+    void process(const float* const* inputs, float* const* outputs, uint32_t frames);
+
+    /**
+       Use the kernels of instruction set @a isa instead of the detected ones, see sat_kernels_isa().
+       Returns false if they are not available.
+     */
+    bool setIsa(const char* isa);
+
+    /**
+       Name of the instruction set of the kernels in use.
+     */
+    const char* getIsa() const;
+
+private:
+    struct Strip
+    {
+        Strip();
+
+        SatSmoother saturation;
+        SatSmoother volume;
+        SatSmoother mix;
+
+        // Type set, and type and kernel in effect
+        int type;
+        int type_active;
+        int kernel_active;
+
+        // While a type or kernel fades in, those it replaces, the frames left, and the segment of the old curve.
+        // Whether the current segment crossfades.
+        int fade_type;
+        int fade_kernel;
+        uint32_t fade_remaining;
+        SatSegment fade_segment;
+        bool fading;
+
+        // Segment of the last call, which a settled strip keeps while its type stays the same
+        SatSegment segment;
+        int segment_type;
+        bool cached;
+    };
+
+    // Up to SAT_LANES channels of the same kernel, order[first] to order[first + used - 1]
+    struct Group
+    {
+        int kernel;
+        bool ramp;
+        uint32_t first;
+        uint32_t used;
+
+        SatLaneCoeffs c, dc;
+    };
+
+    void updateSmoothingLength();
+    bool prepareSegment(Strip& strip, uint32_t frames);
+    void pack();
+    static int key(const Strip& strip);
+    void processSegment(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames);
+
+    const SatKernels* kernels;
+    const char* isa;
+
+    uint32_t num_strips;
+    uint32_t channels;
+
+    double sample_rate;
+    float smoothing_time;
+    uint32_t fade_length;
+
+    int evaluation;
+
+    std::vector<Strip> strips;
+
+    // Channels numbered strip*channels + ch, sorted by kernel and ramp, from order[fades] on, those of crossfading
+    // strips, and from order[copies] on, those without a curve. The groups stay packed while no strip sets up a
+    // new segment.
+    std::vector<uint32_t> order;
+    std::vector<Group> groups;
+    uint32_t num_groups;
+    uint32_t fades;
+    uint32_t copies;
+    bool packed;
+
+    // Interleaved signals of the lane kernels, the input and output of unused lanes, and the output of the old
+    // curve of a crossfading channel
+    std::vector<float> interleaved;
+    std::vector<float> silence;
+    std::vector<float> spare;
+    std::vector<float> fade_buffer;
+};
+
+#endif // BATCH_H_INCLUDED
@@ -0,0 +1,66 @@
+/*
+ * Denormal handling
+ *
+ * Decaying tails, filter histories and ramps towards silence end up in
+ * denormal numbers, which are many times slower than normal ones on most
+ * CPUs. While a SatDenormalGuard is alive, denormal results are flushed to
+ * zero (FTZ) and denormal inputs are read as zero (DAZ). The previous mode is
+ * restored when it goes out of scope, so the host's own code is unaffected.
+ *
+ * Supported on x86 (MXCSR) and AArch64 (FPCR, which has one flag for both).
+ * Elsewhere the guard does nothing.
+ */
+
+#ifndef DENORMALS_H_INCLUDED
+#define DENORMALS_H_INCLUDED
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SAT_DENORMALS_MXCSR
+#elif defined(__aarch64__)
+#define SAT_DENORMALS_FPCR
+#endif
+
+// Flush to zero and denormals are zero, bits 15 and 6 of MXCSR
+#define SAT_MXCSR_FTZ_DAZ 0x8040u
+
+// Flush to zero, bit 24 of FPCR
+#define SAT_FPCR_FZ (1ull << 24)
+
+class SatDenormalGuard
+{
+public:
+    SatDenormalGuard()
+    {
+#if defined(SAT_DENORMALS_MXCSR)
+        mode = _mm_getcsr();
+        _mm_setcsr(mode | SAT_MXCSR_FTZ_DAZ);
+#elif defined(SAT_DENORMALS_FPCR)
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(mode | SAT_FPCR_FZ));
+#endif
+    }
+
+    ~SatDenormalGuard()
+    {
+#if defined(SAT_DENORMALS_MXCSR)
+        _mm_setcsr(mode);
+#elif defined(SAT_DENORMALS_FPCR)
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+#endif
+    }
+
+    SatDenormalGuard(const SatDenormalGuard&) = delete;
+    SatDenormalGuard& operator=(const SatDenormalGuard&) = delete;
+
+private:
+#if defined(SAT_DENORMALS_MXCSR)
+    unsigned int mode;
+#elif defined(SAT_DENORMALS_FPCR)
+    uint64_t mode;
+#endif
+};
+
+#endif // DENORMALS_H_INCLUDED
@@ -0,0 +1,44 @@
+// Halfband lowpass filters for the 2x oversampling stages
+//
+// Kaiser windowed sinc filters of length 4*K - 1. Every other tap of a
+// halfband filter is zero except the center tap, which is 0.5, so only the
+// 2*K remaining taps h[0], h[2], ..., h[4*K - 2] are stored. They are scaled
+// to sum to 0.5 for unity gain at DC.
+//
+// Stage 1 (1x <-> 2x): K = 32, beta = 9, about 90 dB stopband above 24.1 kHz
+//                      at 44.1 kHz with a flat passband to 20 kHz
+// Stage 2 (2x <-> 4x): K = 6, beta = 9
+// Stage 3 (4x <-> 8x): K = 4, beta = 7
+
+#define HALFBAND0_LENGTH 64
+const float halfband0_coeffs[64] = {
+    -4.62016122e-06, 1.3009931e-05, -2.73415828e-05, 5.00015342e-05,
+    -8.39332285e-05, 0.000132693623, -0.000200505968, 0.000292309012,
+    -0.000413803888, 0.000571501423, -0.000772774687, 0.00102592438,
+    -0.00134026839, 0.00172627237, -0.00219574564, 0.00276213836,
+    -0.00344099361, 0.00425063592, -0.00521322446, 0.00635637836,
+    -0.00771572292, 0.00933896768, -0.0112926377, 0.0136736303,
+    -0.0166300835, 0.020401557, -0.0254030734, 0.0324212011,
+    -0.0431462068, 0.0619811923, -0.105087359, 0.317970882,
+    0.317970882, -0.105087359, 0.0619811923, -0.0431462068,
+    0.0324212011, -0.0254030734, 0.020401557, -0.0166300835,
+    0.0136736303, -0.0112926377, 0.00933896768, -0.00771572292,
+    0.00635637836, -0.00521322446, 0.00425063592, -0.00344099361,
+    0.00276213836, -0.00219574564, 0.00172627237, -0.00134026839,
+    0.00102592438, -0.000772774687, 0.000571501423, -0.000413803888,
+    0.000292309012, -0.000200505968, 0.000132693623, -8.39332285e-05,
+    5.00015342e-05, -2.73415828e-05, 1.3009931e-05, -4.62016122e-06
+};
+
+#define HALFBAND1_LENGTH 12
+const float halfband1_coeffs[12] = {
+    -2.64603424e-05, 0.00103004862, -0.00664704937, 0.0252770554,
+    -0.0769506187, 0.307317024, 0.307317024, -0.0769506187,
+    0.0252770554, -0.00664704937, 0.00103004862, -2.64603424e-05
+};
+
+#define HALFBAND2_LENGTH 8
+const float halfband2_coeffs[8] = {
+    -0.000269671192, 0.00939776838, -0.0569304365, 0.297802339,
+    0.297802339, -0.0569304365, 0.00939776838, -0.000269671192
+};
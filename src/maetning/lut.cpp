@@ -0,0 +1,293 @@
+/*
+ * Lookup table builder, see lut.h.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "lut.h"
+
+// Key of no table
+#define SAT_LUT_NO_KEY (~(uint64_t)0)
+
+// -----------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<SatLutCache> SatLutCache::get()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<SatLutCache> current;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<SatLutCache> cache = current.lock();
+
+    if (!cache) {
+        cache.reset(new SatLutCache());
+        current = cache;
+    }
+    return cache;
+}
+
+SatLutCache::SatLutCache()
+    : clock(0),
+      check_x(SAT_LUT_SIZE*SAT_LUT_CHECK_POINTS),
+      check_exact(SAT_LUT_SIZE*SAT_LUT_CHECK_POINTS),
+      check_table(SAT_LUT_SIZE*SAT_LUT_CHECK_POINTS),
+      stop(false)
+{
+    // Points spread evenly within each interval, excluding the table entries themselves
+    const double step = 2.0*SAT_LUT_RANGE/SAT_LUT_SIZE;
+
+    for (uint32_t i = 0; i < SAT_LUT_SIZE; i++) {
+        for (uint32_t k = 0; k < SAT_LUT_CHECK_POINTS; k++) {
+            const double x = -SAT_LUT_RANGE + (i + (k + 0.5)/SAT_LUT_CHECK_POINTS)*step;
+            check_x[i*SAT_LUT_CHECK_POINTS + k] = (float)x;
+        }
+    }
+
+    worker = std::thread(&SatLutCache::run, this);
+}
+
+SatLutCache::~SatLutCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+uint64_t SatLutCache::key(int type, float saturation)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &saturation, sizeof(bits));
+    return ((uint64_t)(uint32_t)type << 32) | bits;
+}
+
+void SatLutCache::attach(SatLutBuilder* builder)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    builders.push_back(builder);
+}
+
+void SatLutCache::detach(SatLutBuilder* builder)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (size_t i = 0; i < builders.size(); i++) {
+        if (builders[i] == builder) {
+            builders.erase(builders.begin() + i);
+            break;
+        }
+    }
+}
+
+void SatLutCache::wait(SatLutBuilder* builder, uint64_t k)
+{
+    wake.notify_one();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        const Table* const table = builder->newest.load();
+
+        if (table != NULL && table->key == k) {
+            break;
+        }
+        done.wait(lock);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void SatLutCache::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!stop) {
+        // Hand out the tables there are, and find the first request without one
+        uint64_t missing = SAT_LUT_NO_KEY;
+        bool published = false;
+
+        for (size_t i = 0; i < builders.size(); i++) {
+            SatLutBuilder* const builder = builders[i];
+            const uint64_t k = builder->requested.load();
+            const Table* const table = builder->newest.load();
+
+            if (k == SAT_LUT_NO_KEY || (table != NULL && table->key == k)) {
+                continue;
+            }
+
+            Table* const found = find(k);
+
+            if (found != NULL) {
+                found->used = ++clock;
+                builder->newest.store(found);
+                published = true;
+            }
+            else if (missing == SAT_LUT_NO_KEY) {
+                missing = k;
+            }
+        }
+
+        if (published) {
+            done.notify_all();
+        }
+
+        if (missing == SAT_LUT_NO_KEY) {
+            // Requests from the audio threads do not wake the worker, and one may slip in between the check and
+            // the wait, so do not sleep for long
+            wake.wait_for(lock, std::chrono::milliseconds(SAT_LUT_POLL_MS));
+            continue;
+        }
+
+        // Nobody reads a spare table, and only the worker hands tables out, so it is built without the lock.
+        // The next pass hands it to every builder that asked for it.
+        Table* const table = spare();
+
+        lock.unlock();
+        build(*table, missing);
+        lock.lock();
+    }
+}
+
+/**
+   The built table of @a k, or NULL.
+ */
+SatLutCache::Table* SatLutCache::find(uint64_t k)
+{
+    for (size_t i = 0; i < tables.size(); i++) {
+        if (tables[i]->key == k) {
+            return tables[i].get();
+        }
+    }
+    return NULL;
+}
+
+/**
+   A table that no builder keeps, the least recently handed out one once there are SAT_LUT_CACHE_TABLES tables,
+   or a new one.
+ */
+SatLutCache::Table* SatLutCache::spare()
+{
+    Table* oldest = NULL;
+
+    for (size_t i = 0; i < tables.size(); i++) {
+        Table* const table = tables[i].get();
+        bool kept = false;
+
+        for (size_t j = 0; j < builders.size() && !kept; j++) {
+            kept = builders[j]->keeps(table);
+        }
+
+        if (!kept && (oldest == NULL || table->used < oldest->used)) {
+            oldest = table;
+        }
+    }
+
+    if (oldest != NULL && tables.size() >= SAT_LUT_CACHE_TABLES) {
+        oldest->key = SAT_LUT_NO_KEY;
+        return oldest;
+    }
+
+    tables.push_back(std::unique_ptr<Table>(new Table()));
+    tables.back()->key = SAT_LUT_NO_KEY;
+    tables.back()->used = 0;
+    return tables.back().get();
+}
+
+/**
+   Sample the curve of @a k into @a table, and measure the largest error of the interpolation.
+ */
+void SatLutCache::build(Table& table, uint64_t k)
+{
+    const int type = (int)(uint32_t)(k >> 32);
+    const uint32_t bits = (uint32_t)k;
+    float saturation;
+    std::memcpy(&saturation, &bits, sizeof(saturation));
+
+    SatCoeffs c;
+    const int kernel = sat_coeffs_interpolate(type, saturation, c);
+    const SatBlockFunc curve = sat_kernels_scalar.block[kernel];
+
+    float x[SAT_LUT_SIZE + 1];
+    for (uint32_t i = 0; i <= SAT_LUT_SIZE; i++) {
+        x[i] = (float)(-SAT_LUT_RANGE + i*(2.0*SAT_LUT_RANGE/SAT_LUT_SIZE));
+    }
+
+    curve(x, table.lut.y, SAT_LUT_SIZE + 1, c, 1.0f, 0.0f);
+    table.lut.y[SAT_LUT_SIZE + 1] = table.lut.y[SAT_LUT_SIZE];
+
+    // Compare with the curve between the entries, where the interpolation is furthest off
+    const uint32_t count = (uint32_t)check_x.size();
+    curve(&check_x[0], &check_exact[0], count, c, 1.0f, 0.0f);
+    sat_block_lut(&check_x[0], &check_table[0], count, table.lut, 1.0f, 0.0f);
+
+    float error = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        const float e = std::fabs(check_table[i] - check_exact[i]);
+        error = (e > error) ? e : error;
+    }
+
+    table.error = error;
+    table.key = k;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+SatLutBuilder::SatLutBuilder()
+    : cache(SatLutCache::get()),
+      newest(NULL),
+      in_use(NULL),
+      requested(SAT_LUT_NO_KEY)
+{
+    cache->attach(this);
+}
+
+SatLutBuilder::~SatLutBuilder()
+{
+    cache->detach(this);
+}
+
+void SatLutBuilder::request(int type, float saturation)
+{
+    requested.store(SatLutCache::key(type, saturation));
+}
+
+const SatLut* SatLutBuilder::acquire(int type, float saturation, float* error)
+{
+    // Announce the table, then check that it is still the newest one. If the worker handed out another table in
+    // between, it may already be writing to the announced one, so try again.
+    SatLutCache::Table* table = newest.load();
+
+    for (;;) {
+        in_use.store(table);
+
+        SatLutCache::Table* const again = newest.load();
+        if (again == table) {
+            break;
+        }
+        table = again;
+    }
+
+    if (table == NULL || table->key != SatLutCache::key(type, saturation)) {
+        return NULL;
+    }
+
+    *error = table->error;
+    return &table->lut;
+}
+
+void SatLutBuilder::wait(int type, float saturation)
+{
+    request(type, saturation);
+    cache->wait(this, SatLutCache::key(type, saturation));
+}
+
+/**
+   Whether the worker has to keep @a table as it is for this builder.
+ */
+bool SatLutBuilder::keeps(const SatLutCache::Table* table) const
+{
+    return newest.load() == table || in_use.load() == table;
+}
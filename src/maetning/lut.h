@@ -0,0 +1,157 @@
+/*
+ * Lookup table builder
+ *
+ * Bakes the curve of one saturation type and amount into a SatLut on a worker
+ * thread, so the audio thread never evaluates a curve to fill a table. Every
+ * table is checked against the curve it was made from, at several points
+ * between the table entries, and the largest difference is kept with it.
+ *
+ * The tables are read-only once built, and a curve has no memory, so its table
+ * does not depend on the sample rate or the oversampling factor. All processors
+ * of a process therefore share one SatLutCache: one worker thread, the buffers
+ * of the check, and the tables themselves, keyed by type and saturation. The
+ * cache lives as long as any SatLutBuilder refers to it, so it is built with
+ * the first processor that uses lookup tables and freed with the last one. A
+ * table asked for by one processor is there for all others at no cost, and
+ * many instances at the same settings read the same memory.
+ *
+ * Each SatLutBuilder is the handle of one processor to the cache. It keeps the
+ * newest table the cache made for it, and the one its audio thread announced
+ * it reads, and the worker never writes to a table any builder keeps, so no
+ * locks are taken on the audio thread. Tables nobody keeps are reused for new
+ * ones, oldest first, once there are SAT_LUT_CACHE_TABLES of them.
+ */
+
+#ifndef LUT_H_INCLUDED
+#define LUT_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "saturation.h"
+
+// Tables kept for reuse while no builder needs them. More are made while all of them are in use.
+#define SAT_LUT_CACHE_TABLES 16
+
+// Points checked per table interval
+#define SAT_LUT_CHECK_POINTS 8
+
+// Interval in which the worker looks for new requests
+#define SAT_LUT_POLL_MS 10
+
+class SatLutBuilder;
+
+/**
+   The tables of all builders of a process, and the worker thread that builds them. Use SatLutBuilder.
+ */
+class SatLutCache
+{
+public:
+    /**
+       The cache of the process, made if there is none. Not realtime safe.
+     */
+    static std::shared_ptr<SatLutCache> get();
+
+    /**
+       Start the worker thread. Not realtime safe.
+     */
+    SatLutCache();
+
+    /**
+       Stop the worker thread. Not realtime safe.
+     */
+    ~SatLutCache();
+
+private:
+    friend class SatLutBuilder;
+
+    struct Table
+    {
+        uint64_t key;
+        float error;
+        uint64_t used;
+        SatLut lut;
+    };
+
+    static uint64_t key(int type, float saturation);
+
+    void attach(SatLutBuilder* builder);
+    void detach(SatLutBuilder* builder);
+    void wait(SatLutBuilder* builder, uint64_t key);
+
+    void run();
+    Table* find(uint64_t key);
+    Table* spare();
+    void build(Table& table, uint64_t key);
+    void publish(Table* table);
+
+    // Builders of all processors, and the tables, which are only freed with the cache
+    std::vector<SatLutBuilder*> builders;
+    std::vector<std::unique_ptr<Table> > tables;
+    uint64_t clock;
+
+    // Sample points of the check
+    std::vector<float> check_x;
+    std::vector<float> check_exact;
+    std::vector<float> check_table;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stop;
+
+    std::thread worker;
+};
+
+class SatLutBuilder
+{
+public:
+    /**
+       Attach to the cache of the process, which starts it if this is the first builder. Not realtime safe.
+     */
+    SatLutBuilder();
+
+    /**
+       Detach from the cache, which stops it if this was the last builder. Not realtime safe.
+     */
+    ~SatLutBuilder();
+
+    /**
+       Ask for the table of saturation @a type at saturation @a saturation in percent. Replaces an earlier request
+       that has not been built yet. Only stores the request, without waking the worker, so it is realtime safe and
+       may be called from any thread. The worker picks it up within SAT_LUT_POLL_MS.
+     */
+    void request(int type, float saturation);
+
+    /**
+       Get the newest table if it was built for @a type and @a saturation, or NULL. Its measured maximum error is
+       written to @a error. The table stays valid until the next call. For the audio thread only.
+     */
+    const SatLut* acquire(int type, float saturation, float* error);
+
+    /**
+       Request a table and block until it is built, e.g. before offline processing. Not realtime safe.
+     */
+    void wait(int type, float saturation);
+
+private:
+    friend class SatLutCache;
+
+    bool keeps(const SatLutCache::Table* table) const;
+
+    std::shared_ptr<SatLutCache> cache;
+
+    // Newest table made for this builder, and the table the audio thread reads, or NULL
+    std::atomic<SatLutCache::Table*> newest;
+    std::atomic<SatLutCache::Table*> in_use;
+
+    // Type and saturation of the table asked for
+    std::atomic<uint64_t> requested;
+};
+
+#endif // LUT_H_INCLUDED
@@ -0,0 +1,484 @@
+/*
+ * Multiband saturation, see multiband.h.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "multiband.h"
+
+// Lowest crossover frequency in Hz, and the highest as a share of the sample rate
+#define SAT_CROSSOVER_MIN_HZ 20.0f
+#define SAT_CROSSOVER_MAX_SHARE 0.45f
+
+// Responses of the biquads of a crossover, see sat_biquad_design()
+#define SAT_BIQUAD_IDENTITY 0
+#define SAT_BIQUAD_LOWPASS 1
+#define SAT_BIQUAD_HIGHPASS 2
+#define SAT_BIQUAD_ALLPASS 3
+
+#define NUM_SAT_BIQUAD_RESPONSES 4
+
+/**
+   Coefficients of one biquad, normalized to a0 = 1.
+ */
+struct SatBiquad
+{
+    float b0, b1, b2, a1, a2;
+};
+
+/**
+   Design @a q as a second order Butterworth @a response at @a frequency Hz, or to pass its input through. Two
+   Butterworth lowpasses or highpasses in a row are a fourth order Linkwitz-Riley filter, and their sum is the
+   allpass of the same frequency, as all of them come from the same bilinear transform.
+ */
+static void sat_biquad_design(SatBiquad& q, int response, double frequency, double rate)
+{
+    const double w = 2.0*M_PI*frequency/rate;
+    const double cosw = std::cos(w);
+    const double alpha = std::sin(w)*M_SQRT1_2;  // sin(w)/(2*Q) with Q = 1/sqrt(2)
+    const double a0 = 1.0 + alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+    switch (response) {
+    case SAT_BIQUAD_LOWPASS:
+        b0 = b2 = 0.5*(1.0 - cosw)/a0;
+        b1 = (1.0 - cosw)/a0;
+        break;
+
+    case SAT_BIQUAD_HIGHPASS:
+        b0 = b2 = 0.5*(1.0 + cosw)/a0;
+        b1 = -(1.0 + cosw)/a0;
+        break;
+
+    case SAT_BIQUAD_ALLPASS:
+        b0 = (1.0 - alpha)/a0;
+        b1 = -2.0*cosw/a0;
+        b2 = 1.0;
+        break;
+
+    default:
+        break;
+    }
+
+    if (response != SAT_BIQUAD_IDENTITY) {
+        a1 = -2.0*cosw/a0;
+        a2 = (1.0 - alpha)/a0;
+    }
+
+    q.b0 = (float)b0;
+    q.b1 = (float)b1;
+    q.b2 = (float)b2;
+    q.a1 = (float)a1;
+    q.a2 = (float)a2;
+}
+
+/**
+   Set biquad @a k of lane @a l of @a f to @a q.
+ */
+static void sat_biquad_set(SatBiquadLanes& f, uint32_t k, uint32_t l, const SatBiquad& q)
+{
+    f.b0[k][l] = q.b0;
+    f.b1[k][l] = q.b1;
+    f.b2[k][l] = q.b2;
+    f.a1[k][l] = q.a1;
+    f.a2[k][l] = q.a2;
+}
+
+/**
+   Set lane @a l of @a lc to coefficients @a c and gains @a wet and @a dry.
+ */
+static void sat_lane_set(SatLaneCoeffs& lc, uint32_t l, const SatCoeffs& c, float wet, float dry)
+{
+    lc.p0[l] = c.p0;
+    lc.p1[l] = c.p1;
+    lc.p2[l] = c.p2;
+    lc.p3[l] = c.p3;
+    lc.p4[l] = c.p4;
+    lc.p5[l] = c.p5;
+    lc.p6[l] = c.p6;
+    lc.p7[l] = c.p7;
+    lc.p8[l] = c.p8;
+    lc.p9[l] = c.p9;
+    lc.bp[l] = c.bp;
+    lc.bn[l] = c.bn;
+    lc.wet[l] = wet;
+    lc.dry[l] = dry;
+}
+
+/**
+   The coefficients and gains c + t*dc of all lanes, to enter a ramp @a t frames in.
+ */
+static void sat_lane_offset(const SatLaneCoeffs& c, const SatLaneCoeffs& dc, float t, SatLaneCoeffs& out)
+{
+    for (uint32_t l = 0; l < SAT_LANES; l++) {
+        out.p0[l] = c.p0[l] + t*dc.p0[l];
+        out.p1[l] = c.p1[l] + t*dc.p1[l];
+        out.p2[l] = c.p2[l] + t*dc.p2[l];
+        out.p3[l] = c.p3[l] + t*dc.p3[l];
+        out.p4[l] = c.p4[l] + t*dc.p4[l];
+        out.p5[l] = c.p5[l] + t*dc.p5[l];
+        out.p6[l] = c.p6[l] + t*dc.p6[l];
+        out.p7[l] = c.p7[l] + t*dc.p7[l];
+        out.p8[l] = c.p8[l] + t*dc.p8[l];
+        out.p9[l] = c.p9[l] + t*dc.p9[l];
+        out.bp[l] = c.bp[l] + t*dc.bp[l];
+        out.bn[l] = c.bn[l] + t*dc.bn[l];
+        out.wet[l] = c.wet[l] + t*dc.wet[l];
+        out.dry[l] = c.dry[l] + t*dc.dry[l];
+    }
+}
+
+/**
+   Whether settled segments @a a and @a b saturate with the same curve and gains.
+ */
+static bool sat_segment_same(const SatSegment& a, const SatSegment& b)
+{
+    return !a.ramp && !b.ramp && a.kernel == b.kernel && a.wet == b.wet && a.dry == b.dry
+        && std::memcmp(&a.c, &b.c, sizeof(SatCoeffs)) == 0;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+SatMultiband::SatMultiband(uint32_t channels)
+    : channels(channels),
+      sample_rate(48000.0),
+      num_bands(2),
+      groups((SAT_MAX_BANDS*channels + SAT_LANES - 1)/SAT_LANES),
+      num_groups(0),
+      valid(false),
+      interleaved(groups.size()*SAT_MULTIBAND_CHUNK*SAT_LANES),
+      split(SAT_MAX_BANDS*channels*SAT_MULTIBAND_CHUNK),
+      silence(SAT_MULTIBAND_CHUNK),
+      spare(SAT_MULTIBAND_CHUNK),
+      fade(channels*SAT_MULTIBAND_CHUNK),
+      band_inputs(channels),
+      band_outputs(channels)
+{
+    for (uint32_t j = 0; j < SAT_MAX_BANDS - 1; j++) {
+        frequencies[j] = 1000.0f;
+    }
+
+    design();
+    reset();
+}
+
+void SatMultiband::setSampleRate(double rate)
+{
+    sample_rate = rate;
+    design();
+}
+
+void SatMultiband::setBands(uint32_t count, const float* crossovers)
+{
+    if (count < 2) count = 2;
+    if (count > SAT_MAX_BANDS) count = SAT_MAX_BANDS;
+
+    bool changed = (count != num_bands);
+    float low = SAT_CROSSOVER_MIN_HZ;
+
+    for (uint32_t j = 0; j < count - 1; j++) {
+        float hz = crossovers[j];
+
+        if (hz > SAT_CROSSOVER_MAX_SHARE*sample_rate) hz = SAT_CROSSOVER_MAX_SHARE*sample_rate;
+        if (!(hz >= low)) hz = low;
+
+        changed = changed || (hz != frequencies[j]);
+        frequencies[j] = low = hz;
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    // New frequencies keep the filter state, so they can be automated
+    if (count != num_bands) {
+        num_bands = count;
+        design();
+        reset();
+    }
+    else {
+        design();
+    }
+}
+
+uint32_t SatMultiband::getBands() const
+{
+    return num_bands;
+}
+
+void SatMultiband::reset()
+{
+    for (uint32_t g = 0; g < groups.size(); g++) {
+        std::memset(groups[g].filter.s1, 0, sizeof(groups[g].filter.s1));
+        std::memset(groups[g].filter.s2, 0, sizeof(groups[g].filter.s2));
+    }
+}
+
+/**
+   Set up the filters of all lanes for the current bands and crossovers. The cascade of band b has, for every
+   crossover j, two biquads: highpasses for j < b, lowpasses for j = b, and an allpass for j > b.
+ */
+void SatMultiband::design()
+{
+    const uint32_t lanes = num_bands*channels;
+
+    // Every lane copies the responses of the crossovers, so each is only designed once
+    SatBiquad responses[SAT_MAX_BANDS - 1][NUM_SAT_BIQUAD_RESPONSES];
+
+    for (uint32_t j = 0; j < SAT_MAX_BANDS - 1; j++) {
+        for (int r = 0; r < NUM_SAT_BIQUAD_RESPONSES; r++) {
+            sat_biquad_design(responses[j][r], r, frequencies[j], sample_rate);
+        }
+    }
+
+    num_groups = (lanes + SAT_LANES - 1)/SAT_LANES;
+
+    for (uint32_t g = 0; g < num_groups; g++) {
+        Group& group = groups[g];
+
+        group.lanes = (lanes - g*SAT_LANES < SAT_LANES) ? lanes - g*SAT_LANES : SAT_LANES;
+
+        for (uint32_t l = 0; l < SAT_LANES; l++) {
+            const uint32_t b = (g*SAT_LANES + l)/channels;
+
+            for (uint32_t j = 0; j < SAT_BIQUAD_STAGES/2; j++) {
+                int first = SAT_BIQUAD_IDENTITY;
+                int second = SAT_BIQUAD_IDENTITY;
+
+                // Unused lanes pass their silence through
+                if (l < group.lanes && j < num_bands - 1) {
+                    if (j < b) {
+                        first = second = SAT_BIQUAD_HIGHPASS;
+                    }
+                    else if (j == b) {
+                        first = second = SAT_BIQUAD_LOWPASS;
+                    }
+                    else {
+                        first = SAT_BIQUAD_ALLPASS;
+                    }
+                }
+
+                sat_biquad_set(group.filter, 2*j, l, responses[j][first]);
+                sat_biquad_set(group.filter, 2*j + 1, l, responses[j][second]);
+            }
+        }
+    }
+
+    valid = false;
+}
+
+/**
+   Set up the lane coefficients of every group for the bands of @a segments, if all bands of the group share a
+   kernel. Unused lanes repeat the coefficients of lane 0.
+ */
+void SatMultiband::plan(const SatSegment* segments)
+{
+    for (uint32_t g = 0; g < num_groups; g++) {
+        Group& group = groups[g];
+        const uint32_t first = (g*SAT_LANES)/channels;
+
+        group.kernel = segments[first].kernel;
+        group.single = true;
+        group.ramp = false;
+
+        for (uint32_t l = 0; l < group.lanes; l++) {
+            const SatSegment& s = segments[(g*SAT_LANES + l)/channels];
+
+            group.single = group.single && s.kernel == group.kernel;
+            group.ramp = group.ramp || s.ramp;
+        }
+
+        if (!group.single) {
+            continue;
+        }
+
+        for (uint32_t l = 0; l < SAT_LANES; l++) {
+            const SatSegment& s = segments[(l < group.lanes) ? (g*SAT_LANES + l)/channels : first];
+
+            sat_lane_set(group.c, l, s.c, s.wet, s.dry);
+
+            if (s.ramp) {
+                sat_lane_set(group.dc, l, s.dc, s.dwet, s.ddry);
+            }
+            else {
+                const SatCoeffs zero = {};
+                sat_lane_set(group.dc, l, zero, 0.0f, 0.0f);
+            }
+        }
+    }
+
+    for (uint32_t b = 0; b < num_bands; b++) {
+        planned[b] = segments[b];
+    }
+    valid = true;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void SatMultiband::process(const SatKernels* kernels, const float* const* inputs, float* const* outputs,
+                           uint32_t frames, const SatSegment* segments, const SatSegment* const* fades)
+{
+    bool same = valid;
+    for (uint32_t b = 0; b < num_bands && same; b++) {
+        same = sat_segment_same(segments[b], planned[b]);
+    }
+
+    if (!same) {
+        plan(segments);
+    }
+
+    // Lanes are saturated where they are if one pass per group fills whole vectors, and split into bands otherwise,
+    // which a crossfade always needs
+    bool packed = (fades == NULL);
+    for (uint32_t g = 0; g < num_groups; g++) {
+        packed = packed && groups[g].single && groups[g].lanes >= kernels->width;
+    }
+
+    const uint32_t lanes = num_bands*channels;
+    const uint32_t stages = 2*(num_bands - 1);
+    const uint32_t stride = SAT_MULTIBAND_CHUNK*SAT_LANES;
+
+    for (uint32_t pos = 0; pos < frames; pos += SAT_MULTIBAND_CHUNK) {
+        const uint32_t n = (frames - pos < SAT_MULTIBAND_CHUNK) ? frames - pos : SAT_MULTIBAND_CHUNK;
+
+        // All groups read their input before any output is written, as the outputs may be the inputs
+        for (uint32_t g = 0; g < num_groups; g++) {
+            const float* in[SAT_LANES];
+
+            for (uint32_t l = 0; l < SAT_LANES; l++) {
+                const uint32_t lane = g*SAT_LANES + l;
+                in[l] = (lane < lanes) ? inputs[lane % channels] + pos : &silence[0];
+            }
+
+            kernels->interleave(in, &interleaved[g*stride], groups[g].lanes, n);
+        }
+
+        for (uint32_t g = 0; g < num_groups; g++) {
+            Group& group = groups[g];
+            float* const x = &interleaved[g*stride];
+
+            kernels->biquad_lanes(x, group.lanes, n, stages, group.filter);
+
+            if (packed) {
+                saturateLanes(kernels, group, x, outputs, g, pos, n);
+            }
+            else {
+                float* out[SAT_LANES];
+
+                for (uint32_t l = 0; l < SAT_LANES; l++) {
+                    const uint32_t lane = g*SAT_LANES + l;
+                    out[l] = (lane < lanes) ? &split[lane*SAT_MULTIBAND_CHUNK] : &spare[0];
+                }
+
+                kernels->deinterleave(x, out, group.lanes, n);
+            }
+        }
+
+        if (!packed) {
+            saturateBands(kernels, outputs, pos, n, segments, fades);
+        }
+    }
+}
+
+/**
+   Saturate the @a n interleaved frames @a x of group @a g with the lane kernel of its bands, and sum them into the
+   outputs at frame @a pos, band 0 first, whose lanes come first.
+ */
+void SatMultiband::saturateLanes(const SatKernels* kernels, const Group& group, float* x, float* const* outputs,
+                                 uint32_t g, uint32_t pos, uint32_t n)
+{
+    if (!group.ramp) {
+        kernels->lanes[group.kernel](x, x, group.lanes, n, group.c);
+    }
+    else if (pos == 0) {
+        kernels->lanes_ramp[group.kernel](x, x, group.lanes, n, group.c, group.dc);
+    }
+    else {
+        SatLaneCoeffs c;
+        sat_lane_offset(group.c, group.dc, (float)pos, c);
+        kernels->lanes_ramp[group.kernel](x, x, group.lanes, n, c, group.dc);
+    }
+
+    for (uint32_t l = 0; l < group.lanes; l++) {
+        const uint32_t lane = g*SAT_LANES + l;
+        float* const out = outputs[lane % channels] + pos;
+
+        if (lane < channels) {
+            for (uint32_t i = 0; i < n; i++) {
+                out[i] = x[i*SAT_LANES + l];
+            }
+        }
+        else {
+            for (uint32_t i = 0; i < n; i++) {
+                out[i] += x[i*SAT_LANES + l];
+            }
+        }
+    }
+}
+
+/**
+   Saturate the @a n frames of every band, split into one buffer per lane, with the block kernels of its segment,
+   and sum them into the outputs at frame @a pos. Band 0 is saturated straight into the outputs. The old curve of a
+   band in @a fades runs first, as the band is saturated in place.
+ */
+void SatMultiband::saturateBands(const SatKernels* kernels, float* const* outputs, uint32_t pos, uint32_t n,
+                                 const SatSegment* segments, const SatSegment* const* fades)
+{
+    for (uint32_t b = 0; b < num_bands; b++) {
+        const SatSegment* const old = (fades != NULL) ? fades[b] : NULL;
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            band_inputs[ch] = &split[(b*channels + ch)*SAT_MULTIBAND_CHUNK];
+            band_outputs[ch] = &fade[ch*SAT_MULTIBAND_CHUNK];
+        }
+
+        if (old != NULL) {
+            saturateBand(kernels, *old, pos, n);
+        }
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            band_outputs[ch] = (b == 0) ? outputs[ch] + pos : &split[(b*channels + ch)*SAT_MULTIBAND_CHUNK];
+        }
+
+        saturateBand(kernels, segments[b], pos, n);
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            float* const out = outputs[ch] + pos;
+
+            if (old != NULL) {
+                const float* const faded = &fade[ch*SAT_MULTIBAND_CHUNK];
+
+                for (uint32_t i = 0; i < n; i++) {
+                    out[i] += faded[i];
+                }
+            }
+
+            if (b > 0) {
+                const float* const band = band_outputs[ch];
+
+                for (uint32_t i = 0; i < n; i++) {
+                    out[i] += band[i];
+                }
+            }
+        }
+    }
+}
+
+/**
+   Saturate the @a n frames of the band pointers with segment @a s, @a pos frames into it.
+ */
+void SatMultiband::saturateBand(const SatKernels* kernels, const SatSegment& s, uint32_t pos, uint32_t n)
+{
+    if (!s.ramp) {
+        kernels->block_multi[s.kernel](&band_inputs[0], &band_outputs[0], channels, n, s.c, s.wet, s.dry);
+    }
+    else {
+        const float t = (float)pos;
+        const SatCoeffs k = sat_coeffs_ramp(s.c, s.dc, t);
+
+        kernels->ramp_multi[s.kernel](&band_inputs[0], &band_outputs[0], channels, n, k, s.dc,
+                                      s.wet + t*s.dwet, s.dry + t*s.ddry, s.dwet, s.ddry);
+    }
+}
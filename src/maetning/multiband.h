@@ -0,0 +1,129 @@
+/*
+ * Multiband saturation
+ *
+ * Splits the signal into 2 to SAT_MAX_BANDS bands at fourth order
+ * Linkwitz-Riley crossovers, saturates every band with a curve of its own and
+ * sums the bands again, in place.
+ *
+ * The crossovers are not a tree of splits: every band is the input filtered by
+ * a cascade of its own, the highpass of the crossover below it, the lowpass of
+ * the crossover above it, and the allpass of every crossover further up. The
+ * lowpass and highpass of a Linkwitz-Riley crossover add up to a second order
+ * allpass, so the bands stay in phase, and without saturation their sum is the
+ * input through an allpass. The filters commute, so all bands run side by side
+ * with the same number of biquads, two per crossover.
+ *
+ * Band b of channel ch is lane b*channels + ch of the lane kernels (see
+ * saturation.h), SAT_LANES to a group, so one pass of the lane filter kernel
+ * filters all bands and channels of a group. The filters are recursive, so
+ * this is where the lanes pay off most.
+ *
+ * If all bands of a group share a kernel and fill whole vectors, one pass of
+ * its lane kernel saturates them all, each with its own coefficients, and the
+ * bands are summed from the lanes. Otherwise a pass would compute mostly
+ * unused lanes, or the whole group once per kernel, so the bands are split
+ * into buffers of their own and saturated with the block kernels instead.
+ *
+ * While the type of a band fades in, its old curve runs on the same band too,
+ * and is added to it. Those bands are always split into buffers.
+ *
+ * The bands run at the base rate, without oversampling, ADAA or lookup tables,
+ * and the crossovers add no latency.
+ */
+
+#ifndef MULTIBAND_H_INCLUDED
+#define MULTIBAND_H_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "processor.h"
+
+// Frames filtered and saturated at a time, which sizes the work buffers
+#define SAT_MULTIBAND_CHUNK 32
+
+class SatMultiband
+{
+public:
+    /**
+       Create a crossover for @a channels channels. This allocates all buffers.
+     */
+    SatMultiband(uint32_t channels);
+
+    /**
+       Sample rate in Hz, for the crossover filters.
+     */
+    void setSampleRate(double rate);
+
+    /**
+       Number of bands, 2 to SAT_MAX_BANDS, and their crossover frequencies in Hz, one less than the bands.
+       A frequency below the one before is raised to it. The filter state is kept, unless the number of bands changes.
+     */
+    void setBands(uint32_t count, const float* crossovers);
+
+    uint32_t getBands() const;
+
+    /**
+       Clear the filter state.
+     */
+    void reset();
+
+    /**
+       Process @a frames frames of all channels, with band b saturated by the curve and gains of @a segments[b].
+       The gains of all segments are the same. If @a fades is not NULL, every band b for which @a fades[b] is not
+       NULL is saturated with that segment too, and the two are added, to crossfade between two curves. Inputs and
+       outputs may be the same buffers.
+     */
+    void process(const SatKernels* kernels, const float* const* inputs, float* const* outputs, uint32_t frames,
+                 const SatSegment* segments, const SatSegment* const* fades);
+
+private:
+    // Up to SAT_LANES lanes, their filters, and the coefficients of the lane kernel if all of them share one
+    struct Group
+    {
+        uint32_t lanes;
+
+        SatBiquadLanes filter;
+
+        int kernel;
+        bool single;
+        bool ramp;
+
+        SatLaneCoeffs c, dc;
+    };
+
+    void design();
+    void plan(const SatSegment* segments);
+    void saturateLanes(const SatKernels* kernels, const Group& group, float* x, float* const* outputs, uint32_t g,
+                       uint32_t pos, uint32_t n);
+    void saturateBands(const SatKernels* kernels, float* const* outputs, uint32_t pos, uint32_t n,
+                       const SatSegment* segments, const SatSegment* const* fades);
+    void saturateBand(const SatKernels* kernels, const SatSegment& s, uint32_t pos, uint32_t n);
+
+    uint32_t channels;
+    double sample_rate;
+
+    uint32_t num_bands;
+    float frequencies[SAT_MAX_BANDS - 1];
+
+    std::vector<Group> groups;
+    uint32_t num_groups;
+
+    // Segments the groups were planned for
+    SatSegment planned[SAT_MAX_BANDS];
+    bool valid;
+
+    // Interleaved lanes of every group, the same split into one buffer per lane, the input and output of unused
+    // lanes, and the output of the old curve of a band that fades
+    std::vector<float> interleaved;
+    std::vector<float> split;
+    std::vector<float> silence;
+    std::vector<float> spare;
+    std::vector<float> fade;
+
+    // Channel pointers of the band being saturated
+    std::vector<const float*> band_inputs;
+    std::vector<float*> band_outputs;
+};
+
+#endif // MULTIBAND_H_INCLUDED
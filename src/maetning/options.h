@@ -0,0 +1,52 @@
+/*
+ * Command line options of the standalone tools
+ *
+ * Shared by maetning-bench, maetning-host, maetning-jitter and
+ * maetning-rtcheck, so every tool reads lists of numbers the same way. Not
+ * part of the plugin.
+ */
+
+#ifndef OPTIONS_H_INCLUDED
+#define OPTIONS_H_INCLUDED
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+   Parse a comma separated list of numbers and ranges into @a list, e.g. "0-100:10,128", where A-B is every number
+   from A to B and A-B:S every S-th. Returns false if an item is not a number or the list is empty.
+ */
+static inline bool sat_parse_list(const char* text, std::vector<int>& list)
+{
+    list.clear();
+
+    std::string item;
+    const std::string s(text);
+    size_t pos = 0;
+
+    while (pos <= s.size()) {
+        const size_t end = s.find(',', pos);
+        item = s.substr(pos, (end == std::string::npos) ? std::string::npos : end - pos);
+        pos = (end == std::string::npos) ? s.size() + 1 : end + 1;
+
+        int a = 0;
+        int b = 0;
+        int stride = 1;
+        const int n = std::sscanf(item.c_str(), "%d-%d:%d", &a, &b, &stride);
+
+        if (n < 1 || stride < 1) {
+            return false;
+        }
+        if (n == 1) {
+            b = a;
+        }
+        for (int v = a; v <= b; v += stride) {
+            list.push_back(v);
+        }
+    }
+
+    return !list.empty();
+}
+
+#endif // OPTIONS_H_INCLUDED
@@ -0,0 +1,236 @@
+/*
+ * Polyphase halfband oversampling
+ *
+ * Oversampling by 2, 4 or 8 is a cascade of 2x stages, each using one of the
+ * halfband filters from halfband.h. In polyphase form, the zero-stuffed input
+ * samples and the zero taps of the halfband filter are never multiplied:
+ *
+ *   upsampling:    y[2n]   = 2 * sum_j h[2j] u[n - j]
+ *                  y[2n+1] = u[n - K + 1]                  (center tap)
+ *
+ *   downsampling:  y[n] = sum_j h[2j] v[2n - 2j] + 0.5 v[2n - 2K + 1]
+ *
+ * A 2x stage delays by 2K - 1 samples at its input rate. For 4x and 8x, the
+ * first stages swap the phases of their upsampled output, which adds one
+ * sample of delay at the output rate, so the total latency is a whole number
+ * of base rate frames.
+ *
+ * The filters are symmetric, so both sums are forward dot products over a
+ * contiguous history, and each pair of equal taps needs one multiply. They run
+ * on the FIR kernel of the SIMD kernel table in use (see saturation_simd.h).
+ *
+ * Channels are processed one after another and share the work buffers; only
+ * the filter histories are kept per channel. Everything is allocated up front,
+ * so upsample() and downsample() never allocate.
+ */
+
+#ifndef OVERSAMPLER_H_INCLUDED
+#define OVERSAMPLER_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "halfband.h"
+#include "saturation.h"
+
+#define OVERSAMPLING_MAX_FACTOR 8
+
+// Base rate frames processed per call, which sizes the work buffers
+#define OVERSAMPLING_CHUNK 128
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+   One 2x stage with @a TAPS stored taps, for up to @a FRAMES input frames per upsample() call.
+ */
+template <uint32_t TAPS, uint32_t FRAMES>
+class HalfbandStage
+{
+public:
+    HalfbandStage(const float* coeffs, uint32_t channels)
+        : coeffs(coeffs),
+          filter(sat_filter),
+          up_history(channels*(TAPS - 1)),
+          even_history(channels*(TAPS - 1)),
+          odd_history(channels*(TAPS/2))
+    {
+        reset();
+    }
+
+    /**
+       Use the FIR kernel of @a kernels.
+     */
+    void setKernels(const SatKernels* kernels)
+    {
+        filter = kernels->filter;
+    }
+
+    void reset()
+    {
+        std::fill(up_history.begin(), up_history.end(), 0.0f);
+        std::fill(even_history.begin(), even_history.end(), 0.0f);
+        std::fill(odd_history.begin(), odd_history.end(), 0.0f);
+    }
+
+    /**
+       Upsample @a frames samples from @a in into 2 * @a frames samples in @a out.
+       If @a delayed is true, the output is delayed by one more sample.
+     */
+    void upsample(uint32_t ch, const float* in, float* out, uint32_t frames, bool delayed)
+    {
+        float* const history = &up_history[ch*(TAPS - 1)];
+
+        std::memcpy(work, history, (TAPS - 1)*sizeof(float));
+        std::memcpy(work + TAPS - 1, in, frames*sizeof(float));
+
+        filter(coeffs, TAPS, work, acc, frames);
+
+        if (delayed) {
+            for (uint32_t i = 0; i < frames; i++) {
+                out[2*i] = work[i + TAPS/2 - 1];
+                out[2*i + 1] = 2.0f*acc[i];
+            }
+        }
+        else {
+            for (uint32_t i = 0; i < frames; i++) {
+                out[2*i] = 2.0f*acc[i];
+                out[2*i + 1] = work[i + TAPS/2];
+            }
+        }
+
+        std::memcpy(history, work + frames, (TAPS - 1)*sizeof(float));
+    }
+
+    /**
+       Downsample 2 * @a frames samples from @a in into @a frames samples in @a out.
+     */
+    void downsample(uint32_t ch, const float* in, float* out, uint32_t frames)
+    {
+        float* const history = &even_history[ch*(TAPS - 1)];
+        float* const odd = &odd_history[ch*(TAPS/2)];
+
+        std::memcpy(work, history, (TAPS - 1)*sizeof(float));
+        std::memcpy(odd_work, odd, (TAPS/2)*sizeof(float));
+
+        for (uint32_t i = 0; i < frames; i++) {
+            work[TAPS - 1 + i] = in[2*i];
+            odd_work[TAPS/2 + i] = in[2*i + 1];
+        }
+
+        filter(coeffs, TAPS, work, acc, frames);
+
+        for (uint32_t i = 0; i < frames; i++) {
+            out[i] = acc[i] + 0.5f*odd_work[i];
+        }
+
+        std::memcpy(history, work + frames, (TAPS - 1)*sizeof(float));
+        std::memcpy(odd, odd_work + frames, (TAPS/2)*sizeof(float));
+    }
+
+private:
+    const float* const coeffs;
+    SatFilterFunc filter;
+
+    std::vector<float> up_history;
+    std::vector<float> even_history;
+    std::vector<float> odd_history;
+
+    float work[TAPS - 1 + FRAMES];
+    float odd_work[TAPS/2 + FRAMES];
+    float acc[FRAMES];
+};
+
+// -----------------------------------------------------------------------------------------------------------
+
+class Oversampler
+{
+public:
+    Oversampler(uint32_t channels)
+        : stage0(halfband0_coeffs, channels),
+          stage1(halfband1_coeffs, channels),
+          stage2(halfband2_coeffs, channels)
+    {
+    }
+
+    /**
+       Use the FIR kernel of @a kernels for all stages.
+     */
+    void setKernels(const SatKernels* kernels)
+    {
+        stage0.setKernels(kernels);
+        stage1.setKernels(kernels);
+        stage2.setKernels(kernels);
+    }
+
+    /**
+       Clear the filter histories of all channels.
+     */
+    void reset()
+    {
+        stage0.reset();
+        stage1.reset();
+        stage2.reset();
+    }
+
+    /**
+       Latency in base rate frames for an oversampling @a factor.
+     */
+    static uint32_t getLatency(uint32_t factor)
+    {
+        // In quarter frames: each stage's filter delay, plus the phase swaps of upsample()
+        uint32_t latency = 0;
+
+        if (factor >= 2) latency += 4*(HALFBAND0_LENGTH - 1);
+        if (factor >= 4) latency += 2*(HALFBAND1_LENGTH - 1) + 2;
+        if (factor >= 8) latency += 1*(HALFBAND2_LENGTH - 1) + 1;
+
+        return latency/4;
+    }
+
+    /**
+       Upsample at most OVERSAMPLING_CHUNK frames of channel @a ch by @a factor (2, 4 or 8).
+       Returns the work buffer holding @a factor * @a frames samples, which may be processed in place.
+     */
+    float* upsample(uint32_t ch, uint32_t factor, const float* in, uint32_t frames)
+    {
+        stage0.upsample(ch, in, buf2, frames, factor >= 4);
+        if (factor == 2) {
+            return buf2;
+        }
+
+        stage1.upsample(ch, buf2, buf4, 2*frames, factor >= 8);
+        if (factor == 4) {
+            return buf4;
+        }
+
+        stage2.upsample(ch, buf4, buf8, 4*frames, false);
+        return buf8;
+    }
+
+    /**
+       Downsample the buffer returned by upsample() back into @a frames samples in @a out.
+     */
+    void downsample(uint32_t ch, uint32_t factor, float* out, uint32_t frames)
+    {
+        if (factor == 8) {
+            stage2.downsample(ch, buf8, buf4, 4*frames);
+        }
+        if (factor >= 4) {
+            stage1.downsample(ch, buf4, buf2, 2*frames);
+        }
+        stage0.downsample(ch, buf2, out, frames);
+    }
+
+private:
+    HalfbandStage<HALFBAND0_LENGTH, OVERSAMPLING_CHUNK> stage0;
+    HalfbandStage<HALFBAND1_LENGTH, 2*OVERSAMPLING_CHUNK> stage1;
+    HalfbandStage<HALFBAND2_LENGTH, 4*OVERSAMPLING_CHUNK> stage2;
+
+    float buf2[2*OVERSAMPLING_CHUNK];
+    float buf4[4*OVERSAMPLING_CHUNK];
+    float buf8[8*OVERSAMPLING_CHUNK];
+};
+
+#endif // OVERSAMPLER_H_INCLUDED
@@ -0,0 +1,99 @@
+/*
+ * DSP load probe
+ *
+ * Times each processed block with std::chrono::steady_clock, and keeps the
+ * average and the worst block in ns per sample, counting every channel like
+ * maetning-bench, together with the number of blocks since the last reset.
+ *
+ * The plugin only contains the probe when it is built with MAETNING_PROBE
+ * (make PROBE=1), and then publishes the figures as output parameters, so
+ * the host shows which instances are expensive. Release builds do not read
+ * the clock at all. All members belong to the audio thread.
+ */
+
+#ifndef PROBE_H_INCLUDED
+#define PROBE_H_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+
+class SatLoadProbe
+{
+public:
+    SatLoadProbe()
+    {
+        reset();
+    }
+
+    /**
+       Forget all blocks so far, e.g. when the plugin is activated.
+     */
+    void reset()
+    {
+        total_ns = 0.0;
+        total_samples = 0;
+        worst = 0.0f;
+        blocks = 0;
+    }
+
+    /**
+       Call right before processing a block.
+     */
+    void begin()
+    {
+        start = std::chrono::steady_clock::now();
+    }
+
+    /**
+       Call right after processing a block of @a samples samples, all channels together.
+     */
+    void end(uint32_t samples)
+    {
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        if (samples == 0) {
+            return;
+        }
+
+        const float block_ns = (float)(ns/samples);
+
+        total_ns += ns;
+        total_samples += samples;
+        worst = (block_ns > worst) ? block_ns : worst;
+        blocks++;
+    }
+
+    /**
+       Average time per sample in ns over all blocks since the last reset.
+     */
+    float getAverage() const
+    {
+        return (total_samples > 0) ? (float)(total_ns/total_samples) : 0.0f;
+    }
+
+    /**
+       Time per sample in ns of the slowest block since the last reset.
+     */
+    float getWorst() const
+    {
+        return worst;
+    }
+
+    /**
+       Number of blocks since the last reset.
+     */
+    uint64_t getBlocks() const
+    {
+        return blocks;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+
+    double total_ns;
+    uint64_t total_samples;
+    float worst;
+    uint64_t blocks;
+};
+
+#endif // PROBE_H_INCLUDED
@@ -0,0 +1,930 @@
+/*
+ * Saturation processor, see processor.h.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "denormals.h"
+#include "multiband.h"
+#include "processor.h"
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+   Largest magnitude of @a frames samples.
+ */
+static float sat_peak(const float* x, uint32_t frames)
+{
+    float peak = 0.0f;
+
+    for (uint32_t n = 0; n < frames; n++) {
+        const float a = std::fabs(x[n]);
+        peak = (a > peak) ? a : peak;
+    }
+
+    return peak;
+}
+
+/**
+   Whether @a frames samples are all zero, of either sign. Audio is rarely zero for long, so this returns early, but
+   only between chunks, so the chunks themselves are vectorized.
+ */
+static bool sat_silent(const float* x, uint32_t frames)
+{
+    const uint32_t chunk = 64;
+
+    for (uint32_t pos = 0; pos < frames; pos += chunk) {
+        const uint32_t n = (frames - pos < chunk) ? frames - pos : chunk;
+
+        if (sat_peak(x + pos, n) != 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+   Division mode of the kernels for evaluation mode @a evaluation.
+ */
+static int sat_math(int evaluation)
+{
+    return (evaluation == SAT_EVAL_APPROX) ? SAT_MATH_APPROX : SAT_MATH_EXACT;
+}
+
+float sat_volume_gain(float db)
+{
+    if (db < -50) {
+        return 0.0f;
+    }
+    return pow(10.0, db/20.0);
+}
+
+void sat_segment_prepare(SatSegment& s, int type, int kernel, SatSmoother& saturation, SatSmoother& volume,
+                         SatSmoother& mix, uint32_t frames, uint32_t samples)
+{
+    const float saturation0 = saturation.getValue();
+    const float saturation1 = saturation.advance(frames);
+    const float volume0 = volume.getValue();
+    const float volume1 = volume.advance(frames);
+    const float mix0 = mix.getValue();
+    const float mix1 = mix.advance(frames);
+
+    sat_segment_prepare(s, type, kernel, saturation0, saturation1, volume0, volume1, mix0, mix1, samples);
+}
+
+void sat_segment_prepare(SatSegment& s, int type, int kernel, float saturation0, float saturation1, float volume0,
+                         float volume1, float mix0, float mix1, uint32_t samples)
+{
+    // The kernel is chosen once per segment; the per-sample loop lives in the kernel
+    SatCoeffs target;
+    sat_coeffs_interpolate_kernel(type, kernel, saturation1, target);
+    s.kernel = kernel;
+    s.ramp = false;
+    s.c = target;
+
+    if (saturation0 != saturation1) {
+        SatCoeffs start;
+
+        sat_coeffs_interpolate_kernel(type, kernel, saturation0, start);
+        s.c = start;
+        sat_coeffs_delta(start, target, samples, s.dc);
+        s.ramp = true;
+    }
+
+    sat_gains(mix0, volume0, s.wet, s.dry);
+    s.dwet = 0.0f;
+    s.ddry = 0.0f;
+
+    // The gains move in a straight line to those at the end, also when mix and volume both ramp
+    if (mix0 != mix1 || volume0 != volume1) {
+        const float scale = 1.0f/samples;
+        float wet1, dry1;
+
+        sat_gains(mix1, volume1, wet1, dry1);
+        s.dwet = (wet1 - s.wet)*scale;
+        s.ddry = (dry1 - s.dry)*scale;
+
+        if (!s.ramp) {
+            std::memset(&s.dc, 0, sizeof(s.dc));
+            s.ramp = true;
+        }
+    }
+
+    s.lut = NULL;
+}
+
+void sat_segment_fade(SatSegment& s, float gain0, float gain1, uint32_t samples)
+{
+    const float wet1 = (s.wet + s.dwet*samples)*gain1;
+
+    s.wet *= gain0;
+    s.dwet = (wet1 - s.wet)/samples;
+
+    if (!s.ramp) {
+        std::memset(&s.dc, 0, sizeof(s.dc));
+        s.ramp = true;
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+SatProcessor::SatProcessor(uint32_t channels)
+    : kernels(sat_kernels_detect(&isa)),
+      channels(channels),
+      sample_rate(48000.0),
+      smoothing_time(SAT_SMOOTHING_TIME_MS),
+      saturation(0.0f),
+      volume(1.0f),
+      mix(1.0f),
+      type(0),
+      fade_length(0),
+      fading(false),
+      fade_buffer(SAT_FADE_CHUNK),
+      bands(1),
+      bands_active(1),
+      multiband(new SatMultiband(channels)),
+      oversampling(1),
+      oversampling_active(1),
+      oversampler(channels),
+      adaa_order(SAT_ADAA_OFF),
+      adaa_active(SAT_ADAA_OFF),
+      adaa_states(channels),
+      silent_frames(SAT_SILENCE_FRAMES),
+      evaluation(SAT_EVAL_EXACT),
+      lut_error(0.0f),
+      bus_inputs(channels),
+      bus_outputs(channels)
+{
+    crossovers[0].store(SAT_CROSSOVER1_HZ, std::memory_order_relaxed);
+    crossovers[1].store(SAT_CROSSOVER2_HZ, std::memory_order_relaxed);
+    crossovers[2].store(SAT_CROSSOVER3_HZ, std::memory_order_relaxed);
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS; b++) {
+        type_active[b] = 0;
+        kernel_active[b] = sat_coeffs_kernel(0, 0.0f);
+        fade_type[b] = 0;
+        fade_kernel[b] = kernel_active[b];
+        fade_remaining[b] = 0;
+        band_fades[b] = NULL;
+    }
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+        band_type[b].store(0, std::memory_order_relaxed);
+    }
+
+    oversampler.setKernels(kernels);
+    updateSmoothingLength();
+}
+
+SatProcessor::~SatProcessor()
+{
+}
+
+void SatProcessor::setSampleRate(double rate)
+{
+    sample_rate = rate;
+    updateSmoothingLength();
+
+    // The crossovers are designed for the new rate here, rather than in the next process() call
+    float hz[SAT_MAX_BANDS - 1];
+    loadCrossovers(hz);
+
+    multiband->setSampleRate(rate);
+    multiband->setBands(bands.load(std::memory_order_relaxed), hz);
+}
+
+void SatProcessor::setSmoothingTime(float ms)
+{
+    smoothing_time = ms;
+    updateSmoothingLength();
+}
+
+void SatProcessor::updateSmoothingLength()
+{
+    const uint32_t length = (uint32_t)(smoothing_time*0.001*sample_rate + 0.5);
+
+    saturation.setLength(length);
+    volume.setLength(length);
+    fade_length = length;
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS; b++) {
+        if (fade_remaining[b] > length) {
+            fade_remaining[b] = length;
+        }
+    }
+    mix.setLength(length);
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+        band_saturation[b].setLength(length);
+    }
+}
+
+void SatProcessor::setSaturation(float percent)
+{
+    saturation.setTarget(percent);
+    requestLut();
+}
+
+void SatProcessor::setType(int type)
+{
+    this->type.store(type, std::memory_order_relaxed);
+    requestLut();
+}
+
+void SatProcessor::setMasterVolume(float db)
+{
+    volume.setTarget(sat_volume_gain(db));
+}
+
+void SatProcessor::setMasterMix(float percent)
+{
+    mix.setTarget(percent/100.0);
+}
+
+void SatProcessor::setOversampling(uint32_t factor)
+{
+    if (factor >= 8) {
+        factor = 8;
+    }
+    else if (factor >= 4) {
+        factor = 4;
+    }
+    else if (factor >= 2) {
+        factor = 2;
+    }
+    else {
+        factor = 1;
+    }
+
+    oversampling.store(factor, std::memory_order_relaxed);
+}
+
+void SatProcessor::setAntialiasing(int order)
+{
+    if (order < SAT_ADAA_OFF) order = SAT_ADAA_OFF;
+    if (order > SAT_ADAA_SECOND_ORDER) order = SAT_ADAA_SECOND_ORDER;
+
+    adaa_order.store(order, std::memory_order_relaxed);
+}
+
+void SatProcessor::setBands(uint32_t count)
+{
+    if (count < 1) count = 1;
+    if (count > SAT_MAX_BANDS) count = SAT_MAX_BANDS;
+
+    bands.store(count, std::memory_order_relaxed);
+}
+
+void SatProcessor::setCrossover(uint32_t index, float hz)
+{
+    if (index < SAT_MAX_BANDS - 1) {
+        crossovers[index].store(hz, std::memory_order_relaxed);
+    }
+}
+
+void SatProcessor::setBandSaturation(uint32_t band, float percent)
+{
+    if (band == 0) {
+        setSaturation(percent);
+    }
+    else if (band < SAT_MAX_BANDS) {
+        band_saturation[band - 1].setTarget(percent);
+    }
+}
+
+void SatProcessor::setBandType(uint32_t band, int type)
+{
+    if (band == 0) {
+        setType(type);
+    }
+    else if (band < SAT_MAX_BANDS) {
+        band_type[band - 1].store(type, std::memory_order_relaxed);
+    }
+}
+
+void SatProcessor::setEvaluation(int mode)
+{
+    evaluation = mode;
+
+    kernels = sat_kernels_isa(isa, sat_math(evaluation));
+    oversampler.setKernels(kernels);
+
+    if (evaluation == SAT_EVAL_LUT && !lut_builder) {
+        lut_builder.reset(new SatLutBuilder());
+    }
+
+    requestLut();
+}
+
+/**
+   Ask for the table of the target saturation, so it is ready by the time the saturation settles.
+ */
+void SatProcessor::requestLut()
+{
+    if (evaluation == SAT_EVAL_LUT && lut_builder) {
+        lut_builder->request(type.load(std::memory_order_relaxed), saturation.getTarget());
+    }
+}
+
+void SatProcessor::waitForLut()
+{
+    if (evaluation == SAT_EVAL_LUT && lut_builder) {
+        lut_builder->wait(type.load(std::memory_order_relaxed), saturation.getTarget());
+    }
+}
+
+float SatProcessor::getLutError() const
+{
+    return lut_error;
+}
+
+/**
+   Read the target frequencies of all crossovers into @a hz.
+ */
+void SatProcessor::loadCrossovers(float* hz) const
+{
+    for (uint32_t j = 0; j < SAT_MAX_BANDS - 1; j++) {
+        hz[j] = crossovers[j].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+   Read the target types of all bands into @a types, band 0 first.
+ */
+void SatProcessor::loadTypes(int* types) const
+{
+    types[0] = type.load(std::memory_order_relaxed);
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+        types[b + 1] = band_type[b].load(std::memory_order_relaxed);
+    }
+}
+
+void SatProcessor::setParameter(uint32_t index, float value)
+{
+    switch (index) {
+    case SAT_PARAM_SATURATION:
+        setSaturation(value);
+        break;
+
+    case SAT_PARAM_TYPE:
+        setType((int)value);
+        break;
+
+    case SAT_PARAM_MASTERVOLUME:
+        setMasterVolume(value);
+        break;
+
+    case SAT_PARAM_MASTERMIX:
+        setMasterMix(value);
+        break;
+
+    case SAT_PARAM_OVERSAMPLING:
+        setOversampling((uint32_t)value);
+        break;
+
+    case SAT_PARAM_ANTIALIASING:
+        setAntialiasing((int)value);
+        break;
+
+    case SAT_PARAM_BANDS:
+        setBands((uint32_t)value);
+        break;
+
+    case SAT_PARAM_CROSSOVER1:
+    case SAT_PARAM_CROSSOVER2:
+    case SAT_PARAM_CROSSOVER3:
+        setCrossover(index - SAT_PARAM_CROSSOVER1, value);
+        break;
+
+    case SAT_PARAM_SATURATION2:
+    case SAT_PARAM_SATURATION3:
+    case SAT_PARAM_SATURATION4:
+        setBandSaturation(1 + (index - SAT_PARAM_SATURATION2)/2, value);
+        break;
+
+    case SAT_PARAM_TYPE2:
+    case SAT_PARAM_TYPE3:
+    case SAT_PARAM_TYPE4:
+        setBandType(1 + (index - SAT_PARAM_TYPE2)/2, (int)value);
+        break;
+
+    default:
+        break;
+    }
+}
+
+uint32_t SatProcessor::getLatency() const
+{
+    // The crossovers are minimum phase, and the bands are not oversampled
+    if (bands_active > 1) {
+        return 0;
+    }
+
+    uint32_t latency = Oversampler::getLatency(oversampling_active);
+
+    // Second order ADAA delays by one sample at the rate it runs at, which only counts without oversampling
+    if (adaa_active == SAT_ADAA_SECOND_ORDER && oversampling_active == 1) {
+        latency += 1;
+    }
+
+    return latency;
+}
+
+void SatProcessor::reset()
+{
+    oversampling_active = oversampling.load(std::memory_order_relaxed);
+    oversampler.reset();
+
+    adaa_active = adaa_order.load(std::memory_order_relaxed);
+
+    bands_active = bands.load(std::memory_order_relaxed);
+    if (bands_active > 1) {
+        float hz[SAT_MAX_BANDS - 1];
+        loadCrossovers(hz);
+        multiband->setBands(bands_active, hz);
+    }
+    multiband->reset();
+
+    int types[SAT_MAX_BANDS];
+    loadTypes(types);
+
+    saturation.snap();
+    volume.snap();
+    mix.snap();
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+        band_saturation[b].snap();
+    }
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS; b++) {
+        const SatSmoother& sat = (b == 0) ? saturation : band_saturation[b - 1];
+
+        type_active[b] = types[b];
+        kernel_active[b] = sat_coeffs_kernel(types[b], sat.getValue());
+        fade_remaining[b] = 0;
+    }
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        adaa_states[ch].x1 = 0.0;
+        adaa_states[ch].x2 = 0.0;
+    }
+
+    silent_frames = SAT_SILENCE_FRAMES;
+}
+
+bool SatProcessor::setIsa(const char* isa)
+{
+    const SatKernels* funcs = sat_kernels_isa(isa, sat_math(evaluation));
+
+    if (funcs == NULL) {
+        return false;
+    }
+
+    kernels = funcs;
+    this->isa = isa;
+    oversampler.setKernels(kernels);
+    return true;
+}
+
+const char* SatProcessor::getIsa() const
+{
+    return isa;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+void SatProcessor::process(const float* const* inputs, float* const* outputs, uint32_t frames)
+{
+    const SatDenormalGuard guard;
+
+    processRange(inputs, outputs, 0, frames);
+}
+
+void SatProcessor::process(const float* const* inputs, float* const* outputs, uint32_t frames,
+                           const SatParameterEvent* events, uint32_t count)
+{
+    const SatDenormalGuard guard;
+    uint32_t pos = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t frame = (events[i].frame < frames) ? events[i].frame : frames;
+
+        // Events at the same frame are applied together
+        if (frame > pos) {
+            processRange(inputs, outputs, pos, frame);
+            pos = frame;
+        }
+
+        setParameter(events[i].index, events[i].value);
+    }
+
+    if (pos < frames) {
+        processRange(inputs, outputs, pos, frames);
+    }
+}
+
+/**
+   Process frames @a begin to @a end of all channels with the parameters set so far.
+ */
+void SatProcessor::processRange(const float* const* inputs, float* const* outputs, uint32_t begin, uint32_t end)
+{
+    // The targets of the setters are read once, as they may change on another thread meanwhile. A new
+    // oversampling factor or number of bands starts from clean filters.
+    if (oversampling.load(std::memory_order_relaxed) != oversampling_active ||
+        bands.load(std::memory_order_relaxed) != bands_active) {
+        reset();
+    }
+
+    adaa_active = adaa_order.load(std::memory_order_relaxed);
+
+    int types[SAT_MAX_BANDS];
+    loadTypes(types);
+
+    if (bands_active > 1) {
+        float hz[SAT_MAX_BANDS - 1];
+        loadCrossovers(hz);
+        multiband->setBands(bands_active, hz);
+    }
+
+    saturation.update();
+    volume.update();
+    mix.update();
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+        band_saturation[b].update();
+    }
+
+    for (uint32_t pos = begin; pos < end; ) {
+        // A new type fades in from the one in effect, unless a fade is still running, in every band on its own. So
+        // does the kernel at the end of a saturation ramp, from the start of the ramp on.
+        for (uint32_t b = 0; b < bands_active; b++) {
+            const SatSmoother& sat = (b == 0) ? saturation : band_saturation[b - 1];
+            const int kernel = sat_coeffs_kernel(types[b], sat.getGoal());
+
+            if ((types[b] != type_active[b] || kernel != kernel_active[b]) && fade_remaining[b] == 0) {
+                fade_type[b] = type_active[b];
+                fade_kernel[b] = kernel_active[b];
+                type_active[b] = types[b];
+                kernel_active[b] = kernel;
+                fade_remaining[b] = fade_length;
+            }
+        }
+
+        // Up to where the next ramp ends
+        uint32_t n = end - pos;
+
+        for (uint32_t b = 0; b < bands_active; b++) {
+            if (fade_remaining[b] > 0 && fade_remaining[b] < n) n = fade_remaining[b];
+        }
+        if (saturation.getRemaining() > 0 && saturation.getRemaining() < n) n = saturation.getRemaining();
+        if (volume.getRemaining() > 0 && volume.getRemaining() < n) n = volume.getRemaining();
+        if (mix.getRemaining() > 0 && mix.getRemaining() < n) n = mix.getRemaining();
+
+        for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+            const uint32_t remaining = band_saturation[b].getRemaining();
+            if (remaining > 0 && remaining < n) n = remaining;
+        }
+
+        if (bands_active > 1) {
+            prepareBands(n);
+            processBands(inputs, outputs, pos, n);
+        }
+        else {
+            SatSegment s;
+            prepareSegment(s, n);
+            processSegment(inputs, outputs, pos, n, s);
+        }
+
+        pos += n;
+    }
+}
+
+/**
+   Advance the smoothers by @a frames frames, and set up the coefficients and gains that follow them.
+ */
+void SatProcessor::prepareSegment(SatSegment& s, uint32_t frames)
+{
+    // Ramps run at the oversampled rate
+    const uint32_t samples = frames*oversampling_active;
+    const float saturation0 = saturation.getValue();
+    const float saturation1 = saturation.advance(frames);
+    const float volume0 = volume.getValue();
+    const float volume1 = volume.advance(frames);
+    const float mix0 = mix.getValue();
+    const float mix1 = mix.advance(frames);
+
+    sat_segment_prepare(s, type_active[0], kernel_active[0], saturation0, saturation1, volume0, volume1, mix0, mix1,
+                        samples);
+
+    fading = (fade_remaining[0] > 0);
+
+    if (fading) {
+        prepareFade(0, s, saturation0, saturation1, volume0, volume1, mix0, mix1, frames, samples);
+    }
+
+    // Tables only hold settled curves
+    if (!s.ramp && evaluation == SAT_EVAL_LUT && lut_builder) {
+        s.lut = lut_builder->acquire(type_active[0], saturation.getValue(), &lut_error);
+    }
+
+    // The other bands follow their targets, to start from them when they are used
+    for (uint32_t b = 0; b < SAT_MAX_BANDS - 1; b++) {
+        band_saturation[b].advance(frames);
+    }
+}
+
+/**
+   Advance the smoothers by @a frames frames, and set up the segments of all bands that follow them.
+ */
+void SatProcessor::prepareBands(uint32_t frames)
+{
+    const float volume0 = volume.getValue();
+    const float volume1 = volume.advance(frames);
+    const float mix0 = mix.getValue();
+    const float mix1 = mix.advance(frames);
+
+    for (uint32_t b = 0; b < SAT_MAX_BANDS; b++) {
+        SatSmoother& sat = (b == 0) ? saturation : band_saturation[b - 1];
+        const float saturation0 = sat.getValue();
+        const float saturation1 = sat.advance(frames);
+
+        if (b >= bands_active) {
+            continue;
+        }
+
+        sat_segment_prepare(band_segments[b], type_active[b], kernel_active[b], saturation0, saturation1, volume0,
+                            volume1, mix0, mix1, frames);
+        band_fades[b] = NULL;
+
+        if (fade_remaining[b] > 0) {
+            prepareFade(b, band_segments[b], saturation0, saturation1, volume0, volume1, mix0, mix1, frames, frames);
+            band_fades[b] = &fade_segments[b];
+        }
+    }
+
+    fading = false;
+    for (uint32_t b = 0; b < bands_active; b++) {
+        fading = fading || (band_fades[b] != NULL);
+    }
+}
+
+/**
+   Advance the fade of band @a band by @a frames frames. Segment @a s of the new type or kernel fades in, and the fade
+   segment of the band, the old type and kernel at the same saturation, volume and mix, fades out, and is added
+   without a dry signal. Ramps are spread over @a samples samples.
+ */
+void SatProcessor::prepareFade(uint32_t band, SatSegment& s, float saturation0, float saturation1, float volume0,
+                               float volume1, float mix0, float mix1, uint32_t frames, uint32_t samples)
+{
+    SatSegment& old = fade_segments[band];
+
+    const float fade0 = 1.0f - (float)fade_remaining[band]/fade_length;
+    fade_remaining[band] -= frames;
+    const float fade1 = 1.0f - (float)fade_remaining[band]/fade_length;
+
+    sat_segment_prepare(old, fade_type[band], fade_kernel[band], saturation0, saturation1, volume0, volume1, mix0, mix1,
+                        samples);
+    sat_segment_fade(old, 1.0f - fade0, 1.0f - fade1, samples);
+    old.dry = 0.0f;
+    old.ddry = 0.0f;
+
+    sat_segment_fade(s, fade0, fade1, samples);
+}
+
+/**
+   Process frames @a pos to @a pos + @a frames of all channels with the segments of all bands.
+ */
+void SatProcessor::processBands(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames)
+{
+    const SatSegment& s = band_segments[0];
+
+    // A muted output resumes from clean filters, like the oversampling filters
+    if (!s.ramp && s.wet == 0.0f && s.dry == 0.0f) {
+        multiband->reset();
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            std::memset(outputs[ch] + pos, 0, frames*sizeof(float));
+        }
+        return;
+    }
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        bus_inputs[ch] = inputs[ch] + pos;
+        bus_outputs[ch] = outputs[ch] + pos;
+    }
+
+    multiband->process(kernels, &bus_inputs[0], &bus_outputs[0], frames, band_segments, fading ? band_fades : NULL);
+}
+
+/**
+   Process frames @a pos to @a pos + @a frames of all channels with the parameters of segment @a s.
+ */
+void SatProcessor::processSegment(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames,
+                                  const SatSegment& s)
+{
+    const uint32_t factor = oversampling_active;
+
+    if (processShortcut(inputs, outputs, pos, frames, s)) {
+        return;
+    }
+
+    // Without ADAA, the whole bus runs through one multichannel kernel, unless two curves are crossfaded
+    if (factor == 1 && adaa_active == SAT_ADAA_OFF && s.lut == NULL && !fading) {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            bus_inputs[ch] = inputs[ch] + pos;
+            bus_outputs[ch] = outputs[ch] + pos;
+
+            // Keep the ADAA history up to date, so it can be switched on at any time
+            sat_adaa_history(bus_inputs[ch], frames, adaa_states[ch]);
+        }
+
+        if (!s.ramp) {
+            kernels->block_multi[s.kernel](&bus_inputs[0], &bus_outputs[0], channels, frames, s.c, s.wet, s.dry);
+        }
+        else {
+            kernels->ramp_multi[s.kernel](&bus_inputs[0], &bus_outputs[0], channels, frames, s.c, s.dc, s.wet,
+                                          s.dry, s.dwet, s.ddry);
+        }
+        return;
+    }
+
+    if (factor == 1) {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            saturate(ch, inputs[ch] + pos, outputs[ch] + pos, frames, s, 0);
+        }
+        return;
+    }
+
+    // The dry signal is mixed in at the oversampled rate too, so it has the same latency as the wet signal
+    for (uint32_t i = 0; i < frames; i += OVERSAMPLING_CHUNK) {
+        const uint32_t n = (frames - i < OVERSAMPLING_CHUNK) ? frames - i : OVERSAMPLING_CHUNK;
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            float* const up = oversampler.upsample(ch, factor, inputs[ch] + pos + i, n);
+            saturate(ch, up, up, n*factor, s, i*factor);
+            oversampler.downsample(ch, factor, outputs[ch] + pos + i, n);
+        }
+    }
+}
+
+/**
+   Process the segment without running the curves, if its output is known anyway, and keep count of silent input.
+   Returns false if the segment has to be processed in full.
+ */
+bool SatProcessor::processShortcut(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames,
+                                   const SatSegment& s)
+{
+    const uint32_t factor = oversampling_active;
+
+    bool silent = !s.ramp;
+    for (uint32_t ch = 0; ch < channels && silent; ch++) {
+        silent = sat_silent(inputs[ch] + pos, frames);
+    }
+
+    // Silence only stays silent if the curve passes through zero, which some do not at low saturation
+    if (silent) {
+        const float zero = 0.0f;
+        float y;
+
+        kernels->block[s.kernel](&zero, &y, 1, s.c, 1.0f, 0.0f);
+        silent = (y == 0.0f);
+    }
+
+    if (!silent) {
+        silent_frames = 0;
+    }
+    else if (silent_frames >= SAT_SILENCE_FRAMES) {
+        // The filters and the ADAA history hold nothing but silence, too
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            std::memset(outputs[ch] + pos, 0, frames*sizeof(float));
+        }
+        return true;
+    }
+    else {
+        silent_frames = (frames < SAT_SILENCE_FRAMES - silent_frames) ? silent_frames + frames : SAT_SILENCE_FRAMES;
+    }
+
+    if (s.ramp) {
+        return false;
+    }
+
+    if (s.wet == 0.0f && s.dry == 0.0f) {
+        // Rather than running stale filters, the output resumes from clean ones, as the volume ramps up from zero
+        if (factor > 1) {
+            oversampler.reset();
+        }
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            if (factor > 1) {
+                adaa_states[ch].x1 = 0.0;
+                adaa_states[ch].x2 = 0.0;
+            }
+            else {
+                sat_adaa_history(inputs[ch] + pos, frames, adaa_states[ch]);
+            }
+        }
+
+        // After the history, as the outputs may be the inputs
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            std::memset(outputs[ch] + pos, 0, frames*sizeof(float));
+        }
+        return true;
+    }
+
+    // ADAA mixes in an averaged dry signal and oversampling delays it, so only the plain path is a copy
+    if (s.wet == 0.0f && factor == 1 && adaa_active == SAT_ADAA_OFF) {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const float* const in = inputs[ch] + pos;
+            float* const out = outputs[ch] + pos;
+
+            sat_adaa_history(in, frames, adaa_states[ch]);
+
+            for (uint32_t n = 0; n < frames; n++) {
+                out[n] = in[n]*s.dry;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+   Saturate one channel, with or without ADAA. A ramping segment is entered @a offset samples into its ramp.
+   While a type fades in, the old curve is added chunk by chunk, with a copy of the ADAA history.
+ */
+void SatProcessor::saturate(uint32_t ch, const float* in, float* out, uint32_t frames, const SatSegment& s,
+                            uint32_t offset)
+{
+    if (!fading) {
+        saturateCurve(adaa_states[ch], in, out, frames, s, offset);
+        return;
+    }
+
+    float* const old = &fade_buffer[0];
+
+    for (uint32_t pos = 0; pos < frames; pos += SAT_FADE_CHUNK) {
+        const uint32_t n = (frames - pos < SAT_FADE_CHUNK) ? frames - pos : SAT_FADE_CHUNK;
+        SatAdaaState state = adaa_states[ch];
+
+        // Before the new curve, as the output may be the input
+        saturateCurve(state, in + pos, old, n, fade_segments[0], offset + pos);
+        saturateCurve(adaa_states[ch], in + pos, out + pos, n, s, offset + pos);
+
+        for (uint32_t i = 0; i < n; i++) {
+            out[pos + i] += old[i];
+        }
+    }
+}
+
+/**
+   Saturate one channel with the curve of segment @a s, with ADAA history @a state.
+ */
+void SatProcessor::saturateCurve(SatAdaaState& state, const float* in, float* out, uint32_t frames,
+                                 const SatSegment& s, uint32_t offset)
+{
+    if (adaa_active != SAT_ADAA_OFF) {
+        const SatAdaaFunc sat_adaa = sat_adaa_funcs[adaa_active - 1][s.kernel];
+
+        if (!s.ramp) {
+            sat_adaa(in, out, frames, s.c, s.wet, s.dry, 0.0f, 0.0f, state);
+            return;
+        }
+
+        // The antiderivatives are set up per call, so the coefficients of a ramp are followed in short steps, each
+        // using those at its center. The gains ramp per sample, like without ADAA.
+        for (uint32_t pos = 0; pos < frames; pos += SAT_ADAA_RAMP_STEP) {
+            const uint32_t n = (frames - pos < SAT_ADAA_RAMP_STEP) ? frames - pos : SAT_ADAA_RAMP_STEP;
+            const float start = (float)(offset + pos);
+            const SatCoeffs k = sat_coeffs_ramp(s.c, s.dc, start + 0.5f*(n - 1));
+
+            sat_adaa(in + pos, out + pos, n, k, s.wet + start*s.dwet, s.dry + start*s.ddry, s.dwet, s.ddry, state);
+        }
+        return;
+    }
+
+    // Keep the ADAA history up to date, so it can be switched on at any time
+    sat_adaa_history(in, frames, state);
+
+    if (!s.ramp) {
+        // Inputs beyond the table range would be clamped, so they are evaluated instead
+        if (s.lut != NULL && sat_peak(in, frames) <= SAT_LUT_RANGE) {
+            kernels->lut(in, out, frames, *s.lut, s.wet, s.dry);
+        }
+        else {
+            kernels->block[s.kernel](in, out, frames, s.c, s.wet, s.dry);
+        }
+    }
+    else if (offset == 0) {
+        kernels->ramp[s.kernel](in, out, frames, s.c, s.dc, s.wet, s.dry, s.dwet, s.ddry);
+    }
+    else {
+        const float t = (float)offset;
+        const SatCoeffs k = sat_coeffs_ramp(s.c, s.dc, t);
+
+        kernels->ramp[s.kernel](in, out, frames, k, s.dc, s.wet + t*s.dwet, s.dry + t*s.ddry, s.dwet, s.ddry);
+    }
+}
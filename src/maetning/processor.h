@@ -0,0 +1,373 @@
+/*
+ * Saturation processor
+ *
+ * The complete signal chain of the plugin, independent of DPF, so the plugin,
+ * the benchmark and other tools all run the same code. Parameters are given
+ * in the same units as the plugin parameters.
+ *
+ * Saturation, master volume and master mix are smoothed (see smoother.h).
+ * Their setters only store a target, and so do those of the type, the
+ * oversampling factor, the ADAA order, the bands, the crossovers and the band
+ * types, each in an atomic that process() reads once per block, or once per
+ * range between parameter events. These setters may be called from another
+ * thread than process(). The others, and reset(), must not run during it.
+ * process() splits a block where a ramp ends, so every segment is either
+ * settled and runs the plain block kernels, or follows one linear ramp with
+ * the ramp kernels.
+ *
+ * A new saturation type fades in over the smoothing time: for that long, the
+ * old and the new curve both run, the old one fading out as the new one fades
+ * in, and then the new one runs alone. A type set during a fade takes over
+ * once the fade has ended, so at most two curves ever run. In multiband mode,
+ * every band fades on its own. Types 4 and 5 switch to another kernel along
+ * the saturation axis; a saturation ramp to the other side fades between the
+ * two kernels the same way, alongside the ramp.
+ *
+ * For sample-accurate automation, process() also takes a list of timestamped
+ * parameter events, and splits the block at their frames. A block without
+ * events runs unsplit.
+ *
+ * In lookup table evaluation, settled segments interpolate the curve from a
+ * table (see lut.h) instead of evaluating it, as long as the input stays
+ * within the table range. Segments that ramp or use ADAA evaluate the curve.
+ *
+ * With more than one band, the signal is split at crossovers and every band is
+ * saturated with a type and saturation of its own (see multiband.h). Band 0,
+ * the lowest, uses the saturation and type of a single band; mix and master
+ * volume apply to all bands.
+ *
+ * Idle instances take shortcuts: silent input gives silent output without
+ * running the curves once the filters have run empty, as long as the curve
+ * passes through zero. A muted output is cleared, and a settled mix of 0 % is
+ * a scaled copy of the input where that has no latency to match. process()
+ * runs with denormals flushed to zero (see denormals.h).
+ */
+
+#ifndef PROCESSOR_H_INCLUDED
+#define PROCESSOR_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "adaa.h"
+#include "lut.h"
+#include "oversampler.h"
+#include "saturation.h"
+#include "smoother.h"
+
+// Parameter indices of setParameter() and SatParameterEvent, in the same order as the plugin parameters
+#define SAT_PARAM_SATURATION 0
+#define SAT_PARAM_TYPE 1
+#define SAT_PARAM_MASTERVOLUME 2
+#define SAT_PARAM_MASTERMIX 3
+#define SAT_PARAM_OVERSAMPLING 4
+#define SAT_PARAM_ANTIALIASING 5
+#define SAT_PARAM_BANDS 6
+#define SAT_PARAM_CROSSOVER1 7
+#define SAT_PARAM_CROSSOVER2 8
+#define SAT_PARAM_CROSSOVER3 9
+#define SAT_PARAM_SATURATION2 10
+#define SAT_PARAM_TYPE2 11
+#define SAT_PARAM_SATURATION3 12
+#define SAT_PARAM_TYPE3 13
+#define SAT_PARAM_SATURATION4 14
+#define SAT_PARAM_TYPE4 15
+
+#define NUM_SAT_PARAMS 16
+
+// Bands of the multiband mode, and the default crossover frequencies between them in Hz
+#define SAT_MAX_BANDS 4
+#define SAT_CROSSOVER1_HZ 200.0f
+#define SAT_CROSSOVER2_HZ 2000.0f
+#define SAT_CROSSOVER3_HZ 8000.0f
+
+// Frames of silent input and output after which the oversampling filters and the ADAA history only hold silence.
+// The longest chain, 8x, runs empty after about twice its latency.
+#define SAT_SILENCE_FRAMES 256
+
+// Samples of the old curve computed at a time while a type fades in, which sizes the buffer for them
+#define SAT_FADE_CHUNK 64
+
+// Evaluation modes of the saturation curves
+#define SAT_EVAL_EXACT 0   // evaluate the curve for every sample
+#define SAT_EVAL_LUT 1     // interpolate it from a lookup table
+#define SAT_EVAL_APPROX 2  // evaluate it with approximate divisions, see SAT_MATH_APPROX
+
+/**
+   A parameter change at frame @a frame of a block.
+ */
+struct SatParameterEvent
+{
+    uint32_t frame;
+    uint32_t index;
+    float value;
+};
+
+/**
+   Frames in which all smoothed parameters are either constant or ramp linearly.
+ */
+struct SatSegment
+{
+    int kernel;
+    bool ramp;
+
+    SatCoeffs c, dc;
+
+    // Gains of the wet and dry signal, including the master volume, see sat_gains()
+    float wet, dry;
+    float dwet, ddry;
+
+    // Table of the curve, or NULL to evaluate it
+    const SatLut* lut;
+};
+
+/**
+   Linear gain of master volume @a db in dB. Below -50 dB the output is muted.
+ */
+float sat_volume_gain(float db);
+
+/**
+   Advance the smoothers of saturation @a saturation in percent, master volume @a volume as a gain and master mix
+   @a mix as the wet share by @a frames frames, and set up segment @a s with the coefficients and gains of kernel
+   @a kernel of saturation type @a type that follow them. Ramps are spread over @a samples samples, the frames at the
+   rate the curve runs at. No table is set.
+ */
+void sat_segment_prepare(SatSegment& s, int type, int kernel, SatSmoother& saturation, SatSmoother& volume,
+                         SatSmoother& mix, uint32_t frames, uint32_t samples);
+
+/**
+   Set up segment @a s of kernel @a kernel of saturation type @a type, in which saturation, master volume and master
+   mix move from the values ending in 0 to those ending in 1 over @a samples samples. No table is set. See
+   sat_coeffs_interpolate_kernel() for a saturation past the rows of the kernel.
+ */
+void sat_segment_prepare(SatSegment& s, int type, int kernel, float saturation0, float saturation1, float volume0,
+                         float volume1, float mix0, float mix1, uint32_t samples);
+
+/**
+   Scale the wet gain of segment @a s from @a gain0 at its start to @a gain1 at its end, @a samples samples later,
+   to fade a type in or out. The segment ramps from then on.
+ */
+void sat_segment_fade(SatSegment& s, float gain0, float gain1, uint32_t samples);
+
+class SatMultiband;
+
+class SatProcessor
+{
+public:
+    /**
+       Create a processor for @a channels channels, which are processed together as one bus.
+       This allocates all buffers, and picks the SIMD kernels for this CPU.
+     */
+    SatProcessor(uint32_t channels);
+    ~SatProcessor();
+
+    /**
+       Sample rate in Hz, which sets the length of the smoothing ramps and designs the crossovers for the current
+       bands. Everything that depends on the rate is set up here, so process() only follows parameter changes.
+       Not realtime safe.
+     */
+    void setSampleRate(double rate);
+
+    /**
+       Length of the smoothing ramps in milliseconds, SAT_SMOOTHING_TIME_MS by default.
+     */
+    void setSmoothingTime(float ms);
+
+    /**
+       Saturation in percent, 0 to 100. Fractions interpolate between the steps of the coefficient tables,
+       and a change is smoothed.
+     */
+    void setSaturation(float percent);
+
+    /**
+       Saturation type, 0 to NUM_SATURATIONS - 1. The new curve is crossfaded in over the smoothing time.
+     */
+    void setType(int type);
+
+    /**
+       Master volume in dB, smoothed. Below -50 dB the output is muted.
+     */
+    void setMasterVolume(float db);
+
+    /**
+       Amount of saturated signal in percent, 0 to 100, smoothed.
+     */
+    void setMasterMix(float percent);
+
+    /**
+       Oversampling factor, rounded down to 1, 2, 4 or 8.
+       The new factor takes effect at the start of the next process() call.
+     */
+    void setOversampling(uint32_t factor);
+
+    /**
+       Order of antiderivative anti-aliasing, SAT_ADAA_OFF, SAT_ADAA_FIRST_ORDER or SAT_ADAA_SECOND_ORDER.
+     */
+    void setAntialiasing(int order);
+
+    /**
+       Number of bands, 1 to SAT_MAX_BANDS, where 1 saturates the whole signal with one curve. Bands run without
+       oversampling and ADAA. The new number takes effect at the start of the next process() call, from clean filters.
+     */
+    void setBands(uint32_t count);
+
+    /**
+       Frequency in Hz of crossover @a index, 0 to SAT_MAX_BANDS - 2, between bands @a index and @a index + 1.
+       A crossover below the one before it is raised to it.
+     */
+    void setCrossover(uint32_t index, float hz);
+
+    /**
+       Saturation in percent of band @a band, smoothed like setSaturation(), which is that of band 0.
+     */
+    void setBandSaturation(uint32_t band, float percent);
+
+    /**
+       Saturation type of band @a band, like setType(), which is that of band 0.
+     */
+    void setBandType(uint32_t band, int type);
+
+    /**
+       How the curves are evaluated, SAT_EVAL_EXACT, SAT_EVAL_LUT or SAT_EVAL_APPROX. Lookup tables come from the
+       cache all processors share (see lut.h), which is attached to when SAT_EVAL_LUT is first set, and started if
+       this is the first processor to use it, so this is not realtime safe. Until the table
+       for the current saturation and type is built, the curve is evaluated. SAT_EVAL_APPROX trades the last bits
+       of types 1, 4 and 5 for speed: the output differs by up to 4e-6 for inputs within +-3. It changes nothing
+       with the scalar kernels.
+     */
+    void setEvaluation(int mode);
+
+    /**
+       Block until the lookup table for the current saturation and type is built, e.g. before offline processing.
+       Does nothing unless the evaluation is SAT_EVAL_LUT.
+     */
+    void waitForLut();
+
+    /**
+       Measured maximum error of the lookup table used last, in the unit of the signal, or 0 if none was used.
+     */
+    float getLutError() const;
+
+    /**
+       Set parameter @a index, one of SAT_PARAM_*, with the setter above that belongs to it.
+     */
+    void setParameter(uint32_t index, float value);
+
+    /**
+       Latency in frames of the oversampling factor currently in effect, and of second order ADAA. With more than one
+       band, there is none.
+     */
+    uint32_t getLatency() const;
+
+    /**
+       Clear all filter state and end all ramps, e.g. when the plugin is activated. The crossovers of the number of
+       bands set last are designed here too.
+     */
+    void reset();
+
+    /**
+       Process @a frames frames of all channels. Inputs and outputs may be the same buffers.
+     */
+    void process(const float* const* inputs, float* const* outputs, uint32_t frames);
+
+    /**
+       Like process(), with @a count parameter events sorted by frame. Each event takes effect at its frame,
+       and events at or beyond @a frames take effect at the end of the block.
+     */
+    void process(const float* const* inputs, float* const* outputs, uint32_t frames,
+                 const SatParameterEvent* events, uint32_t count);
+
+    /**
+       Use the kernels of instruction set @a isa instead of the detected ones, see sat_kernels_isa().
+       Returns false if they are not available.
+     */
+    bool setIsa(const char* isa);
+
+    /**
+       Name of the instruction set of the kernels in use.
+     */
+    const char* getIsa() const;
+
+private:
+    void updateSmoothingLength();
+    void requestLut();
+    void loadCrossovers(float* hz) const;
+    void loadTypes(int* types) const;
+    void processRange(const float* const* inputs, float* const* outputs, uint32_t begin, uint32_t end);
+    void prepareSegment(SatSegment& s, uint32_t frames);
+    void prepareBands(uint32_t frames);
+    void prepareFade(uint32_t band, SatSegment& s, float saturation0, float saturation1, float volume0,
+                     float volume1, float mix0, float mix1, uint32_t frames, uint32_t samples);
+    void processBands(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames);
+    void processSegment(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames,
+                        const SatSegment& s);
+    bool processShortcut(const float* const* inputs, float* const* outputs, uint32_t pos, uint32_t frames,
+                         const SatSegment& s);
+    void saturate(uint32_t ch, const float* in, float* out, uint32_t frames, const SatSegment& s, uint32_t offset);
+    void saturateCurve(SatAdaaState& state, const float* in, float* out, uint32_t frames, const SatSegment& s,
+                       uint32_t offset);
+
+    const SatKernels* kernels;
+    const char* isa;
+
+    uint32_t channels;
+
+    double sample_rate;
+    float smoothing_time;
+
+    // Saturation in percent, master volume as a gain and master mix as the wet gain
+    SatSmoother saturation;
+    SatSmoother volume;
+    SatSmoother mix;
+
+    // Target type of band 0, set from any thread
+    std::atomic<int> type;
+
+    // Per band, the type and kernel in effect, and while they fade in, those they replace and their segment. Band 0
+    // is the single band. A buffer for the output of the old curve of a single band, and the fading segments of the
+    // bands.
+    int type_active[SAT_MAX_BANDS];
+    int kernel_active[SAT_MAX_BANDS];
+    int fade_type[SAT_MAX_BANDS];
+    int fade_kernel[SAT_MAX_BANDS];
+    uint32_t fade_length;
+    uint32_t fade_remaining[SAT_MAX_BANDS];
+    bool fading;
+    SatSegment fade_segments[SAT_MAX_BANDS];
+    std::vector<float> fade_buffer;
+    const SatSegment* band_fades[SAT_MAX_BANDS];
+
+    // Target number of bands, crossovers, and saturation and type of bands 1 to SAT_MAX_BANDS - 1, set from any
+    // thread, the number of bands in effect, and the segments of all bands
+    std::atomic<uint32_t> bands;
+    uint32_t bands_active;
+    std::atomic<float> crossovers[SAT_MAX_BANDS - 1];
+    SatSmoother band_saturation[SAT_MAX_BANDS - 1];
+    std::atomic<int> band_type[SAT_MAX_BANDS - 1];
+    SatSegment band_segments[SAT_MAX_BANDS];
+    std::unique_ptr<SatMultiband> multiband;
+
+    // Target oversampling factor and ADAA order, set from any thread, and those in effect
+    std::atomic<uint32_t> oversampling;
+    uint32_t oversampling_active;
+    Oversampler oversampler;
+
+    std::atomic<int> adaa_order;
+    int adaa_active;
+    std::vector<SatAdaaState> adaa_states;
+
+    // Consecutive settled frames of silent input and output so far, up to SAT_SILENCE_FRAMES
+    uint32_t silent_frames;
+
+    int evaluation;
+    std::unique_ptr<SatLutBuilder> lut_builder;
+    float lut_error;
+
+    // Channel pointers of the segment being processed
+    std::vector<const float*> bus_inputs;
+    std::vector<float*> bus_outputs;
+};
+
+#endif // PROCESSOR_H_INCLUDED
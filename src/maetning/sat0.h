@@ -1,5 +1,5 @@
 #define SAT0_COEFFS_LENGTH 101
-const float sat0_coeffs[][5] = {
+constexpr float sat0_coeffs[][5] = {
     { 1.00381, 1.00378, -0.654707, 1.00384, 0.67912 },
     { 1.0075, 1.00712, 0.275586, 1.00651, -0.404481 },
     { 1.01765, 1.01605, 0.36706, 1.01238, -0.351478 },
@@ -1,5 +1,5 @@
 #define SAT1_COEFFS_LENGTH 101
-const float sat1_coeffs[][3] = {
+constexpr float sat1_coeffs[][3] = {
     { -2.15876e-05,0.996228,-5.16094e-05},
     { 0.000661507,0.992408,5.95507e-05},
     { 0.00353305,0.981808,0.000776531},
@@ -1,7 +1,7 @@
 // Modeled after Camel Crusher DistTube
 
 #define SAT2_COEFFS_LENGTH 101
-const float sat2_coeffs[][4] = {
+constexpr float sat2_coeffs[][4] = {
     { 1, -0.000207935, 0.999713, -9.81884e-05 },
     { 1.048, 1.993, 4.17732, 1.18892 },
     { 1.08, 1.73605, 3.74991, 1.02497 },
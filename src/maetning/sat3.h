@@ -1,7 +1,7 @@
 // Modeled after Camel Crusher DistMech
 
 #define SAT3_COEFFS_LENGTH 101
-const float sat3_coeffs[][3] = {
+constexpr float sat3_coeffs[][3] = {
     { 1, 1.00007, 5.38307e-05 },
     { 1.12, 0.675717, -0.24321 },
     { 1.2, 0.55556, -0.333334 },
@@ -1,6 +1,6 @@
 #define SAT4_COEFFS_LENGTH 101
 
-const float sat4_coeffs[][10] = {
+constexpr float sat4_coeffs[][10] = {
     { 1.01098,0.00124656,0.00152633,-0.0125889,0,0,0,0,0,0},
     { 1.01092,0.00126871,0.0017335,-0.0131634,0,0,0,0,0,0},
     { 1.01087,0.00130091,0.00194251,-0.0137629,0,0,0,0,0,0},
@@ -1,6 +1,6 @@
 #define SAT5_COEFFS_LENGTH 101
 
-const float sat5_coeffs[][10] = {
+constexpr float sat5_coeffs[][10] = {
     { 1.00987,0.0021846,0.00629453,-0.0229679,0,0,0,0,0,0},
     { 1.00967,0.0022674,0.00694615,-0.0239854,0,0,0,0,0,0},
     { 1.00947,0.0024156,0.00759309,-0.0250449,0,0,0,0,0,0},
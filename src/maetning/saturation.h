@@ -0,0 +1,922 @@
+/*
+ * Saturation block kernels
+ *
+ * Every saturation algorithm has its own block kernel, so the inner loop is a
+ * straight-line body without a per-sample switch. The kernel is selected once
+ * per block from a SatKernels table.
+ *
+ * Types 4 and 5 share the same transfer functions, but switch between a
+ * low-gain and a high-gain curve depending on p9. This is resolved when the
+ * coefficients are loaded, so each of the two curves gets a kernel of its own.
+ * A saturation ramp across the row where they switch crossfades the two
+ * curves, like a change of type (see processor.h).
+ *
+ * The saturation amount is continuous: coefficients are interpolated between
+ * the two nearest table rows, and while a parameter is smoothed (see
+ * smoother.h), the ramp kernels move the coefficients and the gains linearly,
+ * sample by sample, instead of stepping at block boundaries.
+ *
+ * Mix and master volume are folded into two gains per block, so every kernel
+ * computes out = wet*f(x) + dry*x in one pass, where @a wet and @a dry already
+ * include the volume (see sat_gains()).
+ *
+ * As an alternative to evaluating a curve, a settled curve can be baked into
+ * a lookup table (see lut.h), which the LUT kernels interpolate linearly.
+ *
+ * The lane kernels run SAT_LANES unrelated signals of the same kernel at once,
+ * each with coefficients and gains of its own, e.g. the channels of many
+ * processors in a batch (see batch.h). The signals are interleaved, so a
+ * vector holds one frame of several lanes.
+ */
+
+#ifndef SATURATION_H_INCLUDED
+#define SATURATION_H_INCLUDED
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sat0.h"
+#include "sat1.h"
+#include "sat2.h"
+#include "sat3.h"
+#include "sat4.h"
+#include "sat5.h"
+
+#define NUM_SATURATIONS 6
+#define NUM_SATURATION_STEPS 101
+
+#define SAT_KERNEL_PIECEWISE 0  // sat0
+#define SAT_KERNEL_RATIONAL 1   // sat1
+#define SAT_KERNEL_TUBE 2       // sat2
+#define SAT_KERNEL_MECH 3       // sat3
+#define SAT_KERNEL_LOWGAIN 4    // sat4 and sat5 with p9 == 0
+#define SAT_KERNEL_HIGHGAIN 5   // sat4 and sat5 with p9 == 1
+
+#define NUM_SAT_KERNELS 6
+
+// Signals of the lane kernels, a multiple of the widest vector
+#define SAT_LANES 16
+
+// Cascaded biquads per lane of the lane filter kernel
+#define SAT_BIQUAD_STAGES 6
+
+// How the kernels divide, see sat_div()
+#define SAT_MATH_EXACT 0
+#define SAT_MATH_APPROX 1
+
+// Lookup tables cover inputs from -SAT_LUT_RANGE to SAT_LUT_RANGE in SAT_LUT_SIZE intervals
+#define SAT_LUT_SIZE 4096
+#define SAT_LUT_RANGE 2.0f
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+   Coefficients of one saturation curve. Ramp kernels use vectors of them, with one coefficient per sample.
+   Some curves keep derived constants in coefficients they do not use, see sat_coeffs_row().
+ */
+template <typename T>
+struct SatCoeffsT
+{
+    T p0, p1, p2, p3, p4, p5, p6, p7, p8, p9;
+
+    // Derived knee offsets for sat0
+    T bp, bn;
+};
+
+typedef SatCoeffsT<float> SatCoeffs;
+
+typedef void (*SatBlockFunc)(const float* in, float* out, uint32_t frames, const SatCoeffs& c,
+                             float wet, float dry);
+
+// Like SatBlockFunc, with the coefficients c + n*dc and the gains wet + n*dwet etc. at sample n
+typedef void (*SatRampFunc)(const float* in, float* out, uint32_t frames, const SatCoeffs& c, const SatCoeffs& dc,
+                            float wet, float dry, float dwet, float ddry);
+
+// Like SatBlockFunc and SatRampFunc, for @a channels channels at once. in[ch] and out[ch] may be the same buffer.
+typedef void (*SatBlockMultiFunc)(const float* const* in, float* const* out, uint32_t channels, uint32_t frames,
+                                  const SatCoeffs& c, float wet, float dry);
+typedef void (*SatRampMultiFunc)(const float* const* in, float* const* out, uint32_t channels, uint32_t frames,
+                                 const SatCoeffs& c, const SatCoeffs& dc, float wet, float dry,
+                                 float dwet, float ddry);
+
+/**
+   Coefficients and gains of SAT_LANES signals, one per lane, for the lane kernels. Coefficient sets of a ramp hold
+   the per-sample steps, with those of the gains in @a wet and @a dry.
+ */
+struct SatLaneCoeffs
+{
+    float p0[SAT_LANES], p1[SAT_LANES], p2[SAT_LANES], p3[SAT_LANES], p4[SAT_LANES];
+    float p5[SAT_LANES], p6[SAT_LANES], p7[SAT_LANES], p8[SAT_LANES], p9[SAT_LANES];
+    float bp[SAT_LANES], bn[SAT_LANES];
+    float wet[SAT_LANES], dry[SAT_LANES];
+};
+
+// Like SatBlockFunc, for SAT_LANES signals interleaved frame by frame: sample n of lane l is in[n*SAT_LANES + l].
+// Only lanes 0 to @a lanes - 1 are needed; the SIMD kernels round them up to whole vectors.
+typedef void (*SatLanesFunc)(const float* in, float* out, uint32_t lanes, uint32_t frames, const SatLaneCoeffs& c);
+
+// Like SatLanesFunc, with the coefficients and gains c + n*dc at frame n
+typedef void (*SatLanesRampFunc)(const float* in, float* out, uint32_t lanes, uint32_t frames,
+                                 const SatLaneCoeffs& c, const SatLaneCoeffs& dc);
+
+// Interleave the signals in[0] to in[SAT_LANES - 1] for the lane kernels, and split them into out[0] etc. again.
+// Only lanes 0 to @a lanes - 1 are needed, but the SIMD kernels move four at a time, so all pointers must be valid.
+typedef void (*SatInterleaveFunc)(const float* const* in, float* x, uint32_t lanes, uint32_t frames);
+typedef void (*SatDeinterleaveFunc)(const float* x, float* const* out, uint32_t lanes, uint32_t frames);
+
+/**
+   A cascade of up to SAT_BIQUAD_STAGES biquads per lane, with coefficients of their own, normalized so a0 is 1,
+   and the state of each biquad in transposed direct form II.
+ */
+struct SatBiquadLanes
+{
+    float b0[SAT_BIQUAD_STAGES][SAT_LANES], b1[SAT_BIQUAD_STAGES][SAT_LANES], b2[SAT_BIQUAD_STAGES][SAT_LANES];
+    float a1[SAT_BIQUAD_STAGES][SAT_LANES], a2[SAT_BIQUAD_STAGES][SAT_LANES];
+    float s1[SAT_BIQUAD_STAGES][SAT_LANES], s2[SAT_BIQUAD_STAGES][SAT_LANES];
+};
+
+// Filter interleaved signals like those of SatLanesFunc in place, through the first @a stages biquads of @a f
+typedef void (*SatBiquadLanesFunc)(float* x, uint32_t lanes, uint32_t frames, uint32_t stages, SatBiquadLanes& f);
+
+/**
+   A saturation curve sampled at SAT_LUT_SIZE + 1 evenly spaced inputs. The last entry is repeated once,
+   so the interpolation at the upper end needs no special case. 16 kB, so a table stays in the L1 or L2 cache.
+ */
+struct SatLut
+{
+    float y[SAT_LUT_SIZE + 2];
+};
+
+// Like SatBlockFunc, with the curve interpolated from @a lut. Inputs outside the table range are clamped to it.
+typedef void (*SatLutFunc)(const float* in, float* out, uint32_t frames, const SatLut& lut,
+                           float wet, float dry);
+
+typedef void (*SatFilterFunc)(const float* coeffs, uint32_t taps, const float* x, float* out, uint32_t frames);
+
+/**
+   The kernels for one instruction set.
+ */
+struct SatKernels
+{
+    // Saturation and dry/wet mix, indexed by SAT_KERNEL_*
+    SatBlockFunc block[NUM_SAT_KERNELS];
+
+    // The same with ramping coefficients and gains
+    SatRampFunc ramp[NUM_SAT_KERNELS];
+
+    // Both for all channels of a bus at once
+    SatBlockMultiFunc block_multi[NUM_SAT_KERNELS];
+    SatRampMultiFunc ramp_multi[NUM_SAT_KERNELS];
+
+    // SAT_LANES signals with coefficients of their own
+    SatLanesFunc lanes[NUM_SAT_KERNELS];
+    SatLanesRampFunc lanes_ramp[NUM_SAT_KERNELS];
+    SatInterleaveFunc interleave;
+    SatDeinterleaveFunc deinterleave;
+
+    // Cascaded biquads across lanes, see sat_biquad_lanes()
+    SatBiquadLanesFunc biquad_lanes;
+
+    // Any curve, from a lookup table
+    SatLutFunc lut;
+
+    // Symmetric FIR filter, see sat_filter()
+    SatFilterFunc filter;
+
+    // Floats per vector, 1 for the scalar kernels
+    uint32_t width;
+};
+
+// -----------------------------------------------------------------------------------------------------------
+// Coefficient bank
+//
+// The rows of sat0.h to sat5.h are converted at compile time into one bank of
+// 64-byte aligned rows, one cache line each, which hold the coefficients in
+// the layout of SatCoeffs together with everything derived from them: the
+// knee offsets of sat0, the negated terms of sat2 and sat3, and the kernel,
+// which for types 4 and 5 tells the low-gain and high-gain curves apart.
+
+/**
+   One row of the coefficient bank.
+ */
+struct alignas(64) SatCoeffRow
+{
+    SatCoeffs c;
+    int kernel;
+};
+
+static_assert(sizeof(SatCoeffRow) == 64, "a coefficient row is one cache line");
+
+/**
+   The row of the bank for row @a r of the table of @a type. Unused coefficients are 0, except:
+   sat2 keeps -p1 in p4 and -p3 in p5, and sat3 keeps -p2 in p3, for the upper branches of their curves.
+ */
+constexpr SatCoeffRow sat_coeffs_row(int type, const float* r)
+{
+    return (type == 0) ? SatCoeffRow{ { r[0], r[1], r[2], r[3], r[4], 0, 0, 0, 0, 0,
+                                        r[2] - r[1]*r[2]/r[0], r[4] - r[3]*r[4]/r[0] }, SAT_KERNEL_PIECEWISE }
+         : (type == 1) ? SatCoeffRow{ { r[0], r[1], r[2], 0, 0, 0, 0, 0, 0, 0, 0, 0 }, SAT_KERNEL_RATIONAL }
+         : (type == 2) ? SatCoeffRow{ { r[0], r[1], r[2], r[3], -r[1], -r[3], 0, 0, 0, 0, 0, 0 }, SAT_KERNEL_TUBE }
+         : (type == 3) ? SatCoeffRow{ { r[0], r[1], r[2], -r[2], 0, 0, 0, 0, 0, 0, 0, 0 }, SAT_KERNEL_MECH }
+         : SatCoeffRow{ { r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7], r[8], r[9], 0, 0 },
+                        (r[9] == 0) ? SAT_KERNEL_LOWGAIN : SAT_KERNEL_HIGHGAIN };
+}
+
+constexpr const float* sat_coeffs_table_row(int type, int step)
+{
+    return (type == 0) ? sat0_coeffs[step]
+         : (type == 1) ? sat1_coeffs[step]
+         : (type == 2) ? sat2_coeffs[step]
+         : (type == 3) ? sat3_coeffs[step]
+         : (type == 4) ? sat4_coeffs[step]
+         : sat5_coeffs[step];
+}
+
+struct SatCoeffBank
+{
+    SatCoeffRow rows[NUM_SATURATIONS*NUM_SATURATION_STEPS];
+};
+
+// 0, 1, ..., N - 1 as a parameter pack, for building the bank
+template <int... I>
+struct SatIndices
+{
+};
+
+template <int N, int... I>
+struct SatMakeIndices : SatMakeIndices<N - 1, N - 1, I...>
+{
+};
+
+template <int... I>
+struct SatMakeIndices<0, I...>
+{
+    typedef SatIndices<I...> type;
+};
+
+template <int... I>
+constexpr SatCoeffBank sat_coeffs_make_bank(SatIndices<I...>)
+{
+    return SatCoeffBank{ { sat_coeffs_row(I/NUM_SATURATION_STEPS,
+                                          sat_coeffs_table_row(I/NUM_SATURATION_STEPS, I%NUM_SATURATION_STEPS))... } };
+}
+
+static constexpr SatCoeffBank sat_coeff_bank =
+    sat_coeffs_make_bank(SatMakeIndices<NUM_SATURATIONS*NUM_SATURATION_STEPS>::type());
+
+/**
+   Load one row of coefficients for a saturation type and return the kernel that evaluates it.
+ */
+static inline int sat_coeffs_load(int type, int step, SatCoeffs& c)
+{
+    if (type < 0) type = 0;
+    if (type > NUM_SATURATIONS - 1) type = NUM_SATURATIONS - 1;
+    if (step < 0) step = 0;
+    if (step > NUM_SATURATION_STEPS - 1) step = NUM_SATURATION_STEPS - 1;
+
+    const SatCoeffRow& row = sat_coeff_bank.rows[type*NUM_SATURATION_STEPS + step];
+    c = row.c;
+    return row.kernel;
+}
+
+/**
+   Load the coefficients for a fractional saturation @a step, interpolated between the two nearest rows.
+   Returns the kernel, like sat_coeffs_load(). Whole steps give exactly the table row.
+ */
+static inline int sat_coeffs_interpolate(int type, float step, SatCoeffs& c)
+{
+    if (!(step > 0.0f)) step = 0.0f;
+    if (step > NUM_SATURATION_STEPS - 1) step = NUM_SATURATION_STEPS - 1;
+
+    const int row = (int)step;
+    const float frac = step - row;
+    const int kernel = sat_coeffs_load(type, row, c);
+
+    if (frac == 0.0f) {
+        return kernel;
+    }
+
+    SatCoeffs next;
+    const int kernel_next = sat_coeffs_load(type, row + 1, next);
+
+    // Types 4 and 5 switch curves between some rows, which cannot be blended; take the nearest row. Ramps across
+    // them crossfade the two curves instead, see sat_coeffs_interpolate_kernel().
+    if (kernel_next != kernel) {
+        if (frac >= 0.5f) {
+            c = next;
+            return kernel_next;
+        }
+        return kernel;
+    }
+
+    // All of a row at once, which the compiler turns into a few vector operations; p9 is the same in both rows
+    c.p0 += frac*(next.p0 - c.p0);
+    c.p1 += frac*(next.p1 - c.p1);
+    c.p2 += frac*(next.p2 - c.p2);
+    c.p3 += frac*(next.p3 - c.p3);
+    c.p4 += frac*(next.p4 - c.p4);
+    c.p5 += frac*(next.p5 - c.p5);
+    c.p6 += frac*(next.p6 - c.p6);
+    c.p7 += frac*(next.p7 - c.p7);
+    c.p8 += frac*(next.p8 - c.p8);
+    c.p9 += frac*(next.p9 - c.p9);
+    c.bp += frac*(next.bp - c.bp);
+    c.bn += frac*(next.bn - c.bn);
+
+    // The knees of sat0 stay continuous
+    if (kernel == SAT_KERNEL_PIECEWISE) {
+        c.bp = c.p2 - c.p1*c.p2/c.p0;
+        c.bn = c.p4 - c.p3*c.p4/c.p0;
+    }
+
+    return kernel;
+}
+
+/**
+   The kernel of @a type at a fractional saturation @a step, see sat_coeffs_interpolate().
+ */
+static inline int sat_coeffs_kernel(int type, float step)
+{
+    SatCoeffs c;
+    return sat_coeffs_interpolate(type, step, c);
+}
+
+/**
+   Load the coefficients for a fractional saturation @a step like sat_coeffs_interpolate(), but for kernel @a kernel
+   of @a type. Past the row where types 4 and 5 switch kernels, they stay at the last row of @a kernel, so a curve can
+   fade out there while the other kernel fades in.
+ */
+static inline void sat_coeffs_interpolate_kernel(int type, int kernel, float step, SatCoeffs& c)
+{
+    if (sat_coeffs_interpolate(type, step, c) == kernel) {
+        return;
+    }
+
+    if (!(step > 0.0f)) step = 0.0f;
+    if (step > NUM_SATURATION_STEPS - 1) step = NUM_SATURATION_STEPS - 1;
+
+    // The nearest row of the kernel, on one side or the other
+    const int row = (int)step;
+
+    for (int d = 0; d < NUM_SATURATION_STEPS; d++) {
+        if (row - d >= 0 && sat_coeffs_load(type, row - d, c) == kernel) {
+            return;
+        }
+        if (row + 1 + d < NUM_SATURATION_STEPS && sat_coeffs_load(type, row + 1 + d, c) == kernel) {
+            return;
+        }
+    }
+
+    // A kernel the type does not use
+    sat_coeffs_interpolate(type, step, c);
+}
+
+/**
+   Per-sample step @a dc that ramps from @a from to @a to in @a frames samples.
+ */
+static inline void sat_coeffs_delta(const SatCoeffs& from, const SatCoeffs& to, uint32_t frames, SatCoeffs& dc)
+{
+    const float scale = 1.0f/frames;
+
+    dc.p0 = (to.p0 - from.p0)*scale;
+    dc.p1 = (to.p1 - from.p1)*scale;
+    dc.p2 = (to.p2 - from.p2)*scale;
+    dc.p3 = (to.p3 - from.p3)*scale;
+    dc.p4 = (to.p4 - from.p4)*scale;
+    dc.p5 = (to.p5 - from.p5)*scale;
+    dc.p6 = (to.p6 - from.p6)*scale;
+    dc.p7 = (to.p7 - from.p7)*scale;
+    dc.p8 = (to.p8 - from.p8)*scale;
+    dc.p9 = (to.p9 - from.p9)*scale;
+    dc.bp = (to.bp - from.bp)*scale;
+    dc.bn = (to.bn - from.bn)*scale;
+}
+
+/**
+   The coefficients c + n*dc of sample @a n of a ramp, for a number or vector type T.
+   The knee offsets of sat0 are ramped linearly as well, which keeps its knees continuous at both ends of a ramp.
+ */
+template <typename T>
+static inline SatCoeffsT<T> sat_coeffs_ramp(const SatCoeffs& c, const SatCoeffs& dc, T n)
+{
+    SatCoeffsT<T> k = {
+        c.p0 + n*dc.p0, c.p1 + n*dc.p1, c.p2 + n*dc.p2, c.p3 + n*dc.p3, c.p4 + n*dc.p4,
+        c.p5 + n*dc.p5, c.p6 + n*dc.p6, c.p7 + n*dc.p7, c.p8 + n*dc.p8, c.p9 + n*dc.p9,
+        c.bp + n*dc.bp, c.bn + n*dc.bn,
+    };
+    return k;
+}
+
+/**
+   Gains of the wet and dry signal for master mix @a mix (the wet share, 0 to 1) and master volume @a volume
+   (linear), so the kernels apply both with two multiplies.
+ */
+static inline void sat_gains(float mix, float volume, float& wet, float& dry)
+{
+    wet = mix*volume;
+    dry = (1.0f - mix)*volume;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// Transfer functions
+//
+// The curves are written once for any number type T, so the scalar kernels
+// below and the SIMD kernels in saturation_simd.h share the same definition.
+// Branches are written as selects, which turn into blends on vector types.
+// The coefficients C are either a SatCoeffs or, when ramping, a SatCoeffsT<T>.
+//
+// The knee thresholds of sat2 were compared as doubles (s < -0.6); for a float
+// s this is the same as s <= -0.6f, since -0.6f is the first float below -0.6.
+// The negated coefficients of their upper branches come from the coefficient
+// bank, see sat_coeffs_row().
+//
+// Everything here has internal linkage: the SIMD translation units are built
+// with different instruction sets, and their copies must never be merged.
+
+namespace {
+
+static inline float sat_abs(float x)
+{
+    return std::abs(x);
+}
+
+static inline float sat_select(bool mask, float a, float b)
+{
+    return mask ? a : b;
+}
+
+static inline double sat_abs(double x)
+{
+    return std::abs(x);
+}
+
+static inline double sat_select(bool mask, double a, double b)
+{
+    return mask ? a : b;
+}
+
+// Scalars have no fast reciprocal estimate, so their approximate division is exact
+static inline float sat_div_approx(float a, float b)
+{
+    return a/b;
+}
+
+static inline double sat_div_approx(double a, double b)
+{
+    return a/b;
+}
+
+/**
+   a / b, or with SAT_MATH_APPROX, a times a reciprocal estimate of b refined by Newton-Raphson on vector types,
+   see sat_div_approx() in saturation_simd.h.
+ */
+template <int MATH, typename T>
+static inline T sat_div(T a, T b)
+{
+    return (MATH == SAT_MATH_APPROX) ? sat_div_approx(a, b) : a/b;
+}
+
+template <int KERNEL, int MATH = SAT_MATH_EXACT>
+struct SatCurve;
+
+template <int MATH>
+struct SatCurve<SAT_KERNEL_PIECEWISE, MATH>
+{
+    template <typename C, typename T>
+    static inline T apply(const C& c, T x)
+    {
+        const T y = c.p0*x;
+        return sat_select(y > c.p2, c.p1*x + c.bp, sat_select(y < c.p4, c.p3*x + c.bn, y));
+    }
+};
+
+template <int MATH>
+struct SatCurve<SAT_KERNEL_RATIONAL, MATH>
+{
+    template <typename C, typename T>
+    static inline T apply(const C& c, T x)
+    {
+        return sat_div<MATH, T>(x, c.p1 + c.p0*sat_abs(x)) + c.p2*sat_abs(x);
+    }
+};
+
+template <int MATH>
+struct SatCurve<SAT_KERNEL_TUBE, MATH>
+{
+    template <typename C, typename T>
+    static inline T apply(const C& c, T x)
+    {
+        const T s = c.p0*x;
+        const T lo = c.p1*s*s + c.p2*s + c.p3;
+        const T hi = c.p4*s*s + c.p2*s + c.p5;
+        return sat_select(s <= -0.6f, lo, sat_select(s >= 0.6f, hi, s));
+    }
+};
+
+template <int MATH>
+struct SatCurve<SAT_KERNEL_MECH, MATH>
+{
+    template <typename C, typename T>
+    static inline T apply(const C& c, T x)
+    {
+        const T s = c.p0*x;
+        return sat_select(s < -0.75f, c.p1*s + c.p2, sat_select(s > 0.75f, c.p1*s + c.p3, s));
+    }
+};
+
+template <int MATH>
+struct SatCurve<SAT_KERNEL_LOWGAIN, MATH>
+{
+    template <typename C, typename T>
+    static inline T apply(const C& c, T x)
+    {
+        const T abs_x = sat_abs(x);
+        return sat_div<MATH, T>(x, c.p0 + c.p1*abs_x + c.p2*abs_x*abs_x) + c.p3*abs_x;
+    }
+};
+
+template <int MATH>
+struct SatCurve<SAT_KERNEL_HIGHGAIN, MATH>
+{
+    template <typename C, typename T>
+    static inline T apply(const C& c, T x)
+    {
+        const T abs_x = sat_abs(x);
+        const T neg = sat_div<MATH, T>(x, c.p0 + c.p1*abs_x) + c.p2*abs_x;
+        const T pos = sat_div<MATH, T>(c.p3*(c.p4*x*x + c.p5*x), x*x + c.p6*x + c.p7) + c.p8*x;
+        return sat_select(x < 0.0f, neg, pos);
+    }
+};
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------------
+// Block kernels
+
+/**
+   Saturate a block of samples and mix the result with the dry signal, with gains that include the master volume.
+   @a in and @a out may point to the same buffer.
+ */
+template <int KERNEL>
+static void sat_block(const float* in, float* out, uint32_t frames, const SatCoeffs& c,
+                      float wet, float dry)
+{
+    // Local copy, so the coefficients stay in registers while storing to out
+    const SatCoeffs k = c;
+
+    for (uint32_t n = 0; n < frames; n++) {
+        const float x = in[n];
+        float y = SatCurve<KERNEL>::apply(k, x);
+
+        out[n] = wet*y + dry*x;
+    }
+}
+
+/**
+   Frames @a begin to @a end of a ramp kernel, so the SIMD kernels can finish a ramp with the scalar kernel.
+ */
+template <int KERNEL>
+static void sat_block_ramp_range(const float* in, float* out, uint32_t begin, uint32_t end,
+                                 const SatCoeffs& c, const SatCoeffs& dc, float wet, float dry,
+                                 float dwet, float ddry)
+{
+    const SatCoeffs k0 = c;
+    const SatCoeffs dk = dc;
+
+    for (uint32_t n = begin; n < end; n++) {
+        const SatCoeffs k = sat_coeffs_ramp(k0, dk, (float)n);
+        const float x = in[n];
+        float y = SatCurve<KERNEL>::apply(k, x);
+
+        out[n] = (wet + n*dwet)*y + (dry + n*ddry)*x;
+    }
+}
+
+/**
+   Like sat_block(), with the coefficients ramping from @a c by @a dc per sample,
+   and the gains from @a wet and @a dry by @a dwet and @a ddry per sample.
+ */
+template <int KERNEL>
+static void sat_block_ramp(const float* in, float* out, uint32_t frames, const SatCoeffs& c, const SatCoeffs& dc,
+                           float wet, float dry, float dwet, float ddry)
+{
+    sat_block_ramp_range<KERNEL>(in, out, 0, frames, c, dc, wet, dry, dwet, ddry);
+}
+
+/**
+   sat_block() for each of @a channels channels.
+ */
+template <int KERNEL>
+static void sat_block_multi(const float* const* in, float* const* out, uint32_t channels, uint32_t frames,
+                            const SatCoeffs& c, float wet, float dry)
+{
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        sat_block<KERNEL>(in[ch], out[ch], frames, c, wet, dry);
+    }
+}
+
+/**
+   sat_block_ramp() for each of @a channels channels. The coefficients of a sample are computed once for all channels.
+ */
+template <int KERNEL>
+static void sat_block_ramp_multi(const float* const* in, float* const* out, uint32_t channels, uint32_t frames,
+                                 const SatCoeffs& c, const SatCoeffs& dc, float wet, float dry,
+                                 float dwet, float ddry)
+{
+    const SatCoeffs k0 = c;
+    const SatCoeffs dk = dc;
+
+    for (uint32_t n = 0; n < frames; n++) {
+        const SatCoeffs k = sat_coeffs_ramp(k0, dk, (float)n);
+        const float w = wet + n*dwet;
+        const float d = dry + n*ddry;
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const float x = in[ch][n];
+            const float y = SatCurve<KERNEL>::apply(k, x);
+
+            out[ch][n] = w*y + d*x;
+        }
+    }
+}
+
+/**
+   Coefficients of lane @a l.
+ */
+static inline SatCoeffs sat_lane_coeffs(const SatLaneCoeffs& c, uint32_t l)
+{
+    SatCoeffs k = {
+        c.p0[l], c.p1[l], c.p2[l], c.p3[l], c.p4[l], c.p5[l], c.p6[l], c.p7[l], c.p8[l], c.p9[l], c.bp[l], c.bn[l],
+    };
+    return k;
+}
+
+/**
+   Saturate SAT_LANES interleaved signals, each with its own coefficients and gains.
+ */
+template <int KERNEL>
+static void sat_lanes(const float* in, float* out, uint32_t lanes, uint32_t frames, const SatLaneCoeffs& c)
+{
+    for (uint32_t l = 0; l < lanes; l++) {
+        const SatCoeffs k = sat_lane_coeffs(c, l);
+        const float wet = c.wet[l];
+        const float dry = c.dry[l];
+
+        for (uint32_t n = 0; n < frames; n++) {
+            const float x = in[n*SAT_LANES + l];
+            const float y = SatCurve<KERNEL>::apply(k, x);
+
+            out[n*SAT_LANES + l] = wet*y + dry*x;
+        }
+    }
+}
+
+/**
+   Like sat_lanes(), with every lane ramping like sat_block_ramp().
+ */
+template <int KERNEL>
+static void sat_lanes_ramp(const float* in, float* out, uint32_t lanes, uint32_t frames, const SatLaneCoeffs& c,
+                           const SatLaneCoeffs& dc)
+{
+    for (uint32_t l = 0; l < lanes; l++) {
+        const SatCoeffs k0 = sat_lane_coeffs(c, l);
+        const SatCoeffs dk = sat_lane_coeffs(dc, l);
+
+        for (uint32_t n = 0; n < frames; n++) {
+            const SatCoeffs k = sat_coeffs_ramp(k0, dk, (float)n);
+            const float x = in[n*SAT_LANES + l];
+            const float y = SatCurve<KERNEL>::apply(k, x);
+
+            out[n*SAT_LANES + l] = (c.wet[l] + n*dc.wet[l])*y + (c.dry[l] + n*dc.dry[l])*x;
+        }
+    }
+}
+
+/**
+   Interleave SAT_LANES signals frame by frame, for the lane kernels.
+ */
+static void sat_interleave(const float* const* in, float* x, uint32_t lanes, uint32_t frames)
+{
+    for (uint32_t l = 0; l < lanes; l++) {
+        for (uint32_t n = 0; n < frames; n++) {
+            x[n*SAT_LANES + l] = in[l][n];
+        }
+    }
+}
+
+/**
+   Split SAT_LANES interleaved signals, the reverse of sat_interleave().
+ */
+static void sat_deinterleave(const float* x, float* const* out, uint32_t lanes, uint32_t frames)
+{
+    for (uint32_t l = 0; l < lanes; l++) {
+        for (uint32_t n = 0; n < frames; n++) {
+            out[l][n] = x[n*SAT_LANES + l];
+        }
+    }
+}
+
+/**
+   Filter SAT_LANES interleaved signals in place, each through the first @a stages biquads of its lane in @a f:
+   y = b0*x + s1, s1 = b1*x + s2 - a1*y, s2 = b2*x - a2*y, with the output of a biquad the input of the next.
+   The state is updated with y last, which shortens the recursion.
+ */
+static void sat_biquad_lanes(float* x, uint32_t lanes, uint32_t frames, uint32_t stages, SatBiquadLanes& f)
+{
+    for (uint32_t l = 0; l < lanes; l++) {
+        for (uint32_t k = 0; k < stages; k++) {
+            const float b0 = f.b0[k][l];
+            const float b1 = f.b1[k][l];
+            const float b2 = f.b2[k][l];
+            const float a1 = f.a1[k][l];
+            const float a2 = f.a2[k][l];
+            float s1 = f.s1[k][l];
+            float s2 = f.s2[k][l];
+
+            for (uint32_t n = 0; n < frames; n++) {
+                const float u = x[n*SAT_LANES + l];
+                const float y = b0*u + s1;
+
+                s1 = b1*u + s2 - a1*y;
+                s2 = b2*u - a2*y;
+                x[n*SAT_LANES + l] = y;
+            }
+
+            f.s1[k][l] = s1;
+            f.s2[k][l] = s2;
+        }
+    }
+}
+
+/**
+   Like sat_block(), with the curve interpolated linearly from @a lut.
+ */
+static void sat_block_lut(const float* in, float* out, uint32_t frames, const SatLut& lut,
+                          float wet, float dry)
+{
+    const float scale = SAT_LUT_SIZE/(2.0f*SAT_LUT_RANGE);
+
+    for (uint32_t n = 0; n < frames; n++) {
+        const float x = in[n];
+
+        // Position in the table, clamped to it; NaN goes to the start
+        float u = (x + SAT_LUT_RANGE)*scale;
+        u = (u > 0.0f) ? u : 0.0f;
+        u = (u < SAT_LUT_SIZE) ? u : SAT_LUT_SIZE;
+
+        const int i = (int)u;
+        const float a = lut.y[i];
+        const float b = lut.y[i + 1];
+        const float y = a + (u - (float)i)*(b - a);
+
+        out[n] = wet*y + dry*x;
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// Filter kernel
+
+/**
+   Symmetric FIR filter with 2 * @a taps / 2 taps, of which only the first half is given in @a coeffs:
+   out[i] = sum_m coeffs[m] * (x[i + m] + x[i + taps - 1 - m]) for m < taps / 2.
+   @a x holds @a frames + @a taps - 1 samples. Each sum is accumulated in order of m.
+ */
+static void sat_filter(const float* coeffs, uint32_t taps, const float* x, float* out, uint32_t frames)
+{
+    for (uint32_t i = 0; i < frames; i++) {
+        float sum = 0.0f;
+
+        for (uint32_t m = 0; m < taps/2; m++) {
+            sum += coeffs[m]*(x[i + m] + x[i + taps - 1 - m]);
+        }
+
+        out[i] = sum;
+    }
+}
+
+static const SatKernels sat_kernels_scalar = {
+    {
+        sat_block<SAT_KERNEL_PIECEWISE>,
+        sat_block<SAT_KERNEL_RATIONAL>,
+        sat_block<SAT_KERNEL_TUBE>,
+        sat_block<SAT_KERNEL_MECH>,
+        sat_block<SAT_KERNEL_LOWGAIN>,
+        sat_block<SAT_KERNEL_HIGHGAIN>,
+    },
+    {
+        sat_block_ramp<SAT_KERNEL_PIECEWISE>,
+        sat_block_ramp<SAT_KERNEL_RATIONAL>,
+        sat_block_ramp<SAT_KERNEL_TUBE>,
+        sat_block_ramp<SAT_KERNEL_MECH>,
+        sat_block_ramp<SAT_KERNEL_LOWGAIN>,
+        sat_block_ramp<SAT_KERNEL_HIGHGAIN>,
+    },
+    {
+        sat_block_multi<SAT_KERNEL_PIECEWISE>,
+        sat_block_multi<SAT_KERNEL_RATIONAL>,
+        sat_block_multi<SAT_KERNEL_TUBE>,
+        sat_block_multi<SAT_KERNEL_MECH>,
+        sat_block_multi<SAT_KERNEL_LOWGAIN>,
+        sat_block_multi<SAT_KERNEL_HIGHGAIN>,
+    },
+    {
+        sat_block_ramp_multi<SAT_KERNEL_PIECEWISE>,
+        sat_block_ramp_multi<SAT_KERNEL_RATIONAL>,
+        sat_block_ramp_multi<SAT_KERNEL_TUBE>,
+        sat_block_ramp_multi<SAT_KERNEL_MECH>,
+        sat_block_ramp_multi<SAT_KERNEL_LOWGAIN>,
+        sat_block_ramp_multi<SAT_KERNEL_HIGHGAIN>,
+    },
+    {
+        sat_lanes<SAT_KERNEL_PIECEWISE>,
+        sat_lanes<SAT_KERNEL_RATIONAL>,
+        sat_lanes<SAT_KERNEL_TUBE>,
+        sat_lanes<SAT_KERNEL_MECH>,
+        sat_lanes<SAT_KERNEL_LOWGAIN>,
+        sat_lanes<SAT_KERNEL_HIGHGAIN>,
+    },
+    {
+        sat_lanes_ramp<SAT_KERNEL_PIECEWISE>,
+        sat_lanes_ramp<SAT_KERNEL_RATIONAL>,
+        sat_lanes_ramp<SAT_KERNEL_TUBE>,
+        sat_lanes_ramp<SAT_KERNEL_MECH>,
+        sat_lanes_ramp<SAT_KERNEL_LOWGAIN>,
+        sat_lanes_ramp<SAT_KERNEL_HIGHGAIN>,
+    },
+    sat_interleave,
+    sat_deinterleave,
+    sat_biquad_lanes,
+    sat_block_lut,
+    sat_filter,
+    1,
+};
+
+// -----------------------------------------------------------------------------------------------------------
+// Runtime dispatch
+//
+// Each SIMD kernel table lives in its own translation unit, compiled for one
+// instruction set (see saturation.mk), in one version per SAT_MATH_* mode.
+// A table is NULL when the kernels were not compiled for the target
+// architecture. The scalar kernels always divide exactly.
+
+const SatKernels* sat_kernels_sse2(int math);
+const SatKernels* sat_kernels_avx2(int math);
+const SatKernels* sat_kernels_avx512(int math);
+const SatKernels* sat_kernels_neon(int math);
+
+/**
+   Get the kernel table for the instruction set named @a isa: "scalar", "sse2", "avx2", "avx512" or "neon",
+   dividing as set by @a math. Returns NULL if the kernels were not compiled for it or this CPU does not support it.
+ */
+static inline const SatKernels* sat_kernels_isa(const char* isa, int math = SAT_MATH_EXACT)
+{
+    if (std::strcmp(isa, "scalar") == 0) {
+        return &sat_kernels_scalar;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    if (std::strcmp(isa, "avx512") == 0) {
+        return __builtin_cpu_supports("avx512f") ? sat_kernels_avx512(math) : NULL;
+    }
+    if (std::strcmp(isa, "avx2") == 0) {
+        return __builtin_cpu_supports("avx2") ? sat_kernels_avx2(math) : NULL;
+    }
+    if (std::strcmp(isa, "sse2") == 0) {
+        return __builtin_cpu_supports("sse2") ? sat_kernels_sse2(math) : NULL;
+    }
+#else
+    if (std::strcmp(isa, "neon") == 0) {
+        return sat_kernels_neon(math);
+    }
+#endif
+
+    return NULL;
+}
+
+/**
+   Pick the kernel table for the widest instruction set supported by this CPU.
+   The name of the instruction set is written to @a isa, if given.
+ */
+static inline const SatKernels* sat_kernels_detect(const char** isa = NULL, int math = SAT_MATH_EXACT)
+{
+    static const char* const names[] = { "avx512", "avx2", "sse2", "neon", "scalar" };
+
+    for (size_t i = 0; i < sizeof(names)/sizeof(names[0]); i++) {
+        const SatKernels* funcs = sat_kernels_isa(names[i], math);
+
+        if (funcs != NULL) {
+            if (isa != NULL) {
+                *isa = names[i];
+            }
+            return funcs;
+        }
+    }
+
+    return &sat_kernels_scalar;
+}
+
+#endif // SATURATION_H_INCLUDED
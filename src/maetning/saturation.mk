@@ -0,0 +1,36 @@
+# --------------------------------------------------------------
+# Saturation core, shared by the plugin and the standalone tools
+#
+# Each SIMD kernel table is compiled for its own instruction set and the
+# widest one supported by the CPU is picked at runtime (see saturation.h).
+# Kernels are built with -ffp-contract=off, so no instruction set fuses
+# multiplies and adds that the others evaluate separately.
+
+FILES_CORE = \
+	processor.cpp \
+	batch.cpp \
+	multiband.cpp \
+	lut.cpp \
+	$(FILES_SATURATION)
+
+FILES_SATURATION = \
+	saturation_sse2.cpp \
+	saturation_avx2.cpp \
+	saturation_avx512.cpp \
+	saturation_neon.cpp
+
+SATURATION_MACHINE := $(shell $(CXX) -dumpmachine)
+
+SATURATION_FLAGS = -ffp-contract=off
+
+ifneq (,$(filter x86_64% amd64% i386% i486% i586% i686%,$(SATURATION_MACHINE)))
+SATURATION_FLAGS_saturation_sse2.cpp = -msse2
+SATURATION_FLAGS_saturation_avx2.cpp = -mavx2
+SATURATION_FLAGS_saturation_avx512.cpp = -mavx512f
+endif
+
+# The lookup table builder (lut.cpp) runs a thread
+SATURATION_LINK_FLAGS = -pthread
+
+# Usage: $(call saturation_flags,file.cpp)
+saturation_flags = $(SATURATION_FLAGS) $(SATURATION_FLAGS_$(1))
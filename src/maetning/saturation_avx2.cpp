@@ -0,0 +1,8 @@
+/*
+ * AVX2 saturation kernels, 8 samples per vector.
+ * See saturation_simd.h and saturation.mk.
+ */
+
+#define SATURATION_SIMD_AVX2
+#define SATURATION_SIMD_ENTRY sat_kernels_avx2
+#include "saturation_simd.h"
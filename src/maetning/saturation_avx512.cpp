@@ -0,0 +1,8 @@
+/*
+ * AVX-512 saturation kernels, 16 samples per vector.
+ * See saturation_simd.h and saturation.mk.
+ */
+
+#define SATURATION_SIMD_AVX512
+#define SATURATION_SIMD_ENTRY sat_kernels_avx512
+#include "saturation_simd.h"
@@ -0,0 +1,8 @@
+/*
+ * NEON saturation kernels, 4 samples per vector, AArch64 only.
+ * See saturation_simd.h and saturation.mk.
+ */
+
+#define SATURATION_SIMD_NEON
+#define SATURATION_SIMD_ENTRY sat_kernels_neon
+#include "saturation_simd.h"
@@ -0,0 +1,927 @@
+/*
+ * SIMD saturation kernels
+ *
+ * This header is included by the saturation_<isa>.cpp files, each of which is
+ * compiled for one instruction set and defines SATURATION_SIMD_<ISA> and
+ * SATURATION_SIMD_ENTRY before including it. The curves are the generic ones
+ * from saturation.h, evaluated on a vector type whose comparisons return masks
+ * and whose sat_select() is a blend, so the kernels are branchless. The FIR
+ * kernel for the oversampling filters is vectorized across output samples.
+ *
+ * The multichannel kernels process a whole bus. Lanes hold consecutive frames
+ * of one channel, but what is common to all channels (the ramped coefficients
+ * and gains) is computed once per vector of frames, and the frames left over
+ * after the last whole vector are packed across channels into full vectors.
+ *
+ * The lane kernels load the coefficients of a vector of lanes once, and run
+ * them over all frames of the interleaved signals. The signals are
+ * interleaved and split again with 4x4 transposes, which are as fast with
+ * 128-bit vectors as with wider ones. The lane filter kernel keeps a whole
+ * cascade of biquads in registers, one template instance per cascade length.
+ *
+ * The lookup table kernel gathers two neighbouring table entries per lane, with
+ * a gather instruction where the instruction set has one.
+ *
+ * Only plain multiplies and adds are used, and the kernels are compiled with
+ * -ffp-contract=off, so every instruction set performs the same operations in
+ * the same order as the scalar kernels. Unless -ffast-math reorders them, the
+ * output is bit-identical across instruction sets.
+ */
+
+#ifndef SATURATION_SIMD_H_INCLUDED
+#define SATURATION_SIMD_H_INCLUDED
+
+#include "saturation.h"
+
+#if defined(SATURATION_SIMD_AVX512) || defined(SATURATION_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(SATURATION_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(SATURATION_SIMD_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// -----------------------------------------------------------------------------------------------------------
+// AVX-512: 16 samples per vector
+
+#if defined(SATURATION_SIMD_AVX512) && defined(__AVX512F__)
+#define SATURATION_SIMD_AVAILABLE
+
+struct SatVec
+{
+    static const uint32_t size = 16;
+
+    __m512 v;
+
+    SatVec(__m512 v) : v(v) {}
+    SatVec(float x) : v(_mm512_set1_ps(x)) {}
+
+    static SatVec load(const float* p) { return _mm512_loadu_ps(p); }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+    // Whole part, and table[whole part] per lane, of 0 <= u < 2^31. The masked forms, as the unmasked ones pass
+    // undefined registers through, which GCC warns about.
+    static SatVec trunc(SatVec u)
+    {
+        return _mm512_maskz_cvtepi32_ps(0xFFFF, _mm512_maskz_cvttps_epi32(0xFFFF, u.v));
+    }
+    static SatVec gather(const float* table, SatVec u)
+    {
+        return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, _mm512_maskz_cvttps_epi32(0xFFFF, u.v),
+                                        table, 4);
+    }
+
+    // n, n + 1, ..., n + size - 1
+    static SatVec index(uint32_t n)
+    {
+        return _mm512_add_ps(_mm512_set1_ps((float)n),
+                             _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+};
+
+struct SatMask
+{
+    __mmask16 m;
+};
+
+inline SatVec operator+(SatVec a, SatVec b) { return _mm512_add_ps(a.v, b.v); }
+inline SatVec operator-(SatVec a, SatVec b) { return _mm512_sub_ps(a.v, b.v); }
+inline SatVec operator*(SatVec a, SatVec b) { return _mm512_mul_ps(a.v, b.v); }
+inline SatVec operator/(SatVec a, SatVec b) { return _mm512_div_ps(a.v, b.v); }
+inline SatVec operator-(SatVec a) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x80000000))); }
+
+inline SatMask operator<(SatVec a, SatVec b) { SatMask r = { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; return r; }
+inline SatMask operator<=(SatVec a, SatVec b) { SatMask r = { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ) }; return r; }
+inline SatMask operator>(SatVec a, SatVec b) { SatMask r = { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; return r; }
+inline SatMask operator>=(SatVec a, SatVec b) { SatMask r = { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ) }; return r; }
+
+inline SatVec sat_abs(SatVec x) { return _mm512_abs_ps(x.v); }
+inline SatVec sat_select(SatMask mask, SatVec a, SatVec b) { return _mm512_mask_blend_ps(mask.m, b.v, a.v); }
+
+// 1 / b from a 14-bit estimate and one Newton-Raphson step
+inline SatVec sat_rcp(SatVec b)
+{
+    const SatVec r = _mm512_maskz_rcp14_ps(0xFFFF, b.v);
+    return r*(SatVec(2.0f) - b*r);
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// AVX2: 8 samples per vector
+
+#elif defined(SATURATION_SIMD_AVX2) && defined(__AVX2__)
+#define SATURATION_SIMD_AVAILABLE
+
+struct SatVec
+{
+    static const uint32_t size = 8;
+
+    __m256 v;
+
+    SatVec(__m256 v) : v(v) {}
+    SatVec(float x) : v(_mm256_set1_ps(x)) {}
+
+    static SatVec load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    // Whole part, and table[whole part] per lane, of 0 <= u < 2^31
+    static SatVec trunc(SatVec u) { return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(u.v)); }
+    static SatVec gather(const float* table, SatVec u)
+    {
+        return _mm256_i32gather_ps(table, _mm256_cvttps_epi32(u.v), 4);
+    }
+
+    // n, n + 1, ..., n + size - 1
+    static SatVec index(uint32_t n)
+    {
+        return _mm256_add_ps(_mm256_set1_ps((float)n), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+};
+
+struct SatMask
+{
+    __m256 m;
+};
+
+inline SatVec operator+(SatVec a, SatVec b) { return _mm256_add_ps(a.v, b.v); }
+inline SatVec operator-(SatVec a, SatVec b) { return _mm256_sub_ps(a.v, b.v); }
+inline SatVec operator*(SatVec a, SatVec b) { return _mm256_mul_ps(a.v, b.v); }
+inline SatVec operator/(SatVec a, SatVec b) { return _mm256_div_ps(a.v, b.v); }
+inline SatVec operator-(SatVec a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+inline SatMask operator<(SatVec a, SatVec b) { SatMask r = { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; return r; }
+inline SatMask operator<=(SatVec a, SatVec b) { SatMask r = { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; return r; }
+inline SatMask operator>(SatVec a, SatVec b) { SatMask r = { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; return r; }
+inline SatMask operator>=(SatVec a, SatVec b) { SatMask r = { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; return r; }
+
+inline SatVec sat_abs(SatVec x) { return _mm256_and_ps(x.v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff))); }
+inline SatVec sat_select(SatMask mask, SatVec a, SatVec b) { return _mm256_blendv_ps(b.v, a.v, mask.m); }
+
+// 1 / b from a 12-bit estimate and one Newton-Raphson step
+inline SatVec sat_rcp(SatVec b)
+{
+    const SatVec r = _mm256_rcp_ps(b.v);
+    return r*(SatVec(2.0f) - b*r);
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// SSE2: 4 samples per vector
+
+#elif defined(SATURATION_SIMD_SSE2) && defined(__SSE2__)
+#define SATURATION_SIMD_AVAILABLE
+
+struct SatVec
+{
+    static const uint32_t size = 4;
+
+    __m128 v;
+
+    SatVec(__m128 v) : v(v) {}
+    SatVec(float x) : v(_mm_set1_ps(x)) {}
+
+    static SatVec load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    // Whole part, and table[whole part] per lane, of 0 <= u < 2^31. SSE2 has no gather instruction.
+    static SatVec trunc(SatVec u) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(u.v)); }
+    static SatVec gather(const float* table, SatVec u)
+    {
+        int32_t i[4];
+        _mm_storeu_si128((__m128i*)i, _mm_cvttps_epi32(u.v));
+        return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+    }
+
+    // n, n + 1, ..., n + size - 1
+    static SatVec index(uint32_t n)
+    {
+        return _mm_add_ps(_mm_set1_ps((float)n), _mm_setr_ps(0, 1, 2, 3));
+    }
+};
+
+struct SatMask
+{
+    __m128 m;
+};
+
+inline SatVec operator+(SatVec a, SatVec b) { return _mm_add_ps(a.v, b.v); }
+inline SatVec operator-(SatVec a, SatVec b) { return _mm_sub_ps(a.v, b.v); }
+inline SatVec operator*(SatVec a, SatVec b) { return _mm_mul_ps(a.v, b.v); }
+inline SatVec operator/(SatVec a, SatVec b) { return _mm_div_ps(a.v, b.v); }
+inline SatVec operator-(SatVec a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+inline SatMask operator<(SatVec a, SatVec b) { SatMask r = { _mm_cmplt_ps(a.v, b.v) }; return r; }
+inline SatMask operator<=(SatVec a, SatVec b) { SatMask r = { _mm_cmple_ps(a.v, b.v) }; return r; }
+inline SatMask operator>(SatVec a, SatVec b) { SatMask r = { _mm_cmpgt_ps(a.v, b.v) }; return r; }
+inline SatMask operator>=(SatVec a, SatVec b) { SatMask r = { _mm_cmpge_ps(a.v, b.v) }; return r; }
+
+inline SatVec sat_abs(SatVec x) { return _mm_and_ps(x.v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))); }
+inline SatVec sat_select(SatMask mask, SatVec a, SatVec b) { return _mm_or_ps(_mm_and_ps(mask.m, a.v), _mm_andnot_ps(mask.m, b.v)); }
+
+// 1 / b from a 12-bit estimate and one Newton-Raphson step
+inline SatVec sat_rcp(SatVec b)
+{
+    const SatVec r = _mm_rcp_ps(b.v);
+    return r*(SatVec(2.0f) - b*r);
+}
+
+// -----------------------------------------------------------------------------------------------------------
+// NEON: 4 samples per vector, AArch64 only since ARMv7 has no vector divide
+
+#elif defined(SATURATION_SIMD_NEON) && defined(__ARM_NEON) && defined(__aarch64__)
+#define SATURATION_SIMD_AVAILABLE
+
+struct SatVec
+{
+    static const uint32_t size = 4;
+
+    float32x4_t v;
+
+    SatVec(float32x4_t v) : v(v) {}
+    SatVec(float x) : v(vdupq_n_f32(x)) {}
+
+    static SatVec load(const float* p) { return vld1q_f32(p); }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    // Whole part, and table[whole part] per lane, of 0 <= u < 2^31. NEON has no gather instruction.
+    static SatVec trunc(SatVec u) { return vcvtq_f32_s32(vcvtq_s32_f32(u.v)); }
+    static SatVec gather(const float* table, SatVec u)
+    {
+        int32_t i[4];
+        vst1q_s32(i, vcvtq_s32_f32(u.v));
+        const float lanes[4] = { table[i[0]], table[i[1]], table[i[2]], table[i[3]] };
+        return vld1q_f32(lanes);
+    }
+
+    // n, n + 1, ..., n + size - 1
+    static SatVec index(uint32_t n)
+    {
+        static const float lanes[4] = { 0, 1, 2, 3 };
+        return vaddq_f32(vdupq_n_f32((float)n), vld1q_f32(lanes));
+    }
+};
+
+struct SatMask
+{
+    uint32x4_t m;
+};
+
+inline SatVec operator+(SatVec a, SatVec b) { return vaddq_f32(a.v, b.v); }
+inline SatVec operator-(SatVec a, SatVec b) { return vsubq_f32(a.v, b.v); }
+inline SatVec operator*(SatVec a, SatVec b) { return vmulq_f32(a.v, b.v); }
+inline SatVec operator/(SatVec a, SatVec b) { return vdivq_f32(a.v, b.v); }
+inline SatVec operator-(SatVec a) { return vnegq_f32(a.v); }
+
+inline SatMask operator<(SatVec a, SatVec b) { SatMask r = { vcltq_f32(a.v, b.v) }; return r; }
+inline SatMask operator<=(SatVec a, SatVec b) { SatMask r = { vcleq_f32(a.v, b.v) }; return r; }
+inline SatMask operator>(SatVec a, SatVec b) { SatMask r = { vcgtq_f32(a.v, b.v) }; return r; }
+inline SatMask operator>=(SatVec a, SatVec b) { SatMask r = { vcgeq_f32(a.v, b.v) }; return r; }
+
+inline SatVec sat_abs(SatVec x) { return vabsq_f32(x.v); }
+inline SatVec sat_select(SatMask mask, SatVec a, SatVec b) { return vbslq_f32(mask.m, a.v, b.v); }
+
+// 1 / b from an 8-bit estimate and two Newton-Raphson steps
+inline SatVec sat_rcp(SatVec b)
+{
+    float32x4_t r = vrecpeq_f32(b.v);
+    r = vmulq_f32(r, vrecpsq_f32(b.v, r));
+    r = vmulq_f32(r, vrecpsq_f32(b.v, r));
+    return r;
+}
+
+#endif
+
+// -----------------------------------------------------------------------------------------------------------
+// 4x4 transposes of the lane interleaving
+
+#if defined(SATURATION_SIMD_AVAILABLE) && !defined(SATURATION_SIMD_NEON)
+
+/**
+   Write the transpose of the 4x4 matrix with rows @a a to @a d to the rows @a w to @a z.
+ */
+inline void sat_transpose4(const float* a, const float* b, const float* c, const float* d,
+                           float* w, float* x, float* y, float* z)
+{
+    __m128 r0 = _mm_loadu_ps(a);
+    __m128 r1 = _mm_loadu_ps(b);
+    __m128 r2 = _mm_loadu_ps(c);
+    __m128 r3 = _mm_loadu_ps(d);
+
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    _mm_storeu_ps(w, r0);
+    _mm_storeu_ps(x, r1);
+    _mm_storeu_ps(y, r2);
+    _mm_storeu_ps(z, r3);
+}
+
+#elif defined(SATURATION_SIMD_AVAILABLE)
+
+inline void sat_transpose4(const float* a, const float* b, const float* c, const float* d,
+                           float* w, float* x, float* y, float* z)
+{
+    const float32x4x2_t ab = vtrnq_f32(vld1q_f32(a), vld1q_f32(b));
+    const float32x4x2_t cd = vtrnq_f32(vld1q_f32(c), vld1q_f32(d));
+
+    vst1q_f32(w, vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0])));
+    vst1q_f32(x, vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1])));
+    vst1q_f32(y, vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0])));
+    vst1q_f32(z, vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1])));
+}
+
+#endif
+
+// -----------------------------------------------------------------------------------------------------------
+// Block kernels
+
+#ifdef SATURATION_SIMD_AVAILABLE
+
+/**
+   Division for SAT_MATH_APPROX, see sat_div(). A multiply by a refined reciprocal estimate is cheaper than a
+   vector divide, and within about 3e-7 of the quotient, relative.
+ */
+inline SatVec sat_div_approx(SatVec a, SatVec b)
+{
+    return a*sat_rcp(b);
+}
+
+/**
+   Vector version of sat_block(). The remaining frames are handled by the scalar kernel.
+ */
+template <int KERNEL, int MATH>
+void sat_block_simd(const float* in, float* out, uint32_t frames, const SatCoeffs& c,
+                    float wet, float dry)
+{
+    const SatCoeffs k = c;
+    const SatVec vwet(wet);
+    const SatVec vdry(dry);
+
+    uint32_t n = 0;
+
+    for (; n + SatVec::size <= frames; n += SatVec::size) {
+        const SatVec x = SatVec::load(in + n);
+        const SatVec y = SatCurve<KERNEL, MATH>::apply(k, x);
+
+        (vwet*y + vdry*x).store(out + n);
+    }
+
+    if (n < frames) {
+        sat_block<KERNEL>(in + n, out + n, frames - n, k, wet, dry);
+    }
+}
+
+/**
+   Vector version of sat_block_ramp(). Every lane computes its own coefficients and gains, exactly like the scalar kernel.
+ */
+template <int KERNEL, int MATH>
+void sat_block_ramp_simd(const float* in, float* out, uint32_t frames, const SatCoeffs& c, const SatCoeffs& dc,
+                         float wet, float dry, float dwet, float ddry)
+{
+    const SatCoeffs k0 = c;
+    const SatCoeffs dk = dc;
+    const SatVec vwet(wet);
+    const SatVec vdry(dry);
+    const SatVec vdwet(dwet);
+    const SatVec vddry(ddry);
+
+    uint32_t n = 0;
+
+    for (; n + SatVec::size <= frames; n += SatVec::size) {
+        const SatVec index = SatVec::index(n);
+        const SatCoeffsT<SatVec> k = sat_coeffs_ramp(k0, dk, index);
+        const SatVec x = SatVec::load(in + n);
+        const SatVec y = SatCurve<KERNEL, MATH>::apply(k, x);
+
+        ((vwet + index*vdwet)*y + (vdry + index*vddry)*x).store(out + n);
+    }
+
+    if (n < frames) {
+        sat_block_ramp_range<KERNEL>(in, out, n, frames, k0, dk, wet, dry, dwet, ddry);
+    }
+}
+
+// Vectors of leftover frames packed across channels at a time, see sat_block_multi_simd()
+#define SAT_PACK_VECTORS 4
+
+/**
+   Vector version of sat_block_multi(). Each channel runs whole vectors on its own, then the leftover frames of
+   all channels are packed together, so they fill vectors as well instead of running through the scalar kernel.
+ */
+template <int KERNEL, int MATH>
+void sat_block_multi_simd(const float* const* in, float* const* out, uint32_t channels, uint32_t frames,
+                          const SatCoeffs& c, float wet, float dry)
+{
+    const uint32_t body = frames - frames % SatVec::size;
+    const uint32_t tail = frames - body;
+
+    // Packing only pays off when the leftovers fill a vector
+    if (channels*tail < SatVec::size) {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            sat_block_simd<KERNEL, MATH>(in[ch], out[ch], frames, c, wet, dry);
+        }
+        return;
+    }
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        sat_block_simd<KERNEL, MATH>(in[ch], out[ch], body, c, wet, dry);
+    }
+
+    float pack[SAT_PACK_VECTORS*SatVec::size];
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        std::memcpy(pack + count, in[ch] + body, tail*sizeof(float));
+        count += tail;
+
+        if (ch + 1 == channels || count + tail > SAT_PACK_VECTORS*SatVec::size) {
+            sat_block_simd<KERNEL, MATH>(pack, pack, count, c, wet, dry);
+
+            for (uint32_t i = first; i <= ch; i++) {
+                std::memcpy(out[i] + body, pack + (i - first)*tail, tail*sizeof(float));
+            }
+            first = ch + 1;
+            count = 0;
+        }
+    }
+}
+
+/**
+   Ramp kernel for @a count samples packed from several channels, where sample i is frame index[i] of the ramp.
+ */
+template <int KERNEL, int MATH>
+void sat_block_ramp_packed(float* x, const float* index, uint32_t count, const SatCoeffs& c, const SatCoeffs& dc,
+                           float wet, float dry, float dwet, float ddry)
+{
+    uint32_t i = 0;
+
+    for (; i + SatVec::size <= count; i += SatVec::size) {
+        const SatVec n = SatVec::load(index + i);
+        const SatCoeffsT<SatVec> k = sat_coeffs_ramp(c, dc, n);
+        const SatVec v = SatVec::load(x + i);
+        const SatVec y = SatCurve<KERNEL, MATH>::apply(k, v);
+
+        ((SatVec(wet) + n*SatVec(dwet))*y + (SatVec(dry) + n*SatVec(ddry))*v).store(x + i);
+    }
+
+    for (; i < count; i++) {
+        const float n = index[i];
+        const SatCoeffs k = sat_coeffs_ramp(c, dc, n);
+        const float y = SatCurve<KERNEL>::apply(k, x[i]);
+
+        x[i] = (wet + n*dwet)*y + (dry + n*ddry)*x[i];
+    }
+}
+
+/**
+   Vector version of sat_block_ramp_multi(). The coefficients and gains of a vector of frames are computed once
+   and applied to all channels. Leftover frames are packed across channels like in sat_block_multi_simd().
+ */
+template <int KERNEL, int MATH>
+void sat_block_ramp_multi_simd(const float* const* in, float* const* out, uint32_t channels, uint32_t frames,
+                               const SatCoeffs& c, const SatCoeffs& dc, float wet, float dry,
+                               float dwet, float ddry)
+{
+    const SatCoeffs k0 = c;
+    const SatCoeffs dk = dc;
+    const SatVec vwet(wet);
+    const SatVec vdry(dry);
+    const SatVec vdwet(dwet);
+    const SatVec vddry(ddry);
+
+    const uint32_t body = frames - frames % SatVec::size;
+    const uint32_t tail = frames - body;
+
+    for (uint32_t n = 0; n < body; n += SatVec::size) {
+        const SatVec index = SatVec::index(n);
+        const SatCoeffsT<SatVec> k = sat_coeffs_ramp(k0, dk, index);
+        const SatVec w = vwet + index*vdwet;
+        const SatVec d = vdry + index*vddry;
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const SatVec x = SatVec::load(in[ch] + n);
+            const SatVec y = SatCurve<KERNEL, MATH>::apply(k, x);
+
+            (w*y + d*x).store(out[ch] + n);
+        }
+    }
+
+    if (channels*tail < SatVec::size) {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            sat_block_ramp_range<KERNEL>(in[ch], out[ch], body, frames, k0, dk, wet, dry, dwet, ddry);
+        }
+        return;
+    }
+
+    float pack[SAT_PACK_VECTORS*SatVec::size];
+    float index[SAT_PACK_VECTORS*SatVec::size];
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        std::memcpy(pack + count, in[ch] + body, tail*sizeof(float));
+        for (uint32_t j = 0; j < tail; j++) {
+            index[count + j] = (float)(body + j);
+        }
+        count += tail;
+
+        if (ch + 1 == channels || count + tail > SAT_PACK_VECTORS*SatVec::size) {
+            sat_block_ramp_packed<KERNEL, MATH>(pack, index, count, k0, dk, wet, dry, dwet, ddry);
+
+            for (uint32_t i = first; i <= ch; i++) {
+                std::memcpy(out[i] + body, pack + (i - first)*tail, tail*sizeof(float));
+            }
+            first = ch + 1;
+            count = 0;
+        }
+    }
+}
+
+/**
+   Coefficients of lanes @a l to @a l + SatVec::size - 1.
+ */
+inline SatCoeffsT<SatVec> sat_lane_coeffs_load(const SatLaneCoeffs& c, uint32_t l)
+{
+    SatCoeffsT<SatVec> k = {
+        SatVec::load(c.p0 + l), SatVec::load(c.p1 + l), SatVec::load(c.p2 + l), SatVec::load(c.p3 + l),
+        SatVec::load(c.p4 + l), SatVec::load(c.p5 + l), SatVec::load(c.p6 + l), SatVec::load(c.p7 + l),
+        SatVec::load(c.p8 + l), SatVec::load(c.p9 + l), SatVec::load(c.bp + l), SatVec::load(c.bn + l),
+    };
+    return k;
+}
+
+/**
+   The coefficients c + n*dc of a vector of lanes, see sat_coeffs_ramp().
+ */
+inline SatCoeffsT<SatVec> sat_lane_coeffs_ramp(const SatCoeffsT<SatVec>& c, const SatCoeffsT<SatVec>& dc, SatVec n)
+{
+    SatCoeffsT<SatVec> k = {
+        c.p0 + n*dc.p0, c.p1 + n*dc.p1, c.p2 + n*dc.p2, c.p3 + n*dc.p3, c.p4 + n*dc.p4,
+        c.p5 + n*dc.p5, c.p6 + n*dc.p6, c.p7 + n*dc.p7, c.p8 + n*dc.p8, c.p9 + n*dc.p9,
+        c.bp + n*dc.bp, c.bn + n*dc.bn,
+    };
+    return k;
+}
+
+/**
+   Vector version of sat_lanes().
+ */
+template <int KERNEL, int MATH>
+void sat_lanes_simd(const float* in, float* out, uint32_t lanes, uint32_t frames, const SatLaneCoeffs& c)
+{
+    for (uint32_t l = 0; l < lanes; l += SatVec::size) {
+        const SatCoeffsT<SatVec> k = sat_lane_coeffs_load(c, l);
+        const SatVec wet = SatVec::load(c.wet + l);
+        const SatVec dry = SatVec::load(c.dry + l);
+
+        for (uint32_t n = 0; n < frames; n++) {
+            const SatVec x = SatVec::load(in + n*SAT_LANES + l);
+            const SatVec y = SatCurve<KERNEL, MATH>::apply(k, x);
+
+            (wet*y + dry*x).store(out + n*SAT_LANES + l);
+        }
+    }
+}
+
+/**
+   Vector version of sat_lanes_ramp().
+ */
+template <int KERNEL, int MATH>
+void sat_lanes_ramp_simd(const float* in, float* out, uint32_t lanes, uint32_t frames, const SatLaneCoeffs& c,
+                         const SatLaneCoeffs& dc)
+{
+    for (uint32_t l = 0; l < lanes; l += SatVec::size) {
+        const SatCoeffsT<SatVec> k0 = sat_lane_coeffs_load(c, l);
+        const SatCoeffsT<SatVec> dk = sat_lane_coeffs_load(dc, l);
+        const SatVec wet = SatVec::load(c.wet + l);
+        const SatVec dry = SatVec::load(c.dry + l);
+        const SatVec dwet = SatVec::load(dc.wet + l);
+        const SatVec ddry = SatVec::load(dc.dry + l);
+
+        for (uint32_t n = 0; n < frames; n++) {
+            const SatVec t((float)n);
+            const SatCoeffsT<SatVec> k = sat_lane_coeffs_ramp(k0, dk, t);
+            const SatVec x = SatVec::load(in + n*SAT_LANES + l);
+            const SatVec y = SatCurve<KERNEL, MATH>::apply(k, x);
+
+            ((wet + t*dwet)*y + (dry + t*ddry)*x).store(out + n*SAT_LANES + l);
+        }
+    }
+}
+
+/**
+   Vector version of sat_interleave(), four frames of four lanes at a time.
+ */
+void sat_interleave_simd(const float* const* in, float* x, uint32_t lanes, uint32_t frames)
+{
+    uint32_t n = 0;
+
+    for (; n + 4 <= frames; n += 4) {
+        float* const row = x + n*SAT_LANES;
+
+        for (uint32_t l = 0; l < lanes; l += 4) {
+            sat_transpose4(in[l] + n, in[l + 1] + n, in[l + 2] + n, in[l + 3] + n,
+                           row + l, row + SAT_LANES + l, row + 2*SAT_LANES + l, row + 3*SAT_LANES + l);
+        }
+    }
+
+    for (; n < frames; n++) {
+        for (uint32_t l = 0; l < lanes; l++) {
+            x[n*SAT_LANES + l] = in[l][n];
+        }
+    }
+}
+
+/**
+   Vector version of sat_deinterleave().
+ */
+void sat_deinterleave_simd(const float* x, float* const* out, uint32_t lanes, uint32_t frames)
+{
+    uint32_t n = 0;
+
+    for (; n + 4 <= frames; n += 4) {
+        const float* const row = x + n*SAT_LANES;
+
+        for (uint32_t l = 0; l < lanes; l += 4) {
+            sat_transpose4(row + l, row + SAT_LANES + l, row + 2*SAT_LANES + l, row + 3*SAT_LANES + l,
+                           out[l] + n, out[l + 1] + n, out[l + 2] + n, out[l + 3] + n);
+        }
+    }
+
+    for (; n < frames; n++) {
+        for (uint32_t l = 0; l < lanes; l++) {
+            out[l][n] = x[n*SAT_LANES + l];
+        }
+    }
+}
+
+/**
+   Biquads @a STAGES of a cascade of a vector of lanes, see sat_biquad_lanes(), held in registers while running
+   through the frames.
+ */
+template <uint32_t STAGES>
+struct SatBiquadCascade
+{
+    SatVec b0, b1, b2, a1, a2, s1, s2;
+
+    // The biquads after this one
+    SatBiquadCascade<STAGES - 1> next;
+
+    SatBiquadCascade(const SatBiquadLanes& f, uint32_t k, uint32_t l)
+        : b0(SatVec::load(f.b0[k] + l)),
+          b1(SatVec::load(f.b1[k] + l)),
+          b2(SatVec::load(f.b2[k] + l)),
+          a1(SatVec::load(f.a1[k] + l)),
+          a2(SatVec::load(f.a2[k] + l)),
+          s1(SatVec::load(f.s1[k] + l)),
+          s2(SatVec::load(f.s2[k] + l)),
+          next(f, k + 1, l)
+    {
+    }
+
+    SatVec run(SatVec x)
+    {
+        const SatVec y = b0*x + s1;
+
+        s1 = b1*x + s2 - a1*y;
+        s2 = b2*x - a2*y;
+        return next.run(y);
+    }
+
+    void save(SatBiquadLanes& f, uint32_t k, uint32_t l) const
+    {
+        s1.store(f.s1[k] + l);
+        s2.store(f.s2[k] + l);
+        next.save(f, k + 1, l);
+    }
+};
+
+template <>
+struct SatBiquadCascade<0>
+{
+    SatBiquadCascade(const SatBiquadLanes&, uint32_t, uint32_t) {}
+
+    SatVec run(SatVec x) { return x; }
+    void save(SatBiquadLanes&, uint32_t, uint32_t) const {}
+};
+
+/**
+   Vector version of sat_biquad_lanes() for @a STAGES biquads.
+ */
+template <uint32_t STAGES>
+void sat_biquad_lanes_stages(float* x, uint32_t lanes, uint32_t frames, SatBiquadLanes& f)
+{
+    for (uint32_t l = 0; l < lanes; l += SatVec::size) {
+        SatBiquadCascade<STAGES> cascade(f, 0, l);
+
+        for (uint32_t n = 0; n < frames; n++) {
+            cascade.run(SatVec::load(x + n*SAT_LANES + l)).store(x + n*SAT_LANES + l);
+        }
+
+        cascade.save(f, 0, l);
+    }
+}
+
+/**
+   Vector version of sat_biquad_lanes(). All biquads of a vector of lanes run frame by frame, so their recursions
+   overlap.
+ */
+void sat_biquad_lanes_simd(float* x, uint32_t lanes, uint32_t frames, uint32_t stages, SatBiquadLanes& f)
+{
+    static_assert(SAT_BIQUAD_STAGES == 6, "one case per number of biquads");
+
+    switch (stages) {
+    case 1:
+        sat_biquad_lanes_stages<1>(x, lanes, frames, f);
+        break;
+
+    case 2:
+        sat_biquad_lanes_stages<2>(x, lanes, frames, f);
+        break;
+
+    case 3:
+        sat_biquad_lanes_stages<3>(x, lanes, frames, f);
+        break;
+
+    case 4:
+        sat_biquad_lanes_stages<4>(x, lanes, frames, f);
+        break;
+
+    case 5:
+        sat_biquad_lanes_stages<5>(x, lanes, frames, f);
+        break;
+
+    case 6:
+        sat_biquad_lanes_stages<6>(x, lanes, frames, f);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+   Vector version of sat_block_lut().
+ */
+void sat_block_lut_simd(const float* in, float* out, uint32_t frames, const SatLut& lut,
+                        float wet, float dry)
+{
+    const SatVec offset(SAT_LUT_RANGE);
+    const SatVec scale(SAT_LUT_SIZE/(2.0f*SAT_LUT_RANGE));
+    const SatVec lo(0.0f);
+    const SatVec hi((float)SAT_LUT_SIZE);
+    const SatVec vwet(wet);
+    const SatVec vdry(dry);
+
+    uint32_t n = 0;
+
+    for (; n + SatVec::size <= frames; n += SatVec::size) {
+        const SatVec x = SatVec::load(in + n);
+
+        SatVec u = (x + offset)*scale;
+        u = sat_select(u > lo, u, lo);
+        u = sat_select(u < hi, u, hi);
+
+        const SatVec a = SatVec::gather(lut.y, u);
+        const SatVec b = SatVec::gather(lut.y + 1, u);
+        const SatVec y = a + (u - SatVec::trunc(u))*(b - a);
+
+        (vwet*y + vdry*x).store(out + n);
+    }
+
+    if (n < frames) {
+        sat_block_lut(in + n, out + n, frames - n, lut, wet, dry);
+    }
+}
+
+/**
+   Vector version of sat_filter(). Four vectors of outputs are kept in registers while running through the taps.
+ */
+void sat_filter_simd(const float* coeffs, uint32_t taps, const float* x, float* out, uint32_t frames)
+{
+    const uint32_t size = SatVec::size;
+    uint32_t i = 0;
+
+    for (; i + 4*size <= frames; i += 4*size) {
+        SatVec sum0(0.0f);
+        SatVec sum1(0.0f);
+        SatVec sum2(0.0f);
+        SatVec sum3(0.0f);
+
+        for (uint32_t m = 0; m < taps/2; m++) {
+            const SatVec c(coeffs[m]);
+            const float* const a = x + i + m;
+            const float* const b = x + i + taps - 1 - m;
+
+            sum0 = sum0 + c*(SatVec::load(a) + SatVec::load(b));
+            sum1 = sum1 + c*(SatVec::load(a + size) + SatVec::load(b + size));
+            sum2 = sum2 + c*(SatVec::load(a + 2*size) + SatVec::load(b + 2*size));
+            sum3 = sum3 + c*(SatVec::load(a + 3*size) + SatVec::load(b + 3*size));
+        }
+
+        sum0.store(out + i);
+        sum1.store(out + i + size);
+        sum2.store(out + i + 2*size);
+        sum3.store(out + i + 3*size);
+    }
+
+    for (; i + size <= frames; i += size) {
+        SatVec sum(0.0f);
+
+        for (uint32_t m = 0; m < taps/2; m++) {
+            sum = sum + SatVec(coeffs[m])*(SatVec::load(x + i + m) + SatVec::load(x + i + taps - 1 - m));
+        }
+
+        sum.store(out + i);
+    }
+
+    if (i < frames) {
+        sat_filter(coeffs, taps, x + i, out + i, frames - i);
+    }
+}
+
+/**
+   The kernel table of this instruction set for division mode @a MATH.
+ */
+template <int MATH>
+const SatKernels* sat_kernels_simd()
+{
+    static const SatKernels kernels = {
+        {
+            sat_block_simd<SAT_KERNEL_PIECEWISE, MATH>,
+            sat_block_simd<SAT_KERNEL_RATIONAL, MATH>,
+            sat_block_simd<SAT_KERNEL_TUBE, MATH>,
+            sat_block_simd<SAT_KERNEL_MECH, MATH>,
+            sat_block_simd<SAT_KERNEL_LOWGAIN, MATH>,
+            sat_block_simd<SAT_KERNEL_HIGHGAIN, MATH>,
+        },
+        {
+            sat_block_ramp_simd<SAT_KERNEL_PIECEWISE, MATH>,
+            sat_block_ramp_simd<SAT_KERNEL_RATIONAL, MATH>,
+            sat_block_ramp_simd<SAT_KERNEL_TUBE, MATH>,
+            sat_block_ramp_simd<SAT_KERNEL_MECH, MATH>,
+            sat_block_ramp_simd<SAT_KERNEL_LOWGAIN, MATH>,
+            sat_block_ramp_simd<SAT_KERNEL_HIGHGAIN, MATH>,
+        },
+        {
+            sat_block_multi_simd<SAT_KERNEL_PIECEWISE, MATH>,
+            sat_block_multi_simd<SAT_KERNEL_RATIONAL, MATH>,
+            sat_block_multi_simd<SAT_KERNEL_TUBE, MATH>,
+            sat_block_multi_simd<SAT_KERNEL_MECH, MATH>,
+            sat_block_multi_simd<SAT_KERNEL_LOWGAIN, MATH>,
+            sat_block_multi_simd<SAT_KERNEL_HIGHGAIN, MATH>,
+        },
+        {
+            sat_block_ramp_multi_simd<SAT_KERNEL_PIECEWISE, MATH>,
+            sat_block_ramp_multi_simd<SAT_KERNEL_RATIONAL, MATH>,
+            sat_block_ramp_multi_simd<SAT_KERNEL_TUBE, MATH>,
+            sat_block_ramp_multi_simd<SAT_KERNEL_MECH, MATH>,
+            sat_block_ramp_multi_simd<SAT_KERNEL_LOWGAIN, MATH>,
+            sat_block_ramp_multi_simd<SAT_KERNEL_HIGHGAIN, MATH>,
+        },
+        {
+            sat_lanes_simd<SAT_KERNEL_PIECEWISE, MATH>,
+            sat_lanes_simd<SAT_KERNEL_RATIONAL, MATH>,
+            sat_lanes_simd<SAT_KERNEL_TUBE, MATH>,
+            sat_lanes_simd<SAT_KERNEL_MECH, MATH>,
+            sat_lanes_simd<SAT_KERNEL_LOWGAIN, MATH>,
+            sat_lanes_simd<SAT_KERNEL_HIGHGAIN, MATH>,
+        },
+        {
+            sat_lanes_ramp_simd<SAT_KERNEL_PIECEWISE, MATH>,
+            sat_lanes_ramp_simd<SAT_KERNEL_RATIONAL, MATH>,
+            sat_lanes_ramp_simd<SAT_KERNEL_TUBE, MATH>,
+            sat_lanes_ramp_simd<SAT_KERNEL_MECH, MATH>,
+            sat_lanes_ramp_simd<SAT_KERNEL_LOWGAIN, MATH>,
+            sat_lanes_ramp_simd<SAT_KERNEL_HIGHGAIN, MATH>,
+        },
+        sat_interleave_simd,
+        sat_deinterleave_simd,
+        sat_biquad_lanes_simd,
+        sat_block_lut_simd,
+        sat_filter_simd,
+        SatVec::size,
+    };
+    return &kernels;
+}
+
+#endif
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------------
+
+const SatKernels* SATURATION_SIMD_ENTRY(int math)
+{
+#ifdef SATURATION_SIMD_AVAILABLE
+    if (math == SAT_MATH_APPROX) {
+        return sat_kernels_simd<SAT_MATH_APPROX>();
+    }
+    return sat_kernels_simd<SAT_MATH_EXACT>();
+#else
+    (void)math;
+    return NULL;
+#endif
+}
+
+#endif // SATURATION_SIMD_H_INCLUDED
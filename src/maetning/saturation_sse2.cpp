@@ -0,0 +1,8 @@
+/*
+ * SSE2 saturation kernels, 4 samples per vector.
+ * See saturation_simd.h and saturation.mk.
+ */
+
+#define SATURATION_SIMD_SSE2
+#define SATURATION_SIMD_ENTRY sat_kernels_sse2
+#include "saturation_simd.h"
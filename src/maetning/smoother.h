@@ -0,0 +1,127 @@
+/*
+ * Parameter smoothing
+ *
+ * A new parameter value is not applied at once, but approached along a
+ * linear ramp of a fixed length. Linear ramps end after a known number of
+ * frames, so a block can be split exactly where a ramp ends, and the kernels
+ * can follow a ramp with per-sample increments.
+ *
+ * The target is an atomic, so it can be written from any thread, e.g. by the
+ * host calling setParameterValue() while run() is busy, without locks. All
+ * other members belong to the audio thread.
+ */
+
+#ifndef SMOOTHER_H_INCLUDED
+#define SMOOTHER_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+
+// Default ramp length
+#define SAT_SMOOTHING_TIME_MS 20.0f
+
+class SatSmoother
+{
+public:
+    SatSmoother(float value = 0.0f)
+        : target(value),
+          goal(value),
+          value(value),
+          step(0.0f),
+          remaining(0),
+          length(1)
+    {
+    }
+
+    /**
+       Set a new target. May be called from any thread.
+     */
+    void setTarget(float v)
+    {
+        target.store(v, std::memory_order_relaxed);
+    }
+
+    /**
+       Set the length of a ramp in frames. Takes effect with the next target.
+     */
+    void setLength(uint32_t frames)
+    {
+        length = (frames > 0) ? frames : 1;
+    }
+
+    /**
+       Jump to the target, e.g. when the processor is reset.
+     */
+    void snap()
+    {
+        goal = value = target.load(std::memory_order_relaxed);
+        remaining = 0;
+    }
+
+    /**
+       Pick up a new target, once per block. A new ramp starts from the current value.
+     */
+    void update()
+    {
+        const float t = target.load(std::memory_order_relaxed);
+
+        if (t != goal) {
+            goal = t;
+            remaining = length;
+            step = (goal - value)/remaining;
+        }
+    }
+
+    float getTarget() const
+    {
+        return target.load(std::memory_order_relaxed);
+    }
+
+    float getValue() const
+    {
+        return value;
+    }
+
+    /**
+       Value at the end of the current ramp, the value itself when settled.
+     */
+    float getGoal() const
+    {
+        return goal;
+    }
+
+    /**
+       Frames left in the current ramp, or 0 when settled.
+     */
+    uint32_t getRemaining() const
+    {
+        return remaining;
+    }
+
+    /**
+       Move @a frames frames along the ramp and return the new value. The end of a ramp is exactly the target.
+     */
+    float advance(uint32_t frames)
+    {
+        if (frames >= remaining) {
+            remaining = 0;
+            value = goal;
+        }
+        else {
+            remaining -= frames;
+            value += step*frames;
+        }
+        return value;
+    }
+
+private:
+    std::atomic<float> target;
+
+    float goal;
+    float value;
+    float step;
+    uint32_t remaining;
+    uint32_t length;
+};
+
+#endif // SMOOTHER_H_INCLUDED
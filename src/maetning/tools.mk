@@ -0,0 +1,50 @@
+# --------------------------------------------------------------
+# Build rules of the standalone tools
+#
+# Shared by the Makefiles of maetning-bench, maetning-host,
+# maetning-jitter, maetning-render and maetning-rtcheck, which build
+# without the plugin framework. A tool sets NAME, CORE_DIR and FILES,
+# and optionally TOOL_CXX_FLAGS and TOOL_LINK_FLAGS, and includes this
+# file after saturation.mk. It links the saturation core, compiled with
+# the same optimization as the plugin builds, into ../../bin.
+
+BUILD_DIR = ../../build/$(NAME:maetning-%=%)
+TARGET_DIR = ../../bin
+
+BUILD_CXX_FLAGS = -O3 -ffast-math -fdata-sections -ffunction-sections -Wall -Wextra -MD -MP
+BUILD_CXX_FLAGS += -I$(CORE_DIR) -pthread $(TOOL_CXX_FLAGS)
+BUILD_CXX_FLAGS += $(CXXFLAGS)
+
+LINK_FLAGS = $(SATURATION_LINK_FLAGS) $(TOOL_LINK_FLAGS) $(LDFLAGS)
+
+OBJS = \
+	$(FILES:%=$(BUILD_DIR)/%.o) \
+	$(FILES_CORE:%=$(BUILD_DIR)/core/%.o)
+
+# --------------------------------------------------------------
+
+all: $(TARGET_DIR)/$(NAME)
+
+$(TARGET_DIR)/$(NAME): $(OBJS)
+	-@mkdir -p $(TARGET_DIR)
+	@echo "Creating $(NAME)"
+	@$(CXX) $^ $(LINK_FLAGS) -o $@
+
+$(BUILD_DIR)/%.cpp.o: %.cpp
+	-@mkdir -p $(BUILD_DIR)
+	@echo "Compiling $<"
+	@$(CXX) $< $(BUILD_CXX_FLAGS) -c -o $@
+
+$(BUILD_DIR)/core/%.cpp.o: $(CORE_DIR)/%.cpp
+	-@mkdir -p $(BUILD_DIR)/core
+	@echo "Compiling $<"
+	@$(CXX) $< $(BUILD_CXX_FLAGS) $(call saturation_flags,$*.cpp) -c -o $@
+
+clean:
+	rm -rf $(BUILD_DIR) $(TARGET_DIR)/$(NAME)
+
+-include $(OBJS:%.o=%.d)
+
+.PHONY: all clean
+
+# --------------------------------------------------------------
@@ -0,0 +1,736 @@
+/*
+ * maetning-render
+ *
+ * Offline batch rendering with the saturation core. Each file is streamed in
+ * blocks through its own SatProcessor, the same code path as the plugin's
+ * run(), and several files are rendered in parallel.
+ *
+ * The output is aligned with the input: the latency of oversampling and
+ * second order ADAA is removed from the start, and the filters are flushed at
+ * the end, so an output file has exactly as many frames as its input.
+ *
+ * Usage: maetning-render [options] -o DIR FILE...
+ *   -o DIR              output directory; each output file keeps the name of its input
+ *   --type N            saturation type (default 0)
+ *   --saturation P      saturation in percent (default 0)
+ *   --volume DB         master volume in dB (default 0)
+ *   --mix P             master mix in percent (default 100)
+ *   --oversampling N    oversampling factor 1, 2, 4 or 8 (default 1)
+ *   --antialiasing N    ADAA order 0, 1 or 2 (default 0)
+ *   --eval N            0 exact, 1 lookup tables, 2 approximate division, see SAT_EVAL_* (default 0)
+ *   --raw CHANNELS      files are raw interleaved 32-bit float instead of WAV
+ *   --rate HZ           sample rate of raw files (default 48000)
+ *   --block FRAMES      frames per block (default 4096)
+ *   --jobs N            files rendered in parallel (default: number of cores)
+ *   --isa NAME          auto, scalar, sse2, avx2, avx512 or neon (default auto)
+ *
+ * WAV input may be 16, 24 or 32-bit integer or 32-bit float PCM, with any
+ * number of channels. WAV output is 32-bit float.
+ *
+ * No output may be one of the inputs, compared by device and inode so links
+ * and relative paths are caught too, and no two inputs may have the same
+ * name. Both are rejected before any file is rendered. Each output is written
+ * to a temporary file next to it and renamed once complete, so a failed or
+ * interrupted render never leaves a partial file under the output name.
+ *
+ * The tool is POSIX only, for Linux and macOS: the checks above need
+ * realpath() and the inodes of stat(), which Windows does not have. The
+ * plugin itself does not depend on it.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "processor.h"
+
+// -----------------------------------------------------------------------------------------------------------
+
+struct RenderOptions
+{
+    int type;
+    float saturation;
+    float volume;
+    float mix;
+    int oversampling;
+    int antialiasing;
+    int eval;
+    uint32_t raw_channels;
+    double raw_rate;
+    uint32_t block;
+    uint32_t jobs;
+    std::string isa;
+    std::string output_dir;
+};
+
+static uint32_t read_le(const unsigned char* p, uint32_t bytes)
+{
+    uint32_t v = 0;
+
+    for (uint32_t i = 0; i < bytes; i++) {
+        v |= (uint32_t)p[i] << (8*i);
+    }
+    return v;
+}
+
+static void write_le(unsigned char* p, uint32_t v, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(v >> (8*i));
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+   Reads interleaved float frames from a WAV or raw float file, one block at a time.
+ */
+class AudioReader
+{
+public:
+    AudioReader()
+        : file(NULL),
+          channels(0),
+          rate(0.0),
+          format(0),
+          bytes(0),
+          remaining(0)
+    {
+    }
+
+    ~AudioReader()
+    {
+        if (file != NULL) {
+            std::fclose(file);
+        }
+    }
+
+    /**
+       Open @a path as a WAV file, or as a raw float file if @a raw_channels is not 0.
+     */
+    bool open(const char* path, uint32_t raw_channels, double raw_rate, std::string& error)
+    {
+        file = std::fopen(path, "rb");
+
+        if (file == NULL) {
+            error = "cannot open file";
+            return false;
+        }
+
+        if (raw_channels > 0) {
+            channels = raw_channels;
+            rate = raw_rate;
+            format = 3;
+            bytes = 4;
+            remaining = UINT64_MAX;
+            return true;
+        }
+
+        return openWav(error);
+    }
+
+    /**
+       Read up to @a frames frames into @a out. Returns the number of frames read, which is less at the end of the file.
+     */
+    uint32_t read(float* out, uint32_t frames, std::string& error)
+    {
+        const uint32_t frame_bytes = channels*bytes;
+
+        if ((uint64_t)frames*frame_bytes > remaining) {
+            frames = (uint32_t)(remaining/frame_bytes);
+        }
+
+        raw.resize((size_t)frames*frame_bytes);
+
+        const size_t got = std::fread(raw.data(), frame_bytes, frames, file);
+
+        if (got < frames && std::ferror(file)) {
+            error = "read error";
+        }
+        if (remaining != UINT64_MAX) {
+            remaining -= got*frame_bytes;
+        }
+
+        const size_t samples = got*channels;
+        const unsigned char* p = raw.data();
+
+        for (size_t i = 0; i < samples; i++, p += bytes) {
+            if (format == 3) {
+                const uint32_t v = read_le(p, 4);
+                std::memcpy(&out[i], &v, sizeof(float));
+            }
+            else {
+                // Integer PCM, sign extended from the top byte
+                const int32_t v = (int32_t)(read_le(p, bytes) << (32 - 8*bytes));
+                out[i] = v*(1.0f/2147483648.0f);
+            }
+        }
+
+        return (uint32_t)got;
+    }
+
+    uint32_t getChannels() const { return channels; }
+    double getSampleRate() const { return rate; }
+
+private:
+    bool openWav(std::string& error)
+    {
+        unsigned char header[12];
+
+        if (std::fread(header, 1, 12, file) != 12
+            || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+            error = "not a WAV file";
+            return false;
+        }
+
+        // Walk the chunks up to the data chunk, which must come after the format chunk
+        for (;;) {
+            unsigned char chunk[8];
+
+            if (std::fread(chunk, 1, 8, file) != 8) {
+                error = "no data chunk";
+                return false;
+            }
+
+            const uint32_t size = read_le(chunk + 4, 4);
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                unsigned char fmt[40] = { 0 };
+
+                if (size < 16 || std::fread(fmt, 1, (size < 40) ? size : 40, file) != ((size < 40) ? size : 40)) {
+                    error = "bad format chunk";
+                    return false;
+                }
+
+                format = read_le(fmt, 2);
+                channels = read_le(fmt + 2, 2);
+                rate = read_le(fmt + 4, 4);
+                bytes = read_le(fmt + 14, 2)/8;
+
+                // WAVE_FORMAT_EXTENSIBLE: the format is the start of the subformat GUID
+                if (format == 0xFFFE && size >= 26) {
+                    format = read_le(fmt + 24, 2);
+                }
+
+                if (size > 40) {
+                    std::fseek(file, size - 40, SEEK_CUR);
+                }
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0) {
+                // 0xFFFFFFFF is left by writers that stream, so read to the end
+                remaining = (size == 0xFFFFFFFF) ? UINT64_MAX : size;
+                break;
+            }
+            else {
+                std::fseek(file, size, SEEK_CUR);
+            }
+
+            // Chunks are padded to an even size
+            if (size & 1) {
+                std::fseek(file, 1, SEEK_CUR);
+            }
+        }
+
+        const bool pcm = format == 1 && (bytes == 2 || bytes == 3 || bytes == 4);
+        const bool ieee = format == 3 && bytes == 4;
+
+        if (channels == 0 || rate <= 0.0 || (!pcm && !ieee)) {
+            error = "unsupported WAV format, only 16, 24 and 32-bit integer and 32-bit float are supported";
+            return false;
+        }
+
+        return true;
+    }
+
+    FILE* file;
+    uint32_t channels;
+    double rate;
+    uint32_t format;
+    uint32_t bytes;
+    uint64_t remaining;
+    std::vector<unsigned char> raw;
+};
+
+/**
+   Writes interleaved float frames to a 32-bit float WAV file or a raw float file.
+ */
+class AudioWriter
+{
+public:
+    AudioWriter()
+        : file(NULL),
+          wav(false),
+          channels(0),
+          frames(0)
+    {
+    }
+
+    ~AudioWriter()
+    {
+        if (file != NULL) {
+            std::fclose(file);
+        }
+    }
+
+    bool open(const char* path, bool wav, uint32_t channels, double rate, std::string& error)
+    {
+        this->wav = wav;
+        this->channels = channels;
+
+        file = std::fopen(path, "wb");
+
+        if (file == NULL) {
+            error = "cannot create output file";
+            return false;
+        }
+
+        // The sizes are filled in by close()
+        if (wav) {
+            unsigned char header[HEADER_SIZE];
+
+            writeHeader(header, (uint32_t)(rate + 0.5));
+            if (std::fwrite(header, 1, HEADER_SIZE, file) != HEADER_SIZE) {
+                error = "write error";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool write(const float* in, uint32_t count, std::string& error)
+    {
+        const size_t samples = (size_t)count*channels;
+
+        raw.resize(samples*4);
+
+        for (size_t i = 0; i < samples; i++) {
+            uint32_t v;
+            std::memcpy(&v, &in[i], sizeof(float));
+            write_le(&raw[4*i], v, 4);
+        }
+
+        if (std::fwrite(raw.data(), 4, samples, file) != samples) {
+            error = "write error";
+            return false;
+        }
+
+        frames += count;
+        return true;
+    }
+
+    bool close(std::string& error)
+    {
+        bool ok = true;
+
+        if (wav) {
+            unsigned char size[4];
+            const uint64_t data = frames*channels*4;
+
+            if (data > 0xFFFFFFFFu - HEADER_SIZE) {
+                error = "output too large for WAV";
+                ok = false;
+            }
+
+            // RIFF size, sample frames of the fact chunk and data size
+            write_le(size, (uint32_t)(data + HEADER_SIZE - 8), 4);
+            ok = ok && std::fseek(file, 4, SEEK_SET) == 0 && std::fwrite(size, 1, 4, file) == 4;
+            write_le(size, (uint32_t)frames, 4);
+            ok = ok && std::fseek(file, 46, SEEK_SET) == 0 && std::fwrite(size, 1, 4, file) == 4;
+            write_le(size, (uint32_t)data, 4);
+            ok = ok && std::fseek(file, 54, SEEK_SET) == 0 && std::fwrite(size, 1, 4, file) == 4;
+        }
+
+        if (std::fclose(file) != 0) {
+            ok = false;
+        }
+        file = NULL;
+
+        if (!ok && error.empty()) {
+            error = "write error";
+        }
+        return ok;
+    }
+
+private:
+    // RIFF header, a format chunk with cbSize, a fact chunk and the data chunk header
+    static const uint32_t HEADER_SIZE = 58;
+
+    void writeHeader(unsigned char* h, uint32_t rate) const
+    {
+        std::memset(h, 0, HEADER_SIZE);
+
+        std::memcpy(h, "RIFF", 4);
+        std::memcpy(h + 8, "WAVE", 4);
+
+        std::memcpy(h + 12, "fmt ", 4);
+        write_le(h + 16, 18, 4);
+        write_le(h + 20, 3, 2);                 // WAVE_FORMAT_IEEE_FLOAT
+        write_le(h + 22, channels, 2);
+        write_le(h + 24, rate, 4);
+        write_le(h + 28, rate*channels*4, 4);   // bytes per second
+        write_le(h + 32, channels*4, 2);        // bytes per frame
+        write_le(h + 34, 32, 2);                // bits per sample
+        write_le(h + 36, 0, 2);                 // cbSize
+
+        std::memcpy(h + 38, "fact", 4);
+        write_le(h + 42, 4, 4);
+
+        std::memcpy(h + 50, "data", 4);
+    }
+
+    FILE* file;
+    bool wav;
+    uint32_t channels;
+    uint64_t frames;
+    std::vector<unsigned char> raw;
+};
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+   Render one file into @a out_path. Returns false and sets @a error on failure.
+ */
+static bool render_audio(const RenderOptions& opt, const std::string& in_path, const std::string& out_path,
+                         std::string& error)
+{
+    AudioReader reader;
+
+    if (!reader.open(in_path.c_str(), opt.raw_channels, opt.raw_rate, error)) {
+        return false;
+    }
+
+    const uint32_t channels = reader.getChannels();
+    const uint32_t block = opt.block;
+
+    SatProcessor dsp(channels);
+
+    if (opt.isa != "auto") {
+        dsp.setIsa(opt.isa.c_str());
+    }
+
+    dsp.setSampleRate(reader.getSampleRate());
+    dsp.setType(opt.type);
+    dsp.setSaturation(opt.saturation);
+    dsp.setMasterVolume(opt.volume);
+    dsp.setMasterMix(opt.mix);
+    dsp.setOversampling(opt.oversampling);
+    dsp.setAntialiasing(opt.antialiasing);
+    dsp.setEvaluation(opt.eval);
+    dsp.reset();
+    dsp.waitForLut();
+
+    const uint64_t latency = dsp.getLatency();
+
+    AudioWriter writer;
+
+    if (!writer.open(out_path.c_str(), opt.raw_channels == 0, channels, reader.getSampleRate(), error)) {
+        return false;
+    }
+
+    std::vector<float> interleaved((size_t)block*channels);
+    std::vector<std::vector<float> > planar(channels, std::vector<float>(block));
+    std::vector<float*> buffers(channels);
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        buffers[ch] = planar[ch].data();
+    }
+
+    uint64_t read = 0;
+    uint64_t processed = 0;
+    bool eof = false;
+
+    for (;;) {
+        uint32_t n = 0;
+
+        if (!eof) {
+            n = reader.read(interleaved.data(), block, error);
+            if (!error.empty()) {
+                return false;
+            }
+            eof = n < block;
+            read += n;
+        }
+
+        // After the end of the input, silence flushes the latency out of the filters
+        uint32_t frames = n;
+
+        if (eof) {
+            const uint64_t remaining = read + latency - processed;
+            frames = (remaining < block) ? (uint32_t)remaining : block;
+        }
+
+        if (frames == 0) {
+            break;
+        }
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            float* const p = buffers[ch];
+
+            for (uint32_t i = 0; i < n; i++) {
+                p[i] = interleaved[(size_t)i*channels + ch];
+            }
+            std::fill(p + n, p + frames, 0.0f);
+        }
+
+        dsp.process(buffers.data(), buffers.data(), frames);
+
+        // The first frames are the latency, and are dropped so the output lines up with the input
+        const uint32_t skip = (processed < latency) ? (uint32_t)std::min<uint64_t>(latency - processed, frames) : 0;
+        const uint32_t count = frames - skip;
+
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const float* const p = buffers[ch] + skip;
+
+            for (uint32_t i = 0; i < count; i++) {
+                interleaved[(size_t)i*channels + ch] = p[i];
+            }
+        }
+
+        if (count > 0 && !writer.write(interleaved.data(), count, error)) {
+            return false;
+        }
+
+        processed += frames;
+    }
+
+    return writer.close(error);
+}
+
+static std::string file_name(const std::string& path)
+{
+    const size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? path : path.substr(slash + 1);
+}
+
+static std::string output_path(const std::string& dir, const std::string& in_path)
+{
+    const std::string name = file_name(in_path);
+
+    if (dir.empty() || dir[dir.size() - 1] == '/' || dir[dir.size() - 1] == '\\') {
+        return dir + name;
+    }
+    return dir + "/" + name;
+}
+
+/**
+   Render one file into a temporary file in the directory of @a out_path, and rename it to @a out_path once it is
+   complete. Returns false and sets @a error on failure, and then removes the temporary file.
+ */
+static bool render_file(const RenderOptions& opt, const std::string& in_path, const std::string& out_path,
+                        std::string& error)
+{
+    const size_t slash = out_path.find_last_of("/\\");
+    const std::string dir = (slash == std::string::npos) ? std::string() : out_path.substr(0, slash + 1);
+    const std::string temp_path = dir + "." + file_name(out_path) + "." + std::to_string(getpid()) + ".tmp";
+
+    if (!render_audio(opt, in_path, temp_path, error)) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    if (std::rename(temp_path.c_str(), out_path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        error = "cannot rename the output file";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+   Check that no output is one of @a files and no two outputs in @a dir are the same file. Prints the first
+   collision and returns false.
+ */
+static bool check_outputs(const std::string& dir, const std::vector<std::string>& files,
+                          const std::vector<std::string>& outputs)
+{
+    char resolved[PATH_MAX];
+
+    if (realpath(dir.c_str(), resolved) == NULL) {
+        std::fprintf(stderr, "maetning-render: cannot open output directory %s\n", dir.c_str());
+        return false;
+    }
+
+    // Outputs are all in one directory, so they collide exactly when their names do
+    const std::string canonical_dir(resolved);
+
+    std::map<std::string, size_t> names;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        const std::map<std::string, size_t>::iterator it = names.insert(std::make_pair(file_name(files[i]), i)).first;
+
+        if (it->second != i) {
+            std::fprintf(stderr, "maetning-render: %s and %s would both be written to %s\n",
+                         files[it->second].c_str(), files[i].c_str(), outputs[i].c_str());
+            return false;
+        }
+    }
+
+    // An output that does not exist yet cannot be an input. One that does is compared by device and inode, which
+    // also catches symbolic and hard links.
+    for (size_t i = 0; i < outputs.size(); i++) {
+        struct stat out;
+
+        if (stat((canonical_dir + "/" + file_name(files[i])).c_str(), &out) != 0) {
+            continue;
+        }
+
+        for (size_t j = 0; j < files.size(); j++) {
+            struct stat in;
+
+            if (stat(files[j].c_str(), &in) == 0 && in.st_dev == out.st_dev && in.st_ino == out.st_ino) {
+                std::fprintf(stderr, "maetning-render: %s would overwrite the input %s\n",
+                             outputs[i].c_str(), files[j].c_str());
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "usage: maetning-render [--type N] [--saturation P] [--volume DB] [--mix P]\n"
+                 "                       [--oversampling N] [--antialiasing N] [--eval N] [--raw CHANNELS]\n"
+                 "                       [--rate HZ] [--block FRAMES] [--jobs N] [--isa NAME] -o DIR FILE...\n");
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    RenderOptions opt;
+    opt.type = 0;
+    opt.saturation = 0.0f;
+    opt.volume = 0.0f;
+    opt.mix = 100.0f;
+    opt.oversampling = 1;
+    opt.antialiasing = 0;
+    opt.eval = SAT_EVAL_EXACT;
+    opt.raw_channels = 0;
+    opt.raw_rate = 48000.0;
+    opt.block = 4096;
+    opt.jobs = std::thread::hardware_concurrency();
+    opt.isa = "auto";
+
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (arg[0] != '-') {
+            files.push_back(arg);
+            continue;
+        }
+        if (value == NULL) {
+            usage();
+            return 1;
+        }
+
+        if (std::strcmp(arg, "-o") == 0) opt.output_dir = value;
+        else if (std::strcmp(arg, "--type") == 0) opt.type = std::atoi(value);
+        else if (std::strcmp(arg, "--saturation") == 0) opt.saturation = std::atof(value);
+        else if (std::strcmp(arg, "--volume") == 0) opt.volume = std::atof(value);
+        else if (std::strcmp(arg, "--mix") == 0) opt.mix = std::atof(value);
+        else if (std::strcmp(arg, "--oversampling") == 0) opt.oversampling = std::atoi(value);
+        else if (std::strcmp(arg, "--antialiasing") == 0) opt.antialiasing = std::atoi(value);
+        else if (std::strcmp(arg, "--eval") == 0) opt.eval = std::atoi(value);
+        else if (std::strcmp(arg, "--raw") == 0) opt.raw_channels = std::atoi(value);
+        else if (std::strcmp(arg, "--rate") == 0) opt.raw_rate = std::atof(value);
+        else if (std::strcmp(arg, "--block") == 0) opt.block = std::atoi(value);
+        else if (std::strcmp(arg, "--jobs") == 0) opt.jobs = std::atoi(value);
+        else if (std::strcmp(arg, "--isa") == 0) opt.isa = value;
+        else {
+            usage();
+            return 1;
+        }
+        i++;
+    }
+
+    if (files.empty() || opt.output_dir.empty()) {
+        usage();
+        return 1;
+    }
+
+    if (opt.type < 0 || opt.type >= NUM_SATURATIONS) {
+        std::fprintf(stderr, "maetning-render: type %d out of range\n", opt.type);
+        return 1;
+    }
+    if (opt.oversampling != 1 && opt.oversampling != 2 && opt.oversampling != 4 && opt.oversampling != 8) {
+        std::fprintf(stderr, "maetning-render: oversampling factor %d is not 1, 2, 4 or 8\n", opt.oversampling);
+        return 1;
+    }
+    if (opt.antialiasing < SAT_ADAA_OFF || opt.antialiasing > SAT_ADAA_SECOND_ORDER) {
+        std::fprintf(stderr, "maetning-render: ADAA order %d is not 0, 1 or 2\n", opt.antialiasing);
+        return 1;
+    }
+    if (opt.eval < SAT_EVAL_EXACT || opt.eval > SAT_EVAL_APPROX) {
+        std::fprintf(stderr, "maetning-render: evaluation mode %d is not 0, 1 or 2\n", opt.eval);
+        return 1;
+    }
+    if (opt.block < 1 || opt.raw_rate <= 0.0) {
+        std::fprintf(stderr, "maetning-render: block size and sample rate must be positive\n");
+        return 1;
+    }
+    if (opt.isa != "auto" && sat_kernels_isa(opt.isa.c_str()) == NULL) {
+        std::fprintf(stderr, "maetning-render: instruction set '%s' is not available\n", opt.isa.c_str());
+        return 1;
+    }
+
+    std::vector<std::string> outputs(files.size());
+
+    for (size_t i = 0; i < files.size(); i++) {
+        outputs[i] = output_path(opt.output_dir, files[i]);
+    }
+
+    if (!check_outputs(opt.output_dir, files, outputs)) {
+        return 1;
+    }
+
+    // Workers take the next file until all are done
+    std::atomic<size_t> next(0);
+    std::atomic<int> failed(0);
+    std::mutex print;
+
+    const uint32_t jobs = (opt.jobs < 1) ? 1 : (opt.jobs > files.size()) ? (uint32_t)files.size() : opt.jobs;
+    std::vector<std::thread> workers;
+
+    for (uint32_t j = 0; j < jobs; j++) {
+        workers.push_back(std::thread([&]() {
+            for (size_t i = next++; i < files.size(); i = next++) {
+                std::string error;
+                const bool ok = render_file(opt, files[i], outputs[i], error);
+
+                std::lock_guard<std::mutex> lock(print);
+                if (ok) {
+                    std::fprintf(stderr, "%s -> %s\n", files[i].c_str(), outputs[i].c_str());
+                }
+                else {
+                    std::fprintf(stderr, "maetning-render: %s: %s\n", files[i].c_str(), error.c_str());
+                    failed++;
+                }
+            }
+        }));
+    }
+
+    for (size_t j = 0; j < workers.size(); j++) {
+        workers[j].join();
+    }
+
+    return (failed > 0) ? 1 : 0;
+}
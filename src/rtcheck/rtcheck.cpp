@@ -0,0 +1,534 @@
+/*
+ * maetning-rtcheck
+ *
+ * Checks that the audio path is realtime safe, as DISTRHO_PLUGIN_IS_RT_SAFE
+ * promises. It drives SatProcessor, which is all the plugin's run() and
+ * setParameterValue() call into, through every saturation type, parameter
+ * changes with and without sample-accurate events, oversampling and ADAA
+ * changes, mute, dry and silent stretches, for a range of block sizes, channel
+ * counts and evaluation modes. Meanwhile the allocator, the locks and the
+ * blocking calls of the C library are interposed, and any call to them from
+ * the audio thread while it processes a block or a parameter change is a
+ * failure. Setting up a processor (constructor, setEvaluation(), reset()) is
+ * not realtime safe by design, and is not checked.
+ *
+ * Usage: maetning-rtcheck [options]
+ *   --channels LIST     channel counts (default 1,2,6)
+ *   --blocks LIST       block sizes in frames (default 1,7,16,64,256,1000,4096)
+ *   --eval LIST         evaluation modes, 0 exact, 1 lookup tables, 2 approximate division (default 0-2)
+ *   --isa NAME          auto, scalar, sse2, avx2, avx512 or neon (default auto)
+ *
+ * A LIST is comma separated, and each item is a number N, a range A-B or a
+ * range with a stride A-B:S, e.g. "16-4096:16".
+ * Exits with status 1 if anything was hit.
+ *
+ * Linux with glibc only: the allocator hooks forward to glibc's __libc_malloc()
+ * and friends, the others to the next definition found with dlsym(RTLD_NEXT).
+ * The binary is linked with -rdynamic, so the hooks also replace the calls
+ * from the C++ runtime, e.g. in operator new and std::mutex.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "options.h"
+#include "processor.h"
+
+// -----------------------------------------------------------------------------------------------------------
+// Hooks
+
+enum
+{
+    HOOK_MALLOC,
+    HOOK_CALLOC,
+    HOOK_REALLOC,
+    HOOK_FREE,
+    HOOK_MEMALIGN,
+    HOOK_MUTEX_LOCK,
+    HOOK_MUTEX_TRYLOCK,
+    HOOK_COND_WAIT,
+    HOOK_COND_SIGNAL,
+    HOOK_READ,
+    HOOK_WRITE,
+    HOOK_SLEEP,
+    HOOK_YIELD,
+    NUM_HOOKS
+};
+
+static const char* const hook_names[NUM_HOOKS] = {
+    "malloc", "calloc", "realloc", "free", "memalign", "pthread_mutex_lock", "pthread_mutex_trylock",
+    "pthread_cond_wait", "pthread_cond_signal", "read", "write", "sleep", "sched_yield",
+};
+
+// Set while the audio thread processes, so other threads and the set up are not counted
+static thread_local bool hooks_armed = false;
+
+static std::atomic<uint32_t> hook_hits[NUM_HOOKS];
+
+static inline void hook_hit(int hook)
+{
+    if (hooks_armed) {
+        hook_hits[hook]++;
+    }
+}
+
+/**
+   The next definition of @a name after this binary's, looked up on first use.
+ */
+#define HOOK_NEXT(name) \
+    static decltype(&name) next = NULL; \
+    if (next == NULL) next = (decltype(&name))dlsym(RTLD_NEXT, #name)
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size)
+{
+    hook_hit(HOOK_MALLOC);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    hook_hit(HOOK_CALLOC);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    hook_hit(HOOK_REALLOC);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    hook_hit(HOOK_FREE);
+    __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    hook_hit(HOOK_MEMALIGN);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    hook_hit(HOOK_MEMALIGN);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    hook_hit(HOOK_MEMALIGN);
+
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+
+    *ptr = __libc_memalign(alignment, size);
+    return (*ptr != NULL) ? 0 : ENOMEM;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    HOOK_NEXT(pthread_mutex_lock);
+    hook_hit(HOOK_MUTEX_LOCK);
+    return next(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t* mutex)
+{
+    HOOK_NEXT(pthread_mutex_trylock);
+    hook_hit(HOOK_MUTEX_TRYLOCK);
+    return next(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+    HOOK_NEXT(pthread_cond_wait);
+    hook_hit(HOOK_COND_WAIT);
+    return next(cond, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* time)
+{
+    HOOK_NEXT(pthread_cond_timedwait);
+    hook_hit(HOOK_COND_WAIT);
+    return next(cond, mutex, time);
+}
+
+int pthread_cond_signal(pthread_cond_t* cond)
+{
+    HOOK_NEXT(pthread_cond_signal);
+    hook_hit(HOOK_COND_SIGNAL);
+    return next(cond);
+}
+
+int pthread_cond_broadcast(pthread_cond_t* cond)
+{
+    HOOK_NEXT(pthread_cond_broadcast);
+    hook_hit(HOOK_COND_SIGNAL);
+    return next(cond);
+}
+
+ssize_t read(int fd, void* buf, size_t count)
+{
+    HOOK_NEXT(read);
+    hook_hit(HOOK_READ);
+    return next(fd, buf, count);
+}
+
+ssize_t write(int fd, const void* buf, size_t count)
+{
+    HOOK_NEXT(write);
+    hook_hit(HOOK_WRITE);
+    return next(fd, buf, count);
+}
+
+int nanosleep(const struct timespec* req, struct timespec* rem)
+{
+    HOOK_NEXT(nanosleep);
+    hook_hit(HOOK_SLEEP);
+    return next(req, rem);
+}
+
+int usleep(useconds_t usec)
+{
+    HOOK_NEXT(usleep);
+    hook_hit(HOOK_SLEEP);
+    return next(usec);
+}
+
+int sched_yield()
+{
+    HOOK_NEXT(sched_yield);
+    hook_hit(HOOK_YIELD);
+    return next();
+}
+
+} // extern "C"
+
+// -----------------------------------------------------------------------------------------------------------
+
+struct RtOptions
+{
+    std::vector<int> channels;
+    std::vector<int> blocks;
+    std::vector<int> eval;
+    std::string isa;
+};
+
+static void usage()
+{
+    std::fprintf(stderr, "usage: maetning-rtcheck [--channels LIST] [--blocks LIST] [--eval LIST] [--isa NAME]\n");
+}
+
+// Violations printed per case, after which they are only counted
+#define RT_MAX_REPORTS 5
+
+// Frames after which every smoothing ramp has ended, at 48 kHz
+#define RT_SETTLE_FRAMES 2048
+
+/**
+   Runs one processor on the audio thread, with the hooks armed around every call that the plugin makes while
+   running. The buffers are allocated up front.
+ */
+class RtDriver
+{
+public:
+    RtDriver(int channels, int block, int eval, const std::string& isa)
+        : dsp(channels),
+          channels(channels),
+          block(block),
+          eval(eval),
+          buffers(channels, std::vector<float>(block)),
+          inputs(channels),
+          outputs(channels),
+          phase(0),
+          violations(0)
+    {
+        for (int ch = 0; ch < channels; ch++) {
+            inputs[ch] = buffers[ch].data();
+            outputs[ch] = buffers[ch].data();
+        }
+
+        if (isa != "auto") {
+            dsp.setIsa(isa.c_str());
+        }
+
+        dsp.setEvaluation(eval);
+        dsp.reset();
+    }
+
+    /**
+       Process @a count blocks of a sine, or of silence.
+     */
+    void run(int count, bool silent = false)
+    {
+        for (int i = 0; i < count; i++) {
+            fill(silent);
+
+            arm();
+            dsp.process(inputs.data(), outputs.data(), block);
+            disarm("process()");
+        }
+    }
+
+    /**
+       Process blocks until all ramps have ended.
+     */
+    void settle(bool silent = false)
+    {
+        run(RT_SETTLE_FRAMES/block + 1, silent);
+    }
+
+    /**
+       Change a parameter like the plugin's setParameterValue(), and process a block.
+     */
+    void set(uint32_t index, float value)
+    {
+        arm();
+        dsp.setParameter(index, value);
+        disarm("setParameter()");
+
+        run(1);
+    }
+
+    /**
+       Process a block with a sample-accurate change of every smoothed parameter.
+     */
+    void events()
+    {
+        const SatParameterEvent list[] = {
+            { 0, SAT_PARAM_SATURATION, 80.0f },
+            { (uint32_t)block/4, SAT_PARAM_MASTERVOLUME, -3.0f },
+            { (uint32_t)block/2, SAT_PARAM_MASTERMIX, 40.0f },
+            { (uint32_t)block/2, SAT_PARAM_TYPE, 5.0f },
+            { (uint32_t)block, SAT_PARAM_SATURATION, 20.0f },
+        };
+
+        fill(false);
+
+        arm();
+        dsp.process(inputs.data(), outputs.data(), block, list, sizeof(list)/sizeof(list[0]));
+        disarm("process() with events");
+    }
+
+    uint32_t getViolations() const
+    {
+        return violations;
+    }
+
+private:
+    void fill(bool silent)
+    {
+        for (int n = 0; n < block; n++) {
+            const float x = silent ? 0.0f : 1.5f*std::sin(0.05f*(float)(phase + n));
+
+            for (int ch = 0; ch < channels; ch++) {
+                buffers[ch][n] = (ch & 1) ? -x : x;
+            }
+        }
+
+        // A denormal, so the denormal handling runs too
+        if (!silent) {
+            buffers[0][0] = 1e-40f;
+        }
+
+        phase += block;
+    }
+
+    void arm()
+    {
+        for (int i = 0; i < NUM_HOOKS; i++) {
+            before[i] = hook_hits[i].load();
+        }
+        hooks_armed = true;
+    }
+
+    void disarm(const char* what)
+    {
+        hooks_armed = false;
+
+        for (int i = 0; i < NUM_HOOKS; i++) {
+            const uint32_t hits = hook_hits[i].load() - before[i];
+
+            if (hits == 0) {
+                continue;
+            }
+            if (violations < RT_MAX_REPORTS) {
+                std::printf("FAIL channels %d block %d eval %d: %s called %s %u times\n",
+                            channels, block, eval, what, hook_names[i], hits);
+            }
+            violations++;
+        }
+    }
+
+    SatProcessor dsp;
+    int channels;
+    int block;
+    int eval;
+
+    std::vector<std::vector<float> > buffers;
+    std::vector<const float*> inputs;
+    std::vector<float*> outputs;
+    int phase;
+
+    uint32_t before[NUM_HOOKS];
+    uint32_t violations;
+};
+
+/**
+   Run the plugin through every type and its parameter changes. Returns the number of violations.
+ */
+static uint32_t run_case(int channels, int block, int eval, const std::string& isa)
+{
+    RtDriver d(channels, block, eval, isa);
+
+    for (int type = 0; type < NUM_SATURATIONS; type++) {
+        d.set(SAT_PARAM_TYPE, type);
+
+        // Ramps, then settled curves, which lookup table evaluation runs from tables
+        d.set(SAT_PARAM_SATURATION, 0.0f);
+        d.set(SAT_PARAM_SATURATION, 37.5f);
+        d.settle();
+        d.set(SAT_PARAM_SATURATION, 100.0f);
+        d.settle();
+
+        // New factors reset the filters inside process()
+        for (int factor = 1; factor <= OVERSAMPLING_MAX_FACTOR; factor *= 2) {
+            d.set(SAT_PARAM_OVERSAMPLING, factor);
+
+            for (int order = SAT_ADAA_OFF; order <= SAT_ADAA_SECOND_ORDER; order++) {
+                d.set(SAT_PARAM_ANTIALIASING, order);
+                d.run(2);
+            }
+        }
+        d.set(SAT_PARAM_OVERSAMPLING, 1.0f);
+        d.set(SAT_PARAM_ANTIALIASING, SAT_ADAA_OFF);
+
+        // Mute, dry only and silence take shortcuts
+        d.set(SAT_PARAM_MASTERVOLUME, -60.0f);
+        d.settle();
+        d.set(SAT_PARAM_MASTERVOLUME, -6.0f);
+        d.set(SAT_PARAM_MASTERMIX, 0.0f);
+        d.settle();
+        d.set(SAT_PARAM_MASTERMIX, 100.0f);
+        d.settle(true);
+        d.settle(true);
+        d.run(1);
+
+        d.events();
+        d.settle();
+    }
+
+    // Multiband, with every band count, mixed types, and crossovers moving
+    for (int bands = 2; bands <= SAT_MAX_BANDS; bands++) {
+        d.set(SAT_PARAM_BANDS, bands);
+        d.set(SAT_PARAM_TYPE2, 3.0f);
+        d.set(SAT_PARAM_SATURATION2, 60.0f);
+        d.set(SAT_PARAM_SATURATION3, 80.0f);
+        d.settle();
+        d.set(SAT_PARAM_TYPE2, 0.0f);
+        d.set(SAT_PARAM_CROSSOVER1, 500.0f);
+        d.settle();
+        d.set(SAT_PARAM_MASTERVOLUME, -60.0f);
+        d.settle();
+        d.set(SAT_PARAM_MASTERVOLUME, -6.0f);
+        d.settle();
+    }
+    d.set(SAT_PARAM_BANDS, 1.0f);
+    d.settle();
+
+    return d.getViolations();
+}
+
+int main(int argc, char** argv)
+{
+    RtOptions opt;
+    sat_parse_list("1,2,6", opt.channels);
+    sat_parse_list("1,7,16,64,256,1000,4096", opt.blocks);
+    sat_parse_list("0-2", opt.eval);
+    opt.isa = "auto";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool ok = true;
+
+        if (value == NULL) {
+            usage();
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--channels") == 0) ok = sat_parse_list(value, opt.channels);
+        else if (std::strcmp(arg, "--blocks") == 0) ok = sat_parse_list(value, opt.blocks);
+        else if (std::strcmp(arg, "--eval") == 0) ok = sat_parse_list(value, opt.eval);
+        else if (std::strcmp(arg, "--isa") == 0) opt.isa = value;
+        else ok = false;
+
+        if (!ok) {
+            usage();
+            return 1;
+        }
+        i++;
+    }
+
+    for (size_t i = 0; i < opt.channels.size(); i++) {
+        if (opt.channels[i] < 1) {
+            std::fprintf(stderr, "maetning-rtcheck: channel count %d out of range\n", opt.channels[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.blocks.size(); i++) {
+        if (opt.blocks[i] < 1) {
+            std::fprintf(stderr, "maetning-rtcheck: block size %d out of range\n", opt.blocks[i]);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < opt.eval.size(); i++) {
+        if (opt.eval[i] < SAT_EVAL_EXACT || opt.eval[i] > SAT_EVAL_APPROX) {
+            std::fprintf(stderr, "maetning-rtcheck: evaluation mode %d out of range\n", opt.eval[i]);
+            return 1;
+        }
+    }
+    if (opt.isa != "auto" && sat_kernels_isa(opt.isa.c_str()) == NULL) {
+        std::fprintf(stderr, "maetning-rtcheck: instruction set '%s' is not available\n", opt.isa.c_str());
+        return 1;
+    }
+
+    uint32_t cases = 0;
+    uint32_t failed = 0;
+
+    for (size_t ei = 0; ei < opt.eval.size(); ei++)
+    for (size_t ci = 0; ci < opt.channels.size(); ci++)
+    for (size_t bi = 0; bi < opt.blocks.size(); bi++) {
+        const uint32_t violations = run_case(opt.channels[ci], opt.blocks[bi], opt.eval[ei], opt.isa);
+
+        cases++;
+        if (violations > 0) {
+            failed++;
+        }
+    }
+
+    std::printf("%u cases, %u failed\n", cases, failed);
+    return (failed > 0) ? 1 : 0;
+}